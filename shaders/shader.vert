@@ -9,12 +9,9 @@ layout(binding = 0) uniform UniformBufferObject {
     vec4 sunDirection;
 } ubo;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec2 inTexCoord;
-layout(location = 2) in uint8_t inNormalID;
-layout(location = 3) in uint8_t inTextureID;
-layout(location = 4) in uint8_t inAmbientOcclusionValue;
-layout(location = 5) in uint8_t inLightLevel;
+//Packed ChunkVertex, see ChunkVertex.h for the bit layout
+layout(location = 0) in uint inPositionData;
+layout(location = 1) in uint inTextureData;
 
 layout(location = 0) out vec2 fragTexCoord;
 layout(location = 1) out uint8_t fragNormalID;
@@ -29,11 +26,20 @@ float ambientOcclusionValues[4] = {
     1.0f
     };
 
+const float CHUNK_SIZE = 32.0f;
+const int TEXTURE_COORDINATE_BIAS = 64;
+
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    fragTexCoord = inTexCoord;
-    fragNormalID = inNormalID;
-    fragTextureID = inTextureID;
-    fragAmbientOcclusionValue = ambientOcclusionValues[int(inAmbientOcclusionValue)];
-    fragLightLevel = inLightLevel;
+    //The chunk origin is passed as firstInstance, x and z are signed
+    vec3 chunkOrigin = vec3(bitfieldExtract(gl_InstanceIndex, 0, 13), bitfieldExtract(gl_InstanceIndex, 26, 6), bitfieldExtract(gl_InstanceIndex, 13, 13)) * CHUNK_SIZE;
+
+    //Corners are stored from 0 to 32, the cube centers sit on the integer positions
+    vec3 localPosition = vec3(bitfieldExtract(inPositionData, 0, 6), bitfieldExtract(inPositionData, 6, 6), bitfieldExtract(inPositionData, 12, 6)) - 0.5f;
+
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(chunkOrigin + localPosition, 1.0);
+    fragTexCoord = vec2(int(bitfieldExtract(inTextureData, 8, 7)) - TEXTURE_COORDINATE_BIAS, int(bitfieldExtract(inTextureData, 15, 7)) - TEXTURE_COORDINATE_BIAS);
+    fragNormalID = uint8_t(bitfieldExtract(inPositionData, 18, 3));
+    fragTextureID = uint8_t(bitfieldExtract(inTextureData, 0, 8));
+    fragAmbientOcclusionValue = ambientOcclusionValues[bitfieldExtract(inPositionData, 21, 2)];
+    fragLightLevel = uint8_t(bitfieldExtract(inPositionData, 23, 4));
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef AABBBATCH_H
+#define AABBBATCH_H
+
+#include "glm/glm.hpp"
+
+#include <vector>
+
+//Bounding boxes stored as structure of arrays, so Frustum::cullBatch can test four boxes per plane at once
+struct AABBBatch {
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+
+	void clear() {
+		minX.clear();
+		minY.clear();
+		minZ.clear();
+		maxX.clear();
+		maxY.clear();
+		maxZ.clear();
+	}
+
+	void add(glm::vec3 const &minB, glm::vec3 const &maxB) {
+		minX.push_back(minB.x);
+		minY.push_back(minB.y);
+		minZ.push_back(minB.z);
+		maxX.push_back(maxB.x);
+		maxY.push_back(maxB.y);
+		maxZ.push_back(maxB.z);
+	}
+
+	size_t size() const {
+		return minX.size();
+	}
+};
+
+#endif // !AABBBATCH_H
@@ -5,6 +5,8 @@
 #include "Frustum.h"
 #include "ComputeSettings.h"
 #include "Profiler.h"
+#include "SectionVisibility.h"
+#include "CpuPathTracer.h"
 
 #include "vulkan/vulkan.h"
 #include "glm/gtx/rotate_vector.hpp"
@@ -12,6 +14,9 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <iostream>
+#include <utility>
+#include <limits>
 
 Application::Application()
 	:isRunning(true), window(nullptr) {}
@@ -51,11 +56,20 @@ void Application::mainLoop() {
 	ThreadPool::getInstance().submit([this] {
 		bool changed = true;
 
+		//Nothing uploaded yet, so the first photo mode always loads the scene
+		uint64_t loadedSceneVersion = std::numeric_limits<uint64_t>::max();
+
 		Profiler profiler = Profiler();
 		
 		Frustum frustum = Frustum(10000.0f, 0.1f, camera.cameraUp);
 		frustum.updateFrustum(camera.getCameraPosition(), camera.cameraFront, camera.fov);
 
+		//Reused every frame, so the section culling does not allocate
+		AABBBatch sectionBatch;
+		std::vector<std::pair<LoadedChunkStack *, size_t>> candidateSections;
+		std::vector<uint8_t> sectionVisible;
+		SectionVisibility sectionVisibility;
+
 		while (isRunning) {
 
 			if (!Settings::IN_PHOTO_MODE) {
@@ -67,56 +81,164 @@ void Application::mainLoop() {
 					frustum.updateFrustum(camera.getCameraPosition(), camera.cameraFront, camera.fov);
 				}
 
+				if (Settings::PRINT_MEMORY_STATS) {
+					vulkanWrapper->printMemoryStats();
+					Settings::PRINT_MEMORY_STATS = false;
+				}
+
 				uint32_t imageIndex = 0;
 				bool result = vulkanWrapper->startRenderRecording(camera.getView(), camera.getProjection(), imageIndex);
 
 				if (result) {
+					//The arena meshes are culled by the culling pass on the GPU if it is enabled, only the objs are left for the CPU then
+					bool gpuSectionCulling = vulkanWrapper->isSectionCullingOnGpu();
+					bool occlusionCulling = vulkanWrapper->isOcclusionCullingOn();
+
+					//The recording slices below only read the visible sections
+					std::vector<std::pair<LoadedChunkStack *, size_t>> visibleSections;
+
+					//The walk from the camera section does its own frustum test, it needs the column of the camera to be loaded
+					bool walked = occlusionCulling && sectionVisibility.findVisibleSections(loadedChunks->loadedChunkStacks, camera.getCameraPosition(), frustum, visibleSections);
+					bool frustumOnly = !walked || Settings::PRINT_CULLING_STATS;
+
+					//Every non empty section of the ready stacks is culled on its own, collected once on the render thread
+					sectionBatch.clear();
+					candidateSections.clear();
+
 					for (auto iterator = loadedChunks->loadedChunkStacks.begin(); iterator != loadedChunks->loadedChunkStacks.end(); iterator++) {
 						if (iterator->second->willBeRemoved) {
 							iterator->second->lifeCounter--;
 						}
-						else {
-							if (iterator->second->chunkStackReady && frustum.isInside(iterator->second->aabb)) {
-								for (size_t y = 0; y < iterator->second->chunkStack.stack.size(); y++) {
-									if (iterator->second->chunkIndexCount[y] != 0) {
-										vulkanWrapper->addChunkToRender(imageIndex, iterator->second->chunkVertexBuffer[y], iterator->second->chunkIndexBuffer[y], iterator->second->chunkIndexCount[y]);
-									}
+						else if (iterator->second->chunkStackReady && frustumOnly) {
+							for (size_t y = 0; y < iterator->second->chunkStack.stack.size(); y++) {
+								//With occlusion culling on the GPU pass only draws the sections marked visible, so they are needed here as well
+								bool hasChunkMesh = iterator->second->chunkIndexCount[y] != 0 && (!gpuSectionCulling || occlusionCulling);
+
+								if (hasChunkMesh || iterator->second->objIndexCount[y] != 0) {
+									glm::vec3 minB;
+									glm::vec3 maxB;
+									iterator->second->getSectionBounds((int)y, minB, maxB);
+
+									sectionBatch.add(minB, maxB);
+									candidateSections.push_back({ iterator->second, y });
 								}
 							}
 						}
 					}
 
-					vulkanWrapper->changeToObjPipeline(imageIndex);
+					loadedChunks->countDownReplacedChunkStacks();
 
-					for (auto iterator = loadedChunks->loadedChunkStacks.begin(); iterator != loadedChunks->loadedChunkStacks.end(); iterator++) {
-						if (!iterator->second->willBeRemoved) {
-							if (iterator->second->chunkStackReady && frustum.isInside(iterator->second->aabb)) {
-								for (size_t y = 0; y < iterator->second->chunkStack.stack.size(); y++) {
-									if (iterator->second->objIndexCount[y] != 0) {
-										vulkanWrapper->addObjChunkToRender(imageIndex, iterator->second->objVertexBuffer[y], iterator->second->objIndexBuffer[y], iterator->second->objIndexCount[y]);
-									}
-								}
+					size_t frustumSectionCount = frustum.cullBatch(sectionBatch, sectionVisible);
+
+					if (!walked) {
+						visibleSections.reserve(frustumSectionCount);
+
+						for (size_t i = 0; i < candidateSections.size(); i++) {
+							if (sectionVisible[i]) {
+								visibleSections.push_back(candidateSections[i]);
 							}
 						}
 					}
 
-					vulkanWrapper->changeToSkyPipeline(imageIndex);
+					if (Settings::DRAW_CHUNKS_INDIRECT) {
+						for (size_t i = 0; i < visibleSections.size(); i++) {
+							LoadedChunkStack *chunkStack = visibleSections[i].first;
+							size_t y = visibleSections[i].second;
+
+							if (chunkStack->chunkIndexCount[y] == 0) {
+								continue;
+							}
+
+							if (!gpuSectionCulling) {
+								vulkanWrapper->addChunkToIndirectDraw(chunkStack->chunkArenaAllocation[y], chunkStack->getChunkOrigin(y));
+							} else if (occlusionCulling) {
+								vulkanWrapper->markSectionVisible(imageIndex, chunkStack->chunkArenaAllocation[y]);
+							}
+						}
+					}
+
+					if (Settings::PRINT_CULLING_STATS) {
+						if (walked) {
+							std::cout << "Sections in frustum: " << frustumSectionCount << " drawn after occlusion culling: " << visibleSections.size() << " of " << candidateSections.size() << std::endl;
+						} else {
+							std::cout << "Sections drawn: " << frustumSectionCount << " culled: " << candidateSections.size() - frustumSectionCount << " of " << candidateSections.size() << std::endl;
+						}
+					}
+
+					int sliceCount = static_cast<int>(vulkanWrapper->getRecordingSlotCount()) - 1;
+
+					//Every slice records its chunks into its own secondary command buffer, the last slot gets the indirect draws and the sky
+					ThreadPool::getInstance().parallelFor(sliceCount + 1, [&](int slot) {
+						VkCommandBuffer commandBuffer = vulkanWrapper->startSecondaryRecording(imageIndex, slot);
+
+						if (slot == sliceCount) {
+							vulkanWrapper->drawIndirectChunks(commandBuffer, imageIndex);
+
+							vulkanWrapper->changeToSkyPipeline(commandBuffer, imageIndex);
+
+							//Render sky
+							vulkanWrapper->addSkyToRender(commandBuffer);
+						} else {
+							size_t begin = visibleSections.size() * slot / sliceCount;
+							size_t end = visibleSections.size() * (slot + 1) / sliceCount;
+
+							if (!Settings::DRAW_CHUNKS_INDIRECT) {
+								for (size_t i = begin; i < end; i++) {
+									LoadedChunkStack *chunkStack = visibleSections[i].first;
+									size_t y = visibleSections[i].second;
+
+									if (chunkStack->chunkIndexCount[y] != 0) {
+										vulkanWrapper->addChunkToRender(commandBuffer, chunkStack->chunkVertexBuffer[y], chunkStack->chunkIndexBuffer[y], chunkStack->chunkIndexCount[y], chunkStack->getChunkOrigin(y));
+									}
+								}
+							}
+
+							vulkanWrapper->changeToObjPipeline(commandBuffer, imageIndex);
+
+							for (size_t i = begin; i < end; i++) {
+								LoadedChunkStack *chunkStack = visibleSections[i].first;
+								size_t y = visibleSections[i].second;
 
-					//Render sky
-					vulkanWrapper->addSkyToRender(imageIndex);
+								if (chunkStack->objIndexCount[y] != 0) {
+									vulkanWrapper->addObjChunkToRender(commandBuffer, chunkStack->objVertexBuffer[y], chunkStack->objIndexBuffer[y], chunkStack->objIndexCount[y]);
+								}
+							}
+						}
 
+						vulkanWrapper->endSecondaryRecording(commandBuffer);
+						});
 
 					vulkanWrapper->SubmitRender(imageIndex);
 				}
 			}
 			else {
+				std::vector<PointLight> pointLights = {};
+				pointLights.push_back({ glm::vec4(50.f, 100.f, 50.f, 0.0f), glm::vec4(300.f)});
+
 				if (changed) {
-					std::vector<BoxData> boxData = {};
 					std::vector<BoxData> emissiveBoxData = {};
-					std::vector<PointLight> pointLights = {};
-					pointLights.push_back({ glm::vec4(50.f, 100.f, 50.f, 0.0f), glm::vec4(300.f)});
-					loadedChunks->generateBoxData(boxData, emissiveBoxData);
-					vulkanWrapper->loadComputeBoxes(boxData, emissiveBoxData, pointLights);
+					VoxelGrid voxelGrid;
+					bool boxPoolGrown = false;
+
+					//Re-entering the photo mode without a column loaded or removed in between keeps the buffers of the last time
+					uint64_t sceneVersion = loadedChunks->getSceneVersion();
+					bool sceneChanged = sceneVersion != loadedSceneVersion;
+
+					BoxPool &boxPool = loadedChunks->getBoxPool();
+
+					if (sceneChanged) {
+						if (ComputeSettings::VOXEL_TRACING) {
+							loadedChunks->generateVoxelGrid(voxelGrid, emissiveBoxData);
+						}
+
+						//Empty with voxel tracing, the box buffer then only has to be bindable
+						//Otherwise only the columns meshed since the last time are placed and uploaded
+						boxPoolGrown = boxPool.update(emissiveBoxData);
+
+						loadedSceneVersion = sceneVersion;
+					}
+
+					vulkanWrapper->loadComputeBoxes(boxPool, boxPoolGrown, emissiveBoxData, pointLights, voxelGrid, sceneChanged);
 					changed = false;
 				}
 
@@ -135,13 +257,40 @@ void Application::mainLoop() {
 
 				profiler.profilerSetUpData();
 
-				vulkanWrapper->renderPhotomode(cameraPosition, cameraDirection, cameraUp, iData);
+				//The benchmarks measure whole samples per frame
+				bool progressive = ComputeSettings::PHOTO_MODE_PROGRESSIVE && profiler.oldBenchmarkStatus == BenchmarkStatus::OFF;
+
+				vulkanWrapper->renderPhotomode(cameraPosition, cameraDirection, cameraUp, iData, progressive);
+
+				//No raster frame is in flight here, but the stacks replaced while the remeshing finishes still have to run out
+				loadedChunks->countDownReplacedChunkStacks();
 
 				profiler.profilerCollectData();
 
 				if (profiler.oldBenchmarkStatus != BenchmarkStatus::OFF) {
 					profiler.benchmarkCollectData();
 				}
+
+				if (ComputeSettings::renderCpuReference) {
+					ComputeSettings::renderCpuReference = false;
+
+					//Always traced over the boxes, the voxel grid only exists on the GPU
+					std::vector<BoxData> boxData = {};
+					std::vector<BoxData> emissiveBoxData = {};
+					loadedChunks->generateBoxData(boxData, emissiveBoxData);
+
+					CpuPathTracer cpuPathTracer(boxData, emissiveBoxData, pointLights);
+
+					std::vector<glm::vec3> image;
+					std::vector<float> variance;
+					cpuPathTracer.render(cameraPosition, cameraDirection, cameraUp, iData, ComputeSettings::COMPUTE_WIDTH, ComputeSettings::COMPUTE_HEIGHT, ComputeSettings::CPU_REFERENCE_SAMPLES, image, variance);
+
+					CpuPathTracer::writeImage(ComputeSettings::CPU_REFERENCE_IMAGE_PATH, image, ComputeSettings::COMPUTE_WIDTH, ComputeSettings::COMPUTE_HEIGHT);
+
+					if (ComputeSettings::denoise) {
+						cpuPathTracer.validateDenoiser(cameraPosition, cameraDirection, cameraUp, iData, image);
+					}
+				}
 			}
 		}
 		});
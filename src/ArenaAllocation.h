@@ -0,0 +1,19 @@
+#ifndef ARENAALLOCATION_H
+#define ARENAALLOCATION_H
+
+#include <cstdint>
+
+//Where the mesh of one chunk lives inside the ChunkArena, in vertices and indices instead of bytes
+struct ArenaAllocation {
+	uint32_t page = 0;
+	int32_t vertexOffset = 0;
+	uint32_t vertexCount = 0;
+	uint32_t firstIndex = 0;
+	uint32_t indexCount = 0;
+
+	//Draw slots of the section inside its page, only used with GPU section culling
+	uint32_t firstSection = 0;
+	uint32_t sectionCount = 0;
+};
+
+#endif // !ARENAALLOCATION_H
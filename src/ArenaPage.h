@@ -0,0 +1,23 @@
+#ifndef ARENAPAGE_H
+#define ARENAPAGE_H
+
+#include "MemoryAllocation.h"
+#include "RangeAllocator.h"
+
+#include "vulkan/vulkan.h"
+
+struct ArenaPage {
+	VkBuffer vertexBuffer = VK_NULL_HANDLE;
+	MemoryAllocation vertexBufferAllocation;
+	RangeAllocator vertexRanges;
+
+	VkBuffer indexBuffer = VK_NULL_HANDLE;
+	MemoryAllocation indexBufferAllocation;
+	RangeAllocator indexRanges;
+
+	//Draw slots of the culling pass, sectionEnd is one past the highest slot ever used
+	RangeAllocator sectionRanges;
+	uint32_t sectionEnd = 0;
+};
+
+#endif // !ARENAPAGE_H
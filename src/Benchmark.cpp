@@ -0,0 +1,313 @@
+#include "Benchmark.h"
+#include "RandomSampler.h"
+#include "Settings.h"
+#include "MapGenerator.h"
+#include "ChunkStack.h"
+#include "Noise.h"
+#include "ThreadPool.h"
+#include "LoadedChunkStack.h"
+#include "SectionVisibility.h"
+#include "Frustum.h"
+#include "AABBBatch.h"
+#include "Camera.h"
+#include "ComputeSettings.h"
+#include "CpuPathTracer.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <cmath>
+
+Benchmark::Benchmark() {}
+
+Benchmark::~Benchmark() {}
+
+bool Benchmark::run(std::string const &name) {
+	if (name == "random") {
+		randomSampler();
+	} else if (name == "terrain") {
+		terrain();
+	} else if (name == "clouds") {
+		clouds();
+	} else if (name == "occlusion") {
+		occlusion();
+	} else {
+		std::cerr << "Unknown benchmark: " << name << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Benchmark::randomSampler() {
+	int32_t const size = 1024;
+
+	RandomSamplerMode oldMode = Settings::RANDOM_SAMPLER_MODE;
+	RandomSamplerMode modes[2] = { RandomSamplerMode::MERSENNE_TWISTER, RandomSamplerMode::COUNTER_BASED };
+	char const *modeNames[2] = { "MersenneTwister", "CounterBased" };
+
+	for (size_t i = 0; i < 2; i++) {
+		Settings::RANDOM_SAMPLER_MODE = modes[i];
+
+		RandomSampler randomSampler = RandomSampler();
+		float sum = 0.0f;
+
+		//Same access pattern as the generator, one seeded sample per column and a short stream for trees
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int32_t z = 0; z < size; z++) {
+			for (int32_t x = 0; x < size; x++) {
+				sum += randomSampler.getSample1D(x, z);
+			}
+		}
+		std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+		double elapsed1D = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int32_t z = 0; z < size; z++) {
+			for (int32_t x = 0; x < size; x++) {
+				float r1, r2;
+				randomSampler.getSample2D(x, z, r1, r2);
+				sum += r1 + r2;
+			}
+		}
+		stop = std::chrono::steady_clock::now();
+		double elapsed2D = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int32_t z = 0; z < size; z++) {
+			for (int32_t x = 0; x < size; x++) {
+				randomSampler.resetSampler(x, z);
+				for (size_t j = 0; j < 8; j++) {
+					sum += randomSampler.getSample1DNonReset();
+				}
+			}
+		}
+		stop = std::chrono::steady_clock::now();
+		double elapsedStream = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+		double queries = (double)size * size;
+
+		std::cout << std::fixed << std::setprecision(2) << modeNames[i] << "\t" << queries / 1000 / 1000 / (elapsed1D / 1000) << "M getSample1D/sec" << "\t" << queries / 1000 / 1000 / (elapsed2D / 1000) << "M getSample2D/sec" << "\t" << queries / 1000 / 1000 / (elapsedStream / 1000) << "M reset+8 samples/sec" << "\t" << "checksum " << sum << std::endl;
+	}
+
+	Settings::RANDOM_SAMPLER_MODE = oldMode;
+}
+
+void Benchmark::terrain() {
+	int const size = 8;
+
+	TerrainMode oldMode = Settings::TERRAIN_MODE;
+	TerrainMode modes[2] = { TerrainMode::HEIGHT_MAP, TerrainMode::DENSITY_FIELD };
+	char const *modeNames[2] = { "HeightMap", "DensityField" };
+
+	for (size_t i = 0; i < 2; i++) {
+		Settings::TERRAIN_MODE = modes[i];
+
+		MapGenerator mapGenerator;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int j = 0; j < size * size; j++) {
+			ChunkStack chunkStack;
+			mapGenerator.generateChunkHeight(j % size, j / size, chunkStack);
+		}
+		std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+		double elapsedSerial = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+		//One chunk stack per task, the same way the LoadedChunks hand them to the ThreadPool
+		start = std::chrono::steady_clock::now();
+		ThreadPool::getInstance().parallelFor(size * size, [&mapGenerator, size](int k) {
+			ChunkStack chunkStack;
+			mapGenerator.generateChunkHeight(k % size, k / size, chunkStack);
+		});
+		stop = std::chrono::steady_clock::now();
+		double elapsedParallel = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+		std::cout << std::fixed << std::setprecision(2) << modeNames[i] << "\t" << size * size / (elapsedSerial / 1000) << " chunk stacks/sec serial" << "\t" << size * size / (elapsedParallel / 1000) << " chunk stacks/sec on the ThreadPool" << std::endl;
+	}
+
+	Settings::TERRAIN_MODE = oldMode;
+}
+
+void Benchmark::clouds() {
+	int const size = Settings::cloudTextureSize;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Noise noise;
+	std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+	double elapsedSetUp = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+	std::vector<float> values(size * size * size);
+
+	//Same level 0 fill as CloudTexture::setUpNoise, one z slice per task
+	start = std::chrono::steady_clock::now();
+	ThreadPool::getInstance().parallelFor(size, [&noise, &values, size](int z) {
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				values[x + (y * size) + (z * size * size)] = noise.worley3D(glm::vec3(x, y, z) / glm::vec3(size), 0);
+			}
+		}
+	});
+	stop = std::chrono::steady_clock::now();
+	double elapsedFill = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+	float sum = 0.0f;
+	for (size_t i = 0; i < values.size(); i++) {
+		sum += values[i];
+	}
+
+	std::cout << std::fixed << std::setprecision(2) << "Worley3D" << "\t" << elapsedSetUp << "ms set up" << "\t" << elapsedFill << "ms for " << size << "^3 texels" << "\t" << (double)values.size() / 1000 / 1000 / (elapsedFill / 1000) << "M texels/sec" << "\t" << "checksum " << sum << std::endl;
+}
+
+void Benchmark::occlusion() {
+	//Half the loaded radius, the whole loaded area would keep more than a gigabyte of cubes around
+	int const radius = Settings::LOADED_CHUNKS / 4;
+	int const width = 2 * radius + 1;
+	int const directionCount = 8;
+
+	MapGenerator mapGenerator;
+
+	std::map<Coordinates, LoadedChunkStack *> loadedChunkStacks;
+	std::vector<LoadedChunkStack *> stacks;
+
+	for (int z = -radius; z <= radius; z++) {
+		for (int x = -radius; x <= radius; x++) {
+			LoadedChunkStack *loadedChunkStack = new LoadedChunkStack(nullptr);
+			loadedChunkStack->chunkStack.coordinates = { x, z };
+
+			loadedChunkStacks.emplace(loadedChunkStack->chunkStack.coordinates, loadedChunkStack);
+			stacks.push_back(loadedChunkStack);
+		}
+	}
+
+	//Connectivity is calculated the same way as during the meshing, only no meshes are created
+	ThreadPool::getInstance().parallelFor(width * width, [&mapGenerator, &stacks](int i) {
+		Coordinates coordinates = stacks[i]->chunkStack.coordinates;
+
+		mapGenerator.generateChunkHeight(coordinates.x, coordinates.z, stacks[i]->chunkStack);
+		stacks[i]->chunkStack.coordinates = coordinates;
+		stacks[i]->generateVisibilityData();
+	});
+
+	//Same candidates as the frustum only path of the Application
+	AABBBatch sectionBatch;
+	for (size_t i = 0; i < stacks.size(); i++) {
+		for (size_t y = 0; y < stacks[i]->chunkStack.stack.size(); y++) {
+			if (stacks[i]->chunkIndexCount[y] != 0) {
+				glm::vec3 minB;
+				glm::vec3 maxB;
+				stacks[i]->getSectionBounds((int)y, minB, maxB);
+
+				sectionBatch.add(minB, maxB);
+			}
+		}
+	}
+
+	//Highest cube of the middle column, the camera stands just above it and once deep below
+	ChunkStack const &middleStack = loadedChunkStacks[{ 0, 0 }]->chunkStack;
+	int const middle = Settings::CHUNK_SIZE / 2;
+	int surface = 0;
+
+	for (int y = (int)middleStack.stack.size() * Settings::CHUNK_SIZE - 1; y >= 0; y--) {
+		if (middleStack.stack[y / Settings::CHUNK_SIZE].cubes[middle][middle][y % Settings::CHUNK_SIZE].cubeType != CubeType::AIR) {
+			surface = y;
+			break;
+		}
+	}
+
+	float heights[2] = { surface + 2.0f, std::min(surface / 2.0f, 24.0f) };
+	char const *heightNames[2] = { "Surface", "Underground" };
+
+	SectionVisibility sectionVisibility;
+	Frustum frustum = Frustum(10000.0f, 0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+	std::vector<uint8_t> sectionVisible;
+	std::vector<std::pair<LoadedChunkStack *, size_t>> visibleSections;
+
+	for (size_t i = 0; i < 2; i++) {
+		glm::vec3 cameraPosition = glm::vec3(middle, heights[i], middle);
+
+		size_t frustumSectionCount = 0;
+		size_t visibleSectionCount = 0;
+		double elapsedFrustum = 0.0;
+		double elapsedWalk = 0.0;
+
+		//Looking around horizontally, the counts are summed over all directions
+		for (int j = 0; j < directionCount; j++) {
+			float angle = j * 2.0f * (float)M_PI / directionCount;
+			frustum.updateFrustum(cameraPosition, glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), 45.0f);
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			frustumSectionCount += frustum.cullBatch(sectionBatch, sectionVisible);
+			std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+			elapsedFrustum += std::chrono::duration<double, std::chrono::microseconds::period>(stop - start).count();
+
+			start = std::chrono::steady_clock::now();
+			sectionVisibility.findVisibleSections(loadedChunkStacks, cameraPosition, frustum, visibleSections);
+			stop = std::chrono::steady_clock::now();
+			elapsedWalk += std::chrono::duration<double, std::chrono::microseconds::period>(stop - start).count();
+
+			visibleSectionCount += visibleSections.size();
+		}
+
+		std::cout << std::fixed << std::setprecision(2) << heightNames[i] << " (y " << heights[i] << ")" << "\t" << (double)frustumSectionCount / directionCount << " sections drawn after frustum culling" << "\t" << (double)visibleSectionCount / directionCount << " after occlusion culling" << "\t" << 100.0 * (1.0 - (double)visibleSectionCount / std::max(frustumSectionCount, (size_t)1)) << "% fewer draws" << "\t" << elapsedFrustum / directionCount << "us frustum" << "\t" << elapsedWalk / directionCount << "us walk" << "\t" << "of " << sectionBatch.size() << " non empty sections" << std::endl;
+	}
+
+	for (size_t i = 0; i < stacks.size(); i++) {
+		delete stacks[i];
+	}
+}
+
+void Benchmark::reference() {
+	int const radius = Settings::LOADED_CHUNKS / 2;
+	int const width = 2 * radius + 1;
+
+	MapGenerator mapGenerator;
+
+	std::vector<std::vector<BoxData>> columnBoxData(width * width);
+	std::vector<std::vector<BoxData>> columnEmissiveBoxData(width * width);
+
+	//The cubes of a column are dropped once its boxes are collected, only the boxes of the whole area are kept
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ThreadPool::getInstance().parallelFor(width * width, [&](int i) {
+		Coordinates coordinates = { i % width - radius, i / width - radius };
+
+		LoadedChunkStack *loadedChunkStack = new LoadedChunkStack(nullptr);
+		mapGenerator.generateChunkHeight(coordinates.x, coordinates.z, loadedChunkStack->chunkStack);
+		loadedChunkStack->chunkStack.coordinates = coordinates;
+
+		loadedChunkStack->generateSectionBoxData();
+		loadedChunkStack->generateBoxData(columnBoxData[i], columnEmissiveBoxData[i]);
+
+		delete loadedChunkStack;
+	});
+	std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+	double elapsedGeneration = std::chrono::duration<double, std::chrono::milliseconds::period>(stop - start).count();
+
+	std::vector<BoxData> boxData;
+	std::vector<BoxData> emissiveBoxData;
+
+	for (size_t i = 0; i < columnBoxData.size(); i++) {
+		boxData.insert(boxData.end(), columnBoxData[i].begin(), columnBoxData[i].end());
+		emissiveBoxData.insert(emissiveBoxData.end(), columnEmissiveBoxData[i].begin(), columnEmissiveBoxData[i].end());
+	}
+
+	//Same light as in the photo mode of the Application
+	std::vector<PointLight> pointLights = {};
+	pointLights.push_back({ glm::vec4(50.f, 100.f, 50.f, 0.0f), glm::vec4(300.f) });
+
+	Camera camera;
+
+	CpuPathTracer cpuPathTracer(boxData, emissiveBoxData, pointLights);
+
+	std::vector<glm::vec3> image;
+	std::vector<float> variance;
+	cpuPathTracer.render(camera.getCameraPosition(), camera.cameraFront, camera.cameraUp, ComputeSettings::iData, ComputeSettings::COMPUTE_WIDTH, ComputeSettings::COMPUTE_HEIGHT, ComputeSettings::CPU_REFERENCE_SAMPLES, image, variance);
+
+	CpuPathTracer::writeImage(ComputeSettings::CPU_REFERENCE_IMAGE_PATH, image, ComputeSettings::COMPUTE_WIDTH, ComputeSettings::COMPUTE_HEIGHT);
+
+	std::cout << std::fixed << std::setprecision(2) << "CPU reference" << "\t" << boxData.size() << " boxes in " << elapsedGeneration << "ms" << "\t" << ComputeSettings::CPU_REFERENCE_SAMPLES << " samples in " << cpuPathTracer.getRenderMilliseconds() << "ms" << "\t" << (double)cpuPathTracer.getRayCount() / 1000 / 1000 / (cpuPathTracer.getRenderMilliseconds() / 1000) << "M rays/sec" << "\t" << "written to " << ComputeSettings::CPU_REFERENCE_IMAGE_PATH << std::endl;
+
+	//No key toggles the denoiser without a window, so it is always checked against the reference here
+	cpuPathTracer.validateDenoiser(camera.getCameraPosition(), camera.cameraFront, camera.cameraUp, ComputeSettings::iData, image);
+}
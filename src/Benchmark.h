@@ -0,0 +1,30 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+//Headless micro benchmarks, started with "TerraMater --benchmark <name>"
+class Benchmark {
+public:
+	Benchmark();
+	~Benchmark();
+
+	static bool run(std::string const &name);
+
+	static void randomSampler();
+
+	static void terrain();
+
+	static void clouds();
+
+	static void occlusion();
+
+	//Renders the loaded area around the start position with the CpuPathTracer and writes the PPM, started with "TerraMater --reference"
+	//The Denoiser is validated against the reference as well, see CpuPathTracer::validateDenoiser
+	static void reference();
+
+private:
+
+};
+
+#endif // !BENCHMARK_H
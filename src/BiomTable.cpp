@@ -0,0 +1,78 @@
+#include "BiomTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+BiomTable::BiomTable() {}
+
+BiomTable::~BiomTable() {}
+
+void BiomTable::addBiom(BiomData const &biomData, float const moisture, float const temperature) {
+	float const *fields = reinterpret_cast<float const *>(&biomData);
+
+	std::vector<float> newParameters(PARAMETER_COUNT * (biomCount + 1));
+
+	for (size_t p = 0; p < PARAMETER_COUNT; p++) {
+		for (size_t b = 0; b < biomCount; b++) {
+			newParameters[p * (biomCount + 1) + b] = parameters[p * biomCount + b];
+		}
+
+		newParameters[p * (biomCount + 1) + biomCount] = fields[p];
+	}
+
+	parameters = newParameters;
+	moistureAnchors.push_back(moisture);
+	temperatureAnchors.push_back(temperature);
+	biomCount++;
+}
+
+void BiomTable::blend(float const *moisture, float const *temperature, size_t const count, BiomData *biomData) const {
+	thread_local std::vector<float> clampedMoisture;
+	thread_local std::vector<float> clampedTemperature;
+	thread_local std::vector<float> weights;
+	thread_local std::vector<float> weightSums;
+	thread_local std::vector<float> blended;
+
+	clampedMoisture.resize(count);
+	clampedTemperature.resize(count);
+	weights.resize(count);
+	weightSums.assign(count, 0.0f);
+	blended.assign(PARAMETER_COUNT * count, 0.0f);
+
+	for (size_t i = 0; i < count; i++) {
+		clampedMoisture[i] = std::min(std::max(moisture[i], -1.0f), 1.0f);
+		clampedTemperature[i] = std::min(std::max(temperature[i], -1.0f), 1.0f);
+	}
+
+	for (size_t b = 0; b < biomCount; b++) {
+		float moistureAnchor = moistureAnchors[b];
+		float temperatureAnchor = temperatureAnchors[b];
+
+		//A biom has full weight up to 0.5 away from its corner and fades out linearly over the next 1.0
+		for (size_t i = 0; i < count; i++) {
+			float moistureWeight = std::min(std::max(1.5f - std::abs(clampedMoisture[i] - moistureAnchor), 0.0f), 1.0f);
+			float temperatureWeight = std::min(std::max(1.5f - std::abs(clampedTemperature[i] - temperatureAnchor), 0.0f), 1.0f);
+
+			weights[i] = moistureWeight * temperatureWeight;
+			weightSums[i] += weights[i];
+		}
+
+		for (size_t p = 0; p < PARAMETER_COUNT; p++) {
+			float parameter = parameters[p * biomCount + b];
+			float *row = blended.data() + p * count;
+
+			for (size_t i = 0; i < count; i++) {
+				row[i] += weights[i] * parameter;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		float *fields = reinterpret_cast<float *>(&biomData[i]);
+		float inverseWeightSum = weightSums[i] > 0.0f ? 1.0f / weightSums[i] : 0.0f;
+
+		for (size_t p = 0; p < PARAMETER_COUNT; p++) {
+			fields[p] = blended[p * count + i] * inverseWeightSum;
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef BIOMTABLE_H
+#define BIOMTABLE_H
+
+#include "BiomData.h"
+
+#include <cstddef>
+#include <vector>
+
+//Biom parameters stored as a matrix with one row per BiomData field, blended with a weight per biom
+class BiomTable {
+public:
+	BiomTable();
+	~BiomTable();
+
+	static size_t const PARAMETER_COUNT = sizeof(BiomData) / sizeof(float);
+
+	//Moisture and temperature give the position of the biom on the climate map, the corners are at -1 and 1
+	void addBiom(BiomData const &biomData, float const moisture, float const temperature);
+
+	//Blends count columns at once, the loops run over the columns so they can be vectorized
+	void blend(float const *moisture, float const *temperature, size_t const count, BiomData *biomData) const;
+
+private:
+	size_t biomCount = 0;
+
+	std::vector<float> moistureAnchors;
+	std::vector<float> temperatureAnchors;
+
+	//parameters[p * biomCount + b] is field p of biom b
+	std::vector<float> parameters;
+};
+
+#endif // !BIOMTABLE_H
@@ -0,0 +1,174 @@
+#include "BoxBvh.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+	//Same as BOX_HALF_SIZE in shaders/compute.comp
+	glm::vec3 const BOX_HALF_SIZE = glm::vec3(0.5f);
+}
+
+BoxBvh::BoxBvh() {}
+
+BoxBvh::~BoxBvh() {}
+
+void BoxBvh::build(std::vector<BoxData> &boxData, std::vector<BvhNode> &nodes) {
+	nodes.clear();
+
+	//A binary tree over n leaves of at least one box has at most 2n - 1 nodes
+	nodes.reserve(std::max(boxData.size() * 2, (size_t)1));
+
+	BvhNode root{};
+	root.leftOrFirst = 0;
+	root.count = (int32_t)boxData.size();
+	nodes.push_back(root);
+
+	updateBounds(boxData, nodes[0]);
+
+	subdivide(boxData, nodes, 0, 0);
+}
+
+void BoxBvh::subdivide(std::vector<BoxData> &boxData, std::vector<BvhNode> &nodes, size_t const nodeIndex, int const depth) {
+	//A deeper tree could overflow the traversal stack, which would silently skip nodes, so the boxes are tested one after the other instead
+	if (nodes[nodeIndex].count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH) {
+		return;
+	}
+
+	int axis = 0;
+	float position = 0.0f;
+	float splitCost = findSplit(boxData, nodes[nodeIndex], axis, position);
+
+	float leafCost = (float)nodes[nodeIndex].count * getArea(nodes[nodeIndex].minBound, nodes[nodeIndex].maxBound);
+	if (splitCost >= leafCost) {
+		return;
+	}
+
+	auto begin = boxData.begin() + nodes[nodeIndex].leftOrFirst;
+	auto end = begin + nodes[nodeIndex].count;
+	auto middle = std::partition(begin, end, [axis, position](BoxData const &box) {
+		return box.position[axis] < position;
+		});
+
+	int32_t leftCount = (int32_t)(middle - begin);
+	if (leftCount == 0 || leftCount == nodes[nodeIndex].count) {
+		return;
+	}
+
+	//Children are stored next to each other, so the node only needs the index of the left one
+	BvhNode left{};
+	left.leftOrFirst = nodes[nodeIndex].leftOrFirst;
+	left.count = leftCount;
+
+	BvhNode right{};
+	right.leftOrFirst = nodes[nodeIndex].leftOrFirst + leftCount;
+	right.count = nodes[nodeIndex].count - leftCount;
+
+	size_t leftIndex = nodes.size();
+	nodes.push_back(left);
+	nodes.push_back(right);
+
+	nodes[nodeIndex].leftOrFirst = (int32_t)leftIndex;
+	nodes[nodeIndex].count = 0;
+
+	updateBounds(boxData, nodes[leftIndex]);
+	updateBounds(boxData, nodes[leftIndex + 1]);
+
+	subdivide(boxData, nodes, leftIndex, depth + 1);
+	subdivide(boxData, nodes, leftIndex + 1, depth + 1);
+}
+
+void BoxBvh::updateBounds(std::vector<BoxData> const &boxData, BvhNode &node) {
+	node.minBound = glm::vec3(std::numeric_limits<float>::max());
+	node.maxBound = glm::vec3(-std::numeric_limits<float>::max());
+
+	for (int32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+		node.minBound = glm::min(node.minBound, boxData[i].position - BOX_HALF_SIZE);
+		node.maxBound = glm::max(node.maxBound, boxData[i].position + BOX_HALF_SIZE);
+	}
+}
+
+float BoxBvh::findSplit(std::vector<BoxData> const &boxData, BvhNode const &node, int &axis, float &position) {
+	float bestCost = std::numeric_limits<float>::max();
+
+	for (int a = 0; a < 3; a++) {
+		//Bins are spread over the centres, not the bounds, so every bin can get boxes
+		float centreMin = std::numeric_limits<float>::max();
+		float centreMax = -std::numeric_limits<float>::max();
+
+		for (int32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+			centreMin = std::min(centreMin, boxData[i].position[a]);
+			centreMax = std::max(centreMax, boxData[i].position[a]);
+		}
+
+		if (centreMin == centreMax) {
+			continue;
+		}
+
+		Bin bins[BIN_COUNT];
+		for (int b = 0; b < BIN_COUNT; b++) {
+			bins[b].minBound = glm::vec3(std::numeric_limits<float>::max());
+			bins[b].maxBound = glm::vec3(-std::numeric_limits<float>::max());
+			bins[b].count = 0;
+		}
+
+		float scale = BIN_COUNT / (centreMax - centreMin);
+
+		for (int32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+			int b = std::min(BIN_COUNT - 1, (int)((boxData[i].position[a] - centreMin) * scale));
+
+			bins[b].minBound = glm::min(bins[b].minBound, boxData[i].position - BOX_HALF_SIZE);
+			bins[b].maxBound = glm::max(bins[b].maxBound, boxData[i].position + BOX_HALF_SIZE);
+			bins[b].count++;
+		}
+
+		//Areas and counts left of every split plane, sweeping from the left, then the right side sweeping back
+		float leftArea[BIN_COUNT - 1];
+		int leftCount[BIN_COUNT - 1];
+
+		glm::vec3 minBound = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 maxBound = glm::vec3(-std::numeric_limits<float>::max());
+		int count = 0;
+
+		for (int b = 0; b < BIN_COUNT - 1; b++) {
+			count += bins[b].count;
+			if (bins[b].count != 0) {
+				minBound = glm::min(minBound, bins[b].minBound);
+				maxBound = glm::max(maxBound, bins[b].maxBound);
+			}
+
+			leftCount[b] = count;
+			leftArea[b] = count != 0 ? getArea(minBound, maxBound) : 0.0f;
+		}
+
+		minBound = glm::vec3(std::numeric_limits<float>::max());
+		maxBound = glm::vec3(-std::numeric_limits<float>::max());
+		count = 0;
+
+		for (int b = BIN_COUNT - 1; b > 0; b--) {
+			count += bins[b].count;
+			if (bins[b].count != 0) {
+				minBound = glm::min(minBound, bins[b].minBound);
+				maxBound = glm::max(maxBound, bins[b].maxBound);
+			}
+
+			if (count == 0 || leftCount[b - 1] == 0) {
+				continue;
+			}
+
+			float cost = leftCount[b - 1] * leftArea[b - 1] + count * getArea(minBound, maxBound);
+			if (cost < bestCost) {
+				bestCost = cost;
+				axis = a;
+				position = centreMin + b / scale;
+			}
+		}
+	}
+
+	return bestCost;
+}
+
+float BoxBvh::getArea(glm::vec3 const &minBound, glm::vec3 const &maxBound) {
+	glm::vec3 extent = maxBound - minBound;
+
+	return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
@@ -0,0 +1,44 @@
+#ifndef BOXBVH_H
+#define BOXBVH_H
+
+#include "BoxData.h"
+#include "BvhNode.h"
+
+#include <vector>
+
+//Bounding volume hierarchy over the unit boxes of the path tracer, built with binned SAH over the box centres
+class BoxBvh {
+public:
+	BoxBvh();
+	~BoxBvh();
+
+	//Same as BVH_STACK_SIZE in shaders/compute.comp, a ray pushes at most one node per level on its way down
+	static int const STACK_SIZE = 64;
+
+	//Nodes this deep stay leaves, the rest of the stack is left to the top level tree of the BoxPool
+	static int const MAX_DEPTH = 48;
+
+	//Sorts boxData into leaf order, the nodes index into the sorted boxes
+	void build(std::vector<BoxData> &boxData, std::vector<BvhNode> &nodes);
+
+private:
+	struct Bin {
+		glm::vec3 minBound;
+		glm::vec3 maxBound;
+		int count;
+	};
+
+	static int const BIN_COUNT = 16;
+	static int const MAX_LEAF_SIZE = 4;
+
+	void subdivide(std::vector<BoxData> &boxData, std::vector<BvhNode> &nodes, size_t const nodeIndex, int const depth);
+
+	void updateBounds(std::vector<BoxData> const &boxData, BvhNode &node);
+
+	//Cost of the best split found, axis and position are only valid if it is lower than the cost of a leaf
+	float findSplit(std::vector<BoxData> const &boxData, BvhNode const &node, int &axis, float &position);
+
+	static float getArea(glm::vec3 const &minBound, glm::vec3 const &maxBound);
+};
+
+#endif // !BOXBVH_H
@@ -0,0 +1,271 @@
+#include "BoxPool.h"
+#include "BoxBvh.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+BoxPool::BoxPool() {}
+
+BoxPool::~BoxPool() {}
+
+void BoxPool::updateColumn(Coordinates const &coordinates, std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData) {
+	BoxColumn column;
+	column.boxes = boxData;
+	column.emissiveBoxData = emissiveBoxData;
+
+	if (!column.boxes.empty()) {
+		BoxBvh().build(column.boxes, column.nodes);
+	}
+
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	auto iterator = columns.find(coordinates);
+	if (iterator != columns.end()) {
+		releaseColumn(iterator->second);
+		iterator->second = std::move(column);
+	} else {
+		columns.emplace(coordinates, std::move(column));
+	}
+}
+
+void BoxPool::removeColumn(Coordinates const &coordinates) {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	auto iterator = columns.find(coordinates);
+	if (iterator == columns.end()) {
+		return;
+	}
+
+	releaseColumn(iterator->second);
+	columns.erase(iterator);
+}
+
+bool BoxPool::update(std::vector<BoxData> &emissiveBoxData) {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	for (size_t i = 0; i < releasedBoxRanges.size(); i++) {
+		boxRanges.free(releasedBoxRanges[i].first, releasedBoxRanges[i].count);
+	}
+	for (size_t i = 0; i < releasedNodeRanges.size(); i++) {
+		nodeRanges.free(releasedNodeRanges[i].first, releasedNodeRanges[i].count);
+	}
+
+	releasedBoxRanges.clear();
+	releasedNodeRanges.clear();
+
+	bool grown = false;
+
+	//A tree over n columns has 2n - 1 nodes
+	size_t topLevelNodeCount = std::max(columns.size() * 2, (size_t)1);
+
+	if (topLevelNodeCount > topLevelCapacity) {
+		grow(topLevelNodeCount);
+		grown = true;
+	}
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		BoxColumn &column = iterator->second;
+
+		if (!column.changed) {
+			continue;
+		}
+
+		column.changed = false;
+
+		//Places every column again, so none is left changed
+		if (!column.boxes.empty() && !placeColumn(column)) {
+			grow(topLevelNodeCount);
+			grown = true;
+			break;
+		}
+	}
+
+	std::vector<BvhNode> roots;
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		if (iterator->second.placed) {
+			roots.push_back(nodes[iterator->second.nodeOffset]);
+		}
+
+		emissiveBoxData.insert(emissiveBoxData.end(), iterator->second.emissiveBoxData.begin(), iterator->second.emissiveBoxData.end());
+	}
+
+	std::vector<BvhNode> topLevelNodes(1);
+
+	if (roots.empty()) {
+		//Bounds no ray can reach, the traversal stops at the root
+		topLevelNodes[0].minBound = glm::vec3(std::numeric_limits<float>::max());
+		topLevelNodes[0].maxBound = glm::vec3(std::numeric_limits<float>::max());
+		topLevelNodes[0].leftOrFirst = 0;
+		topLevelNodes[0].count = 0;
+	} else {
+		int topLevelDepth = buildTopLevel(roots, 0, roots.size(), topLevelNodes, 0);
+
+		//Halving keeps the tree balanced, so this only happens with far more columns than can be loaded
+		if (topLevelDepth + BoxBvh::MAX_DEPTH > BoxBvh::STACK_SIZE) {
+			throw std::runtime_error("Too many columns for the BVH traversal stack!");
+		}
+	}
+
+	std::copy(topLevelNodes.begin(), topLevelNodes.end(), nodes.begin());
+
+	if (!grown) {
+		dirtyNodeRanges.push_back({ 0, topLevelNodes.size() });
+	}
+
+	return grown;
+}
+
+std::vector<BoxData> const &BoxPool::getBoxes() const {
+	return boxes;
+}
+
+std::vector<BvhNode> const &BoxPool::getNodes() const {
+	return nodes;
+}
+
+std::vector<BoxPool::Range> const &BoxPool::getDirtyBoxRanges() const {
+	return dirtyBoxRanges;
+}
+
+std::vector<BoxPool::Range> const &BoxPool::getDirtyNodeRanges() const {
+	return dirtyNodeRanges;
+}
+
+void BoxPool::clearDirtyRanges() {
+	dirtyBoxRanges.clear();
+	dirtyNodeRanges.clear();
+}
+
+void BoxPool::releaseColumn(BoxColumn const &column) {
+	if (!column.placed) {
+		return;
+	}
+
+	releasedBoxRanges.push_back({ (size_t)column.boxOffset, column.boxes.size() });
+	releasedNodeRanges.push_back({ (size_t)column.nodeOffset, column.nodes.size() });
+}
+
+bool BoxPool::placeColumn(BoxColumn &column) {
+	uint64_t boxOffset = 0;
+	uint64_t nodeOffset = 0;
+
+	if (!boxRanges.allocate(column.boxes.size(), 1, boxOffset)) {
+		return false;
+	}
+
+	if (!nodeRanges.allocate(column.nodes.size(), 1, nodeOffset)) {
+		boxRanges.free(boxOffset, column.boxes.size());
+		return false;
+	}
+
+	std::copy(column.boxes.begin(), column.boxes.end(), boxes.begin() + boxOffset);
+
+	for (size_t i = 0; i < column.nodes.size(); i++) {
+		BvhNode node = column.nodes[i];
+
+		//Leaves point at boxes, inner nodes at their children
+		node.leftOrFirst += (int32_t)(node.count > 0 ? boxOffset : nodeOffset);
+
+		nodes[nodeOffset + i] = node;
+	}
+
+	column.placed = true;
+	column.boxOffset = boxOffset;
+	column.nodeOffset = nodeOffset;
+
+	dirtyBoxRanges.push_back({ (size_t)boxOffset, column.boxes.size() });
+	dirtyNodeRanges.push_back({ (size_t)nodeOffset, column.nodes.size() });
+
+	return true;
+}
+
+void BoxPool::grow(size_t const topLevelNodeCount) {
+	size_t boxCount = 0;
+	size_t nodeCount = 0;
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		boxCount += iterator->second.boxes.size();
+		nodeCount += iterator->second.nodes.size();
+	}
+
+	//Twice the current need, so the next columns fit in the free ranges for a while, the pools never shrink
+	size_t columnNodeCapacity = std::max({ nodeCount * 2, nodes.size() - topLevelCapacity, (size_t)MIN_NODE_CAPACITY });
+
+	topLevelCapacity = std::max(topLevelNodeCount * 2, (size_t)MIN_TOP_LEVEL_CAPACITY);
+	size_t boxCapacity = std::max({ boxCount * 2, boxes.size(), (size_t)MIN_BOX_CAPACITY });
+	size_t nodeCapacity = topLevelCapacity + columnNodeCapacity;
+
+	boxes.assign(boxCapacity, BoxData{});
+	nodes.assign(nodeCapacity, BvhNode{});
+
+	boxRanges = RangeAllocator(boxCapacity);
+	nodeRanges = RangeAllocator(nodeCapacity);
+
+	//First allocation of an empty allocator, so the top level tree starts at node 0
+	uint64_t topLevelOffset = 0;
+	nodeRanges.allocate(topLevelCapacity, 1, topLevelOffset);
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		BoxColumn &column = iterator->second;
+
+		column.changed = false;
+		column.placed = false;
+
+		if (!column.boxes.empty()) {
+			placeColumn(column);
+		}
+	}
+
+	//Everything moved, the buffers are uploaded as a whole
+	dirtyBoxRanges.assign(1, { 0, boxCapacity });
+	dirtyNodeRanges.assign(1, { 0, nodeCapacity });
+}
+
+int BoxPool::buildTopLevel(std::vector<BvhNode> &roots, size_t const first, size_t const count, std::vector<BvhNode> &topLevelNodes, size_t const nodeIndex) {
+	if (count == 1) {
+		topLevelNodes[nodeIndex] = roots[first];
+		return 0;
+	}
+
+	BvhNode node{};
+	node.minBound = glm::vec3(std::numeric_limits<float>::max());
+	node.maxBound = glm::vec3(-std::numeric_limits<float>::max());
+
+	glm::vec3 centreMin = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 centreMax = glm::vec3(-std::numeric_limits<float>::max());
+
+	for (size_t i = first; i < first + count; i++) {
+		node.minBound = glm::min(node.minBound, roots[i].minBound);
+		node.maxBound = glm::max(node.maxBound, roots[i].maxBound);
+
+		glm::vec3 centre = (roots[i].minBound + roots[i].maxBound) * 0.5f;
+		centreMin = glm::min(centreMin, centre);
+		centreMax = glm::max(centreMax, centre);
+	}
+
+	//The columns lie on a grid, so halving along the longer side keeps the tree balanced
+	glm::vec3 extent = centreMax - centreMin;
+	int axis = extent.x > extent.z ? 0 : 2;
+	if (extent.y > extent[axis]) {
+		axis = 1;
+	}
+
+	auto begin = roots.begin() + first;
+	std::nth_element(begin, begin + count / 2, begin + count, [axis](BvhNode const &a, BvhNode const &b) {
+		return a.minBound[axis] + a.maxBound[axis] < b.minBound[axis] + b.maxBound[axis];
+		});
+
+	size_t leftIndex = topLevelNodes.size();
+	topLevelNodes.resize(leftIndex + 2);
+
+	node.leftOrFirst = (int32_t)leftIndex;
+	node.count = 0;
+	topLevelNodes[nodeIndex] = node;
+
+	int leftDepth = buildTopLevel(roots, first, count / 2, topLevelNodes, leftIndex);
+	int rightDepth = buildTopLevel(roots, first + count / 2, count - count / 2, topLevelNodes, leftIndex + 1);
+
+	return std::max(leftDepth, rightDepth) + 1;
+}
@@ -0,0 +1,98 @@
+#ifndef BOXPOOL_H
+#define BOXPOOL_H
+
+#include "BoxData.h"
+#include "BvhNode.h"
+#include "Coordinates.h"
+#include "RangeAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//Visible boxes of every loaded column with a BVH per column, packed into one box pool and one node pool for the compute shader
+//The columns are linked by a small tree at the start of the node pool, so node 0 stays the root for shaders/compute.comp
+class BoxPool {
+public:
+	//In boxes or nodes, not bytes
+	struct Range {
+		size_t first;
+		size_t count;
+	};
+
+	BoxPool();
+	~BoxPool();
+
+	//Called from the loading tasks once the column is meshed, the BVH of the column is built right away outside the lock
+	void updateColumn(Coordinates const &coordinates, std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData);
+
+	void removeColumn(Coordinates const &coordinates);
+
+	//Only called from the render thread, places the columns changed since the last call and relinks all columns under node 0
+	//Returns true if the pools had to grow, they then have to be uploaded as a whole instead of only their dirty ranges
+	bool update(std::vector<BoxData> &emissiveBoxData);
+
+	//Sized to the capacity, the unused parts are never reached from node 0
+	std::vector<BoxData> const &getBoxes() const;
+	std::vector<BvhNode> const &getNodes() const;
+
+	//Parts of the pools written by update since the last clearDirtyRanges
+	std::vector<Range> const &getDirtyBoxRanges() const;
+	std::vector<Range> const &getDirtyNodeRanges() const;
+
+	void clearDirtyRanges();
+
+private:
+	struct BoxColumn {
+		//In leaf order, the nodes index into these and into each other starting at 0
+		std::vector<BoxData> boxes;
+		std::vector<BvhNode> nodes;
+		std::vector<BoxData> emissiveBoxData;
+
+		bool changed = true;
+		bool placed = false;
+		uint64_t boxOffset = 0;
+		uint64_t nodeOffset = 0;
+	};
+
+	static size_t const MIN_BOX_CAPACITY = 1 << 14;
+	static size_t const MIN_NODE_CAPACITY = 1 << 15;
+	static size_t const MIN_TOP_LEVEL_CAPACITY = 1 << 10;
+
+	//Guards the columns, the pools themselves are only touched by update
+	std::mutex mutex;
+
+	std::map<Coordinates, BoxColumn> columns;
+
+	//Ranges of removed and replaced columns, freed by the next update so the render thread owns the allocators
+	std::vector<Range> releasedBoxRanges;
+	std::vector<Range> releasedNodeRanges;
+
+	std::vector<BoxData> boxes;
+	std::vector<BvhNode> nodes;
+
+	RangeAllocator boxRanges;
+	RangeAllocator nodeRanges;
+
+	//Nodes reserved at the start of the node pool for the tree over the columns
+	size_t topLevelCapacity = 0;
+
+	std::vector<Range> dirtyBoxRanges;
+	std::vector<Range> dirtyNodeRanges;
+
+	void releaseColumn(BoxColumn const &column);
+
+	//Copies the column into free ranges of the pools with its indices moved there, false if it does not fit
+	bool placeColumn(BoxColumn &column);
+
+	//Reallocates the pools with room for all columns and a top level tree over topLevelNodeCount nodes, then places every column again
+	void grow(size_t const topLevelNodeCount);
+
+	//The leaves of the top level tree are copies of the column roots, so it ends where the column trees begin
+	//Returns the depth of its leaves, the column trees continue below them
+	int buildTopLevel(std::vector<BvhNode> &roots, size_t const first, size_t const count, std::vector<BvhNode> &topLevelNodes, size_t const nodeIndex);
+};
+
+#endif // !BOXPOOL_H
@@ -0,0 +1,191 @@
+#include "BrickMap.h"
+
+#include <algorithm>
+
+BrickMap::BrickMap() {}
+
+BrickMap::~BrickMap() {}
+
+void BrickMap::updateColumn(ChunkStack const &chunkStack, std::vector<BoxData> const &emissiveBoxData) {
+	BrickColumn column;
+	column.sectionCount = chunkStack.stack.size();
+	column.emissiveBoxData = emissiveBoxData;
+
+	size_t bricksPerColumn = column.sectionCount * BRICKS_PER_CHUNK;
+	column.bricks.assign(BRICKS_PER_CHUNK * BRICKS_PER_CHUNK * bricksPerColumn, 0);
+
+	//Built without the lock, the loading tasks of other columns only wait for the copy into the pool
+	std::vector<uint32_t> columnVoxels;
+
+	for (size_t y = 0; y < column.sectionCount; y++) {
+		for (int x = 0; x < BRICKS_PER_CHUNK; x++) {
+			for (int z = 0; z < BRICKS_PER_CHUNK; z++) {
+				for (int b = 0; b < BRICKS_PER_CHUNK; b++) {
+					size_t index = ((size_t)x * BRICKS_PER_CHUNK + z) * bricksPerColumn + y * BRICKS_PER_CHUNK + b;
+
+					column.bricks[index] = createBrick(chunkStack.stack[y], x * BRICK_SIZE, b * BRICK_SIZE, z * BRICK_SIZE, columnVoxels);
+				}
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	for (size_t i = 0; i < column.bricks.size(); i++) {
+		if (column.bricks[i] == 0 || (column.bricks[i] & UNIFORM_BRICK)) {
+			continue;
+		}
+
+		if (freeBricks.empty()) {
+			size_t capacity = brickVoxels.size() / BRICK_UINTS;
+			size_t newCapacity = std::max(capacity * 2, MIN_BRICK_CAPACITY);
+
+			brickVoxels.resize(newCapacity * BRICK_UINTS, 0);
+
+			//Lowest first, so the pool fills from the front
+			for (size_t b = newCapacity; b > capacity; b--) {
+				freeBricks.push_back((uint32_t)(b - 1));
+			}
+		}
+
+		uint32_t brick = freeBricks.back();
+		freeBricks.pop_back();
+
+		auto source = columnVoxels.begin() + (size_t)(column.bricks[i] - 1) * BRICK_UINTS;
+		std::copy(source, source + BRICK_UINTS, brickVoxels.begin() + (size_t)brick * BRICK_UINTS);
+
+		dirtyBricks.push_back(brick);
+
+		column.bricks[i] = brick + 1;
+	}
+
+	auto iterator = columns.find(chunkStack.coordinates);
+	if (iterator != columns.end()) {
+		releaseBricks(iterator->second);
+		iterator->second = std::move(column);
+	} else {
+		columns.emplace(chunkStack.coordinates, std::move(column));
+	}
+}
+
+void BrickMap::removeColumn(Coordinates const &coordinates) {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	auto iterator = columns.find(coordinates);
+	if (iterator == columns.end()) {
+		return;
+	}
+
+	releaseBricks(iterator->second);
+	columns.erase(iterator);
+}
+
+void BrickMap::generateVoxelGrid(VoxelGrid &voxelGrid, std::vector<BoxData> &emissiveBoxData) {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	//A brick written by several columns since the last grid is uploaded once, neighbouring ones in one transfer
+	std::sort(dirtyBricks.begin(), dirtyBricks.end());
+	dirtyBricks.erase(std::unique(dirtyBricks.begin(), dirtyBricks.end()), dirtyBricks.end());
+
+	voxelGrid.dirtyBrickRanges.clear();
+
+	for (size_t i = 0; i < dirtyBricks.size(); i++) {
+		if (!voxelGrid.dirtyBrickRanges.empty() && voxelGrid.dirtyBrickRanges.back().first + voxelGrid.dirtyBrickRanges.back().second == dirtyBricks[i]) {
+			voxelGrid.dirtyBrickRanges.back().second++;
+		} else {
+			voxelGrid.dirtyBrickRanges.push_back({ dirtyBricks[i], 1 });
+		}
+	}
+
+	dirtyBricks.clear();
+
+	if (columns.empty()) {
+		voxelGrid.origin = glm::ivec4(0);
+		voxelGrid.size = glm::ivec4(0);
+		voxelGrid.bricks.clear();
+		voxelGrid.brickVoxels.clear();
+		return;
+	}
+
+	Coordinates minCoordinates = columns.begin()->first;
+	Coordinates maxCoordinates = columns.begin()->first;
+	size_t maxSectionCount = 0;
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		minCoordinates = { std::min(minCoordinates.x, iterator->first.x), std::min(minCoordinates.z, iterator->first.z) };
+		maxCoordinates = { std::max(maxCoordinates.x, iterator->first.x), std::max(maxCoordinates.z, iterator->first.z) };
+		maxSectionCount = std::max(maxSectionCount, iterator->second.sectionCount);
+	}
+
+	glm::ivec3 brickCount = glm::ivec3((maxCoordinates.x - minCoordinates.x + 1) * BRICKS_PER_CHUNK, (int)maxSectionCount * BRICKS_PER_CHUNK, (maxCoordinates.z - minCoordinates.z + 1) * BRICKS_PER_CHUNK);
+
+	voxelGrid.origin = glm::ivec4(minCoordinates.x * Settings::CHUNK_SIZE, 0, minCoordinates.z * Settings::CHUNK_SIZE, 0);
+	voxelGrid.size = glm::ivec4(brickCount * BRICK_SIZE, 0);
+	voxelGrid.bricks.assign((size_t)brickCount.x * brickCount.y * brickCount.z, 0);
+	voxelGrid.brickVoxels = brickVoxels;
+
+	for (auto iterator = columns.begin(); iterator != columns.end(); iterator++) {
+		BrickColumn const &column = iterator->second;
+		size_t bricksPerColumn = column.sectionCount * BRICKS_PER_CHUNK;
+
+		int offsetX = (iterator->first.x - minCoordinates.x) * BRICKS_PER_CHUNK;
+		int offsetZ = (iterator->first.z - minCoordinates.z) * BRICKS_PER_CHUNK;
+
+		for (int x = 0; x < BRICKS_PER_CHUNK; x++) {
+			for (int z = 0; z < BRICKS_PER_CHUNK; z++) {
+				//The bricks of a column are stored in the same y order, so every x, z row is copied at once
+				auto source = column.bricks.begin() + ((size_t)x * BRICKS_PER_CHUNK + z) * bricksPerColumn;
+				size_t target = ((size_t)(offsetX + x) * brickCount.z + (offsetZ + z)) * brickCount.y;
+
+				std::copy(source, source + bricksPerColumn, voxelGrid.bricks.begin() + target);
+			}
+		}
+
+		emissiveBoxData.insert(emissiveBoxData.end(), column.emissiveBoxData.begin(), column.emissiveBoxData.end());
+	}
+}
+
+uint32_t BrickMap::createBrick(Chunk const &chunk, int const u, int const v, int const w, std::vector<uint32_t> &columnVoxels) {
+	CubeType firstType = chunk.cubes[u][w][v].cubeType;
+	bool uniform = true;
+
+	for (int x = 0; x < BRICK_SIZE && uniform; x++) {
+		for (int z = 0; z < BRICK_SIZE && uniform; z++) {
+			for (int y = 0; y < BRICK_SIZE; y++) {
+				if (chunk.cubes[u + x][w + z][v + y].cubeType != firstType) {
+					uniform = false;
+					break;
+				}
+			}
+		}
+	}
+
+	if (uniform) {
+		return firstType == CubeType::AIR ? 0 : UNIFORM_BRICK | (uint32_t)firstType;
+	}
+
+	uint32_t brick = (uint32_t)(columnVoxels.size() / BRICK_UINTS);
+	columnVoxels.resize(columnVoxels.size() + BRICK_UINTS, 0);
+
+	uint32_t *voxels = columnVoxels.data() + (size_t)brick * BRICK_UINTS;
+
+	for (int x = 0; x < BRICK_SIZE; x++) {
+		for (int z = 0; z < BRICK_SIZE; z++) {
+			for (int y = 0; y < BRICK_SIZE; y++) {
+				int index = (x * BRICK_SIZE + z) * BRICK_SIZE + y;
+
+				voxels[index >> 2] |= (uint32_t)chunk.cubes[u + x][w + z][v + y].cubeType << ((index & 3) * 8);
+			}
+		}
+	}
+
+	return brick + 1;
+}
+
+void BrickMap::releaseBricks(BrickColumn const &column) {
+	for (size_t i = 0; i < column.bricks.size(); i++) {
+		if (column.bricks[i] != 0 && !(column.bricks[i] & UNIFORM_BRICK)) {
+			freeBricks.push_back(column.bricks[i] - 1);
+		}
+	}
+}
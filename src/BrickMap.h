@@ -0,0 +1,70 @@
+#ifndef BRICKMAP_H
+#define BRICKMAP_H
+
+#include "Coordinates.h"
+#include "ChunkStack.h"
+#include "BoxData.h"
+#include "VoxelGrid.h"
+#include "Settings.h"
+#include "ComputeSettings.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+//Sparse bricks of the loaded chunk stacks for the path tracer, kept up to date while the columns stream in and out
+//Only bricks mixing cube types store their voxels, so the memory grows with the terrain surface and not with the loaded volume
+class BrickMap {
+public:
+	BrickMap();
+
+	~BrickMap();
+
+	static uint32_t const UNIFORM_BRICK = 0x80000000u;
+
+	static int const BRICK_SIZE = ComputeSettings::VOXEL_BRICK_SIZE;
+	static int const BRICK_UINTS = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE / 4;
+	static int const BRICKS_PER_CHUNK = Settings::CHUNK_SIZE / BRICK_SIZE;
+
+	//Replaces the bricks of the column, called by the loading tasks once the stack is loaded
+	void updateColumn(ChunkStack const &chunkStack, std::vector<BoxData> const &emissiveBoxData);
+
+	void removeColumn(Coordinates const &coordinates);
+
+	//Top level grid over the bounding box of all columns, the stored bricks are copied as they are together with the ones written since the last call
+	void generateVoxelGrid(VoxelGrid &voxelGrid, std::vector<BoxData> &emissiveBoxData);
+
+private:
+	struct BrickColumn {
+		//Brick (x, y, z) of the column has the index (x * BRICKS_PER_CHUNK + z) * sectionCount * BRICKS_PER_CHUNK + y
+		std::vector<uint32_t> bricks;
+
+		size_t sectionCount = 0;
+
+		std::vector<BoxData> emissiveBoxData;
+	};
+
+	std::map<Coordinates, BrickColumn> columns;
+
+	static size_t const MIN_BRICK_CAPACITY = 1 << 12;
+
+	//Freed bricks are reused by the next columns, so the pool only grows with the number of mixed bricks
+	//It doubles when it is full, so the brick buffer of the path tracer is rarely created again
+	std::vector<uint32_t> brickVoxels;
+	std::vector<uint32_t> freeBricks;
+
+	//Written by updateColumn since the last generateVoxelGrid, a column streaming in only uploads its own bricks
+	std::vector<uint32_t> dirtyBricks;
+
+	std::mutex mutex;
+
+	//Entry of the brick starting at cube u, v, w of the chunk, mixed bricks are appended to columnVoxels and point into it until they are moved into the pool
+	static uint32_t createBrick(Chunk const &chunk, int const u, int const v, int const w, std::vector<uint32_t> &columnVoxels);
+
+	void releaseBricks(BrickColumn const &column);
+};
+
+static_assert(Settings::CHUNK_SIZE % ComputeSettings::VOXEL_BRICK_SIZE == 0, "Bricks may not cross chunk borders");
+
+#endif // !BRICKMAP_H
@@ -8,6 +8,7 @@
 #include "stb_image.h"
 
 #include <stdexcept>
+#include <algorithm>
 
 #ifdef _DEBUG
 #include <iostream>
@@ -15,8 +16,8 @@
 
 BufferCreator::BufferCreator() {}
 
-BufferCreator::BufferCreator(VkPhysicalDevice const &physicalDevice, VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, CommandWrapper &commandWrapper)
-	: physicalDevice(physicalDevice), device(device), queueFamilyIndices(queueFamilyIndices), commandWrapper(&commandWrapper) {}
+BufferCreator::BufferCreator(VkPhysicalDevice const &physicalDevice, VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, CommandWrapper &commandWrapper, MemoryAllocator &memoryAllocator)
+	: physicalDevice(physicalDevice), device(device), queueFamilyIndices(queueFamilyIndices), commandWrapper(&commandWrapper), memoryAllocator(&memoryAllocator) {}
 
 BufferCreator::~BufferCreator() {}
 
@@ -95,6 +96,39 @@ void BufferCreator::createIndexBuffer(std::vector<uint32_t> const &indices, VkBu
 	vkFreeMemory(device, stagingBufferMemory, nullptr);
 }
 
+void BufferCreator::createVertexBuffer(std::vector<ChunkVertex> const &vertices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation) const {
+	createDeviceLocalBuffer(vertices.data(), sizeof(vertices[0]) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferAllocation);
+}
+
+void BufferCreator::createIndexBuffer(std::vector<uint32_t> const &indices, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation) const {
+	createDeviceLocalBuffer(indices.data(), sizeof(indices[0]) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferAllocation);
+}
+
+void BufferCreator::destroyBuffer(VkBuffer &buffer, MemoryAllocation &allocation) const {
+	if (buffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(device, buffer, nullptr);
+		buffer = VK_NULL_HANDLE;
+	}
+
+	memoryAllocator->free(allocation);
+}
+
+void BufferCreator::createDestinationBuffer(VkDeviceSize const bufferSize, VkBufferUsageFlags const bufferUsageFlags, VkBuffer &buffer, MemoryAllocation &allocation) const {
+	createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | bufferUsageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+}
+
+void BufferCreator::createStagingBuffer(VkDeviceSize const bufferSize, VkBuffer &stagingBuffer, MemoryAllocation &stagingBufferAllocation) const {
+	createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferAllocation);
+}
+
+void BufferCreator::createIndirectBuffer(VkDeviceSize const bufferSize, VkBuffer &indirectBuffer, MemoryAllocation &indirectBufferAllocation) const {
+	createBuffer(bufferSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, indirectBuffer, indirectBufferAllocation);
+}
+
+void BufferCreator::createHostStorageBuffer(VkDeviceSize const bufferSize, VkBuffer &storageBuffer, MemoryAllocation &storageBufferAllocation) const {
+	createBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, storageBuffer, storageBufferAllocation);
+}
+
 void BufferCreator::createUniformBuffer(VkBuffer &uniformBuffer, VkDeviceMemory &uniformBufferMemory) const {
 	VkDeviceSize bufferSize = sizeof(UniformBufferObject);
 
@@ -169,6 +203,33 @@ void BufferCreator::createPointLightBuffer(VkBuffer &pointLightBuffer, VkDeviceM
 	vkFreeMemory(device, stagingBufferMemory, nullptr);
 }
 
+void BufferCreator::createLightGridBuffer(VkBuffer &lightGridBuffer, VkDeviceMemory &lightGridBufferMemory, VkDeviceSize &lightGridBufferSize, LightGrid const &lightGrid) const {
+	VkDeviceSize headerSize = sizeof(lightGrid.origin) + sizeof(lightGrid.size);
+
+	lightGridBufferSize = headerSize + sizeof(LightGridEntry) * std::max(lightGrid.entries.size(), (size_t)1);
+
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingBufferMemory;
+	createBuffer(lightGridBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+	//Copying the grid into the staging buffer
+	void *data;
+	vkMapMemory(device, stagingBufferMemory, 0, lightGridBufferSize, 0, &data);
+	memset(data, 0, (size_t)lightGridBufferSize);
+	memcpy(data, &lightGrid.origin, sizeof(lightGrid.origin));
+	memcpy((char *)data + sizeof(lightGrid.origin), &lightGrid.size, sizeof(lightGrid.size));
+	memcpy((char *)data + headerSize, lightGrid.entries.data(), sizeof(LightGridEntry) * lightGrid.entries.size());
+	vkUnmapMemory(device, stagingBufferMemory);
+
+	//Creating the real buffer and copying from the staging buffer
+	createBuffer(lightGridBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, lightGridBuffer, lightGridBufferMemory);
+	copyBuffer(stagingBuffer, lightGridBuffer, lightGridBufferSize);
+
+	//Releasing the staging buffer
+	vkDestroyBuffer(device, stagingBuffer, nullptr);
+	vkFreeMemory(device, stagingBufferMemory, nullptr);
+}
+
 void BufferCreator::createTextureBuffer(char const *filePath, VkBuffer &stagingBuffer, VkDeviceMemory &stagingBufferMemory, uint32_t &textureWidth, uint32_t &textureHeight) const {
 	int textureWidthINT;
 	int textureHeightINT;
@@ -252,12 +313,55 @@ void BufferCreator::createBuffer(VkDeviceSize const &bufferSize, VkBufferUsageFl
 	vkBindBufferMemory(device, buffer, bufferMemory, 0);
 }
 
-void BufferCreator::copyBuffer(VkBuffer sourceBuffer, VkBuffer destinationBuffer, VkDeviceSize size) const {
+void BufferCreator::createBuffer(VkDeviceSize const &bufferSize, VkBufferUsageFlags const &bufferUsageFlags, VkMemoryPropertyFlags const &memoryPropertyFlags, VkBuffer &buffer, MemoryAllocation &allocation) const {
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size = bufferSize;
+	bufferCreateInfo.usage = bufferUsageFlags;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+
+	uint32_t queueFamilyIndicesArray[] = { queueFamilyIndices.graphicsFamilyIndex, queueFamilyIndices.transferFamilyIndex };
+
+	bufferCreateInfo.queueFamilyIndexCount = 2;
+	bufferCreateInfo.pQueueFamilyIndices = queueFamilyIndicesArray;
+
+	if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create buffer");
+	}
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetBufferMemoryRequirements(device, buffer, &memoryRequirements);
+
+	//Only a range of a shared memory block, so the buffer is bound at the offset of that range
+	memoryAllocator->allocate(memoryRequirements, memoryPropertyFlags, allocation);
+
+	vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+}
+
+void BufferCreator::createDeviceLocalBuffer(void const *data, VkDeviceSize const bufferSize, VkBufferUsageFlags const &bufferUsageFlags, VkBuffer &buffer, MemoryAllocation &allocation) const {
+	//Creating a staging buffer, its memory block is already mapped
+	VkBuffer stagingBuffer;
+	MemoryAllocation stagingBufferAllocation;
+	createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferAllocation);
+
+	memcpy(stagingBufferAllocation.mapped, data, (size_t)bufferSize);
+
+	//Creating the real buffer
+	createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | bufferUsageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+
+	//Copying from the staging buffer into the real buffer
+	copyBuffer(stagingBuffer, buffer, bufferSize);
+
+	//Releasing the staging buffer
+	destroyBuffer(stagingBuffer, stagingBufferAllocation);
+}
+
+void BufferCreator::copyBuffer(VkBuffer sourceBuffer, VkBuffer destinationBuffer, VkDeviceSize size, VkDeviceSize sourceOffset) const {
 	VkCommandBuffer commandBuffer = commandWrapper->beginRecordingSingleUseTransferCommandBuffer();
 
 	//Setting up the copy informations
 	VkBufferCopy bufferCopy{};
-	bufferCopy.srcOffset = 0;
+	bufferCopy.srcOffset = sourceOffset;
 	bufferCopy.dstOffset = 0;
 	bufferCopy.size = size;
 
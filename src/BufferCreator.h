@@ -14,12 +14,16 @@
 
 #include "QueueFamilyIndices.h"
 #include "Vertex.h"
+#include "ChunkVertex.h"
 #include "CommandWrapper.h"
 #include "UniformBufferObject.h"
 #include "BoxData.h"
+#include "LightGrid.h"
 #include "PointLight.h"
 #include "BigVertex.h"
 #include "WriteBackData.h"
+#include "MemoryAllocator.h"
+#include "MemoryAllocation.h"
 
 #include "vulkan/vulkan.h"
 
@@ -42,8 +46,9 @@ public:
 	 * @param device Handle to the vulkan device, needed for the createBuffer call.
 	 * @param queueFamilyIndices Reference to the queueFamilyIndices, needed to determine which queues have access to the created buffers later.
 	 * @param commandWrapper Reference to the commandWrapper, needed to actually submit the copying of the staging buffers into the result buffers.
+	 * @param memoryAllocator Reference to the memoryAllocator, which the chunk buffers and their staging buffers are sub-allocated from.
 	 */
-	BufferCreator(VkPhysicalDevice const &physicalDevice, VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, CommandWrapper &commandWrapper);
+	BufferCreator(VkPhysicalDevice const &physicalDevice, VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, CommandWrapper &commandWrapper, MemoryAllocator &memoryAllocator);
 
 	~BufferCreator();
 
@@ -67,6 +72,25 @@ public:
 	 */
 	void createIndexBuffer(std::vector<uint32_t> const &indices, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory) const;
 
+	//Same as above, but sub-allocated from the memoryAllocator, used for the chunk buffers if they are not drawn indirect
+	void createVertexBuffer(std::vector<ChunkVertex> const &vertices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation) const;
+
+	void createIndexBuffer(std::vector<uint32_t> const &indices, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation) const;
+
+	void destroyBuffer(VkBuffer &buffer, MemoryAllocation &allocation) const;
+
+	//Empty device local buffer, filled later through the UploadQueue
+	void createDestinationBuffer(VkDeviceSize const bufferSize, VkBufferUsageFlags const bufferUsageFlags, VkBuffer &buffer, MemoryAllocation &allocation) const;
+
+	//Host visible, the data is written directly into allocation.mapped
+	void createStagingBuffer(VkDeviceSize const bufferSize, VkBuffer &stagingBuffer, MemoryAllocation &stagingBufferAllocation) const;
+
+	//Host visible, the draw commands are written directly into allocation.mapped
+	void createIndirectBuffer(VkDeviceSize const bufferSize, VkBuffer &indirectBuffer, MemoryAllocation &indirectBufferAllocation) const;
+
+	//Host visible storage buffer, read by compute shaders and written directly into allocation.mapped
+	void createHostStorageBuffer(VkDeviceSize const bufferSize, VkBuffer &storageBuffer, MemoryAllocation &storageBufferAllocation) const;
+
 	/**
 	 * @brief Creates a uniform buffer object and allocates the neccessary memory.
 	 *
@@ -85,6 +109,9 @@ public:
 
 	void createPointLightBuffer(VkBuffer &pointLightBuffer, VkDeviceMemory &pointLightBufferMemory, std::vector<PointLight> const &pointLights) const;
 
+	//Origin and size of the grid in front of the entries, like the voxel buffer, an empty grid still gets one entry
+	void createLightGridBuffer(VkBuffer &lightGridBuffer, VkDeviceMemory &lightGridBufferMemory, VkDeviceSize &lightGridBufferSize, LightGrid const &lightGrid) const;
+
 	/**
 	 * @brief Creates a buffer for a given texture.
 	 *
@@ -120,6 +147,8 @@ private:
 	 */
 	CommandWrapper *commandWrapper;
 
+	MemoryAllocator *memoryAllocator;
+
 	/**
 	 * @brief Creates a vulkan buffer and allocates the buffer memory.
 	 *
@@ -131,14 +160,20 @@ private:
 	 */
 	void createBuffer(VkDeviceSize const &bufferSize, VkBufferUsageFlags const &bufferUsageFlags, VkMemoryPropertyFlags const &memoryPropertyFlags, VkBuffer &buffer, VkDeviceMemory &bufferMemory) const;
 
+	void createBuffer(VkDeviceSize const &bufferSize, VkBufferUsageFlags const &bufferUsageFlags, VkMemoryPropertyFlags const &memoryPropertyFlags, VkBuffer &buffer, MemoryAllocation &allocation) const;
+
+	//Uploads data through a sub-allocated staging buffer into a new device local buffer
+	void createDeviceLocalBuffer(void const *data, VkDeviceSize const bufferSize, VkBufferUsageFlags const &bufferUsageFlags, VkBuffer &buffer, MemoryAllocation &allocation) const;
+
 	/**
 	 * @brief Copys one buffer into another, using the commandWrapper.
 	 *
 	 * @param sourceBuffer Source buffer which will be copied.
 	 * @param destinationBuffer Destination buffer into which the source buffer will be copied.
 	 * @param size size of the buffer which will be copied.
+	 * @param sourceOffset Offset into the source buffer the copy starts at.
 	 */
-	void copyBuffer(VkBuffer sourceBuffer, VkBuffer destinationBuffer, VkDeviceSize size) const;
+	void copyBuffer(VkBuffer sourceBuffer, VkBuffer destinationBuffer, VkDeviceSize size, VkDeviceSize sourceOffset = 0) const;
 };
 
 #endif // !BUFFERCREATOR_H
@@ -0,0 +1,19 @@
+#ifndef BVHNODE_H
+#define BVHNODE_H
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+
+//Flattened BVH node as read by shaders/compute.comp, laid out for std430
+//Inner nodes have count 0 and their children at leftOrFirst and leftOrFirst + 1, leaves cover count boxes starting at leftOrFirst
+struct BvhNode {
+	glm::vec3 minBound;
+	int32_t leftOrFirst;
+	glm::vec3 maxBound;
+	int32_t count;
+};
+
+static_assert(sizeof(BvhNode) == 32, "BvhNode has to match the std430 layout of shaders/compute.comp");
+
+#endif // !BVHNODE_H
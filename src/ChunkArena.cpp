@@ -0,0 +1,426 @@
+#include "ChunkArena.h"
+#include "Settings.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+ChunkArena::ChunkArena() {}
+
+ChunkArena::ChunkArena(BufferCreator const &bufferCreator, UploadQueue &uploadQueue, VkBuffer const &quadIndexBuffer, bool const multiDrawIndirect, bool const drawIndirectFirstInstance, bool const gpuSectionCulling)
+	: bufferCreator(&bufferCreator), uploadQueue(&uploadQueue), quadIndexBuffer(quadIndexBuffer), multiDrawIndirect(multiDrawIndirect), drawIndirectFirstInstance(drawIndirectFirstInstance), gpuSectionCulling(gpuSectionCulling) {}
+
+ChunkArena::~ChunkArena() {
+	for (size_t i = 0; i < pages.size(); i++) {
+		bufferCreator->destroyBuffer(pages[i].vertexBuffer, pages[i].vertexBufferAllocation);
+		bufferCreator->destroyBuffer(pages[i].indexBuffer, pages[i].indexBufferAllocation);
+	}
+
+	for (size_t i = 0; i < indirectBuffers.size(); i++) {
+		bufferCreator->destroyBuffer(indirectBuffers[i], indirectBufferAllocations[i]);
+	}
+
+	for (size_t i = 0; i < sectionBuffers.size(); i++) {
+		bufferCreator->destroyBuffer(sectionBuffers[i], sectionBufferAllocations[i]);
+		bufferCreator->destroyBuffer(drawBuffers[i], drawBufferAllocations[i]);
+		bufferCreator->destroyBuffer(visibilityBuffers[i], visibilityBufferAllocations[i]);
+	}
+}
+
+void ChunkArena::upload(std::vector<ChunkVertex> const &vertices, std::vector<uint32_t> const &indices, uint32_t const chunkOrigin, glm::vec3 const &minBound, glm::vec3 const &maxBound, ArenaAllocation &allocation, std::function<void()> onComplete) {
+	uint64_t vertexBytes = sizeof(ChunkVertex) * vertices.size();
+	uint64_t indexBytes = sizeof(uint32_t) * indices.size();
+
+	uint32_t indexCount = Settings::SHARED_QUAD_INDICES ? (uint32_t)(vertices.size() / 4 * 6) : (uint32_t)indices.size();
+	uint32_t drawCount = getDrawCount(indexCount);
+
+	uint64_t vertexOffset = 0;
+	uint64_t indexOffset = 0;
+	uint64_t sectionOffset = 0;
+
+	VkBuffer vertexBuffer;
+	VkBuffer indexBuffer;
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+
+		size_t page = 0;
+
+		//First page with room for both the vertices and the indices, a new page if none has
+		for (; page <= pages.size(); page++) {
+			if (page == pages.size()) {
+				createPage();
+			}
+
+			//Aligned to the vertex size, so the byte offset is a whole vertexOffset for the draw command
+			if (!pages[page].vertexRanges.allocate(vertexBytes, sizeof(ChunkVertex), vertexOffset)) {
+				if (page == pages.size() - 1 && pages[page].vertexRanges.getAllocationCount() == 0) {
+					throw std::runtime_error("Chunk mesh is bigger than a chunk arena page");
+				}
+				continue;
+			}
+
+			if (!Settings::SHARED_QUAD_INDICES && !pages[page].indexRanges.allocate(indexBytes, sizeof(uint32_t), indexOffset)) {
+				pages[page].vertexRanges.free(vertexOffset, vertexBytes);
+
+				if (page == pages.size() - 1 && pages[page].indexRanges.getAllocationCount() == 0) {
+					throw std::runtime_error("Chunk mesh is bigger than a chunk arena page");
+				}
+				continue;
+			}
+
+			//A page can also run out of draw slots before its buffers are full
+			if (gpuSectionCulling && !pages[page].sectionRanges.allocate(drawCount, 1, sectionOffset)) {
+				pages[page].vertexRanges.free(vertexOffset, vertexBytes);
+				if (!Settings::SHARED_QUAD_INDICES) {
+					pages[page].indexRanges.free(indexOffset, indexBytes);
+				}
+				continue;
+			}
+
+			break;
+		}
+
+		allocation.page = (uint32_t)page;
+		allocation.vertexOffset = (int32_t)(vertexOffset / sizeof(ChunkVertex));
+		allocation.vertexCount = (uint32_t)vertices.size();
+
+		allocation.firstIndex = Settings::SHARED_QUAD_INDICES ? 0 : (uint32_t)(indexOffset / sizeof(uint32_t));
+		allocation.indexCount = indexCount;
+
+		if (gpuSectionCulling) {
+			allocation.firstSection = (uint32_t)sectionOffset;
+			allocation.sectionCount = drawCount;
+			pages[page].sectionEnd = std::max(pages[page].sectionEnd, allocation.firstSection + allocation.sectionCount);
+		}
+
+		vertexBuffer = pages[page].vertexBuffer;
+		indexBuffer = pages[page].indexBuffer;
+	}
+
+	//The section only becomes visible to the culling pass once its mesh is on the GPU
+	if (gpuSectionCulling) {
+		ArenaAllocation sectionAllocation = allocation;
+		std::function<void()> onUploaded = onComplete;
+
+		onComplete = [this, sectionAllocation, chunkOrigin, minBound, maxBound, onUploaded] {
+			std::vector<VkDrawIndexedIndirectCommand> draws;
+			appendDraws(sectionAllocation, chunkOrigin, draws);
+
+			{
+				std::lock_guard<std::mutex> lockGuard(mutex);
+
+				CullSection *pageSections = sections.data() + (size_t)sectionAllocation.page * Settings::CHUNK_ARENA_PAGE_SECTIONS;
+
+				for (size_t i = 0; i < draws.size(); i++) {
+					CullSection &section = pageSections[sectionAllocation.firstSection + i];
+					section.minBound = glm::vec4(minBound, 1.0f);
+					section.maxBound = glm::vec4(maxBound, 1.0f);
+					section.indexCount = draws[i].indexCount;
+					section.firstIndex = draws[i].firstIndex;
+					section.vertexOffset = draws[i].vertexOffset;
+					section.firstInstance = draws[i].firstInstance;
+				}
+
+				sectionVersion++;
+			}
+
+			if (onUploaded) {
+				onUploaded();
+			}
+		};
+	}
+
+	//The ranges are reserved, so the uploads do not need to hold the arena lock
+	if (Settings::SHARED_QUAD_INDICES) {
+		uploadQueue->upload(vertices.data(), vertexBytes, vertexBuffer, vertexOffset, onComplete);
+	} else {
+		//Batches complete in order, so the callback of the second upload covers both
+		uploadQueue->upload(vertices.data(), vertexBytes, vertexBuffer, vertexOffset, nullptr);
+		uploadQueue->upload(indices.data(), indexBytes, indexBuffer, indexOffset, onComplete);
+	}
+}
+
+void ChunkArena::free(ArenaAllocation &allocation) {
+	if (allocation.indexCount == 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+
+		pages[allocation.page].vertexRanges.free((uint64_t)allocation.vertexOffset * sizeof(ChunkVertex), (uint64_t)allocation.vertexCount * sizeof(ChunkVertex));
+		if (!Settings::SHARED_QUAD_INDICES) {
+			pages[allocation.page].indexRanges.free((uint64_t)allocation.firstIndex * sizeof(uint32_t), (uint64_t)allocation.indexCount * sizeof(uint32_t));
+		}
+
+		if (allocation.sectionCount != 0) {
+			pages[allocation.page].sectionRanges.free(allocation.firstSection, allocation.sectionCount);
+
+			CullSection *pageSections = sections.data() + (size_t)allocation.page * Settings::CHUNK_ARENA_PAGE_SECTIONS;
+			for (uint32_t i = 0; i < allocation.sectionCount; i++) {
+				pageSections[allocation.firstSection + i] = CullSection{};
+			}
+
+			sectionVersion++;
+		}
+	}
+
+	allocation = ArenaAllocation();
+}
+
+void ChunkArena::addDraw(ArenaAllocation const &allocation, uint32_t const chunkOrigin) {
+	if (allocation.indexCount == 0) {
+		return;
+	}
+
+	if (allocation.page >= pageDraws.size()) {
+		pageDraws.resize(allocation.page + 1);
+	}
+
+	appendDraws(allocation, chunkOrigin, pageDraws[allocation.page]);
+}
+
+void ChunkArena::recordDraws(uint32_t const imageIndex, VkCommandBuffer const &commandBuffer, CommandWrapper &commandWrapper) {
+	VkIndexType indexType = Settings::SHARED_QUAD_INDICES ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+	if (gpuSectionCulling) {
+		if (imageIndex >= culledSectionEnds.size()) {
+			return;
+		}
+
+		std::vector<uint32_t> const &sectionEnds = culledSectionEnds[imageIndex];
+
+		for (size_t i = 0; i < sectionEnds.size(); i++) {
+			if (sectionEnds[i] == 0) {
+				continue;
+			}
+
+			VkBuffer vertexBuffer;
+			VkBuffer indexBuffer;
+			{
+				std::lock_guard<std::mutex> lockGuard(mutex);
+				vertexBuffer = pages[i].vertexBuffer;
+				indexBuffer = Settings::SHARED_QUAD_INDICES ? quadIndexBuffer : pages[i].indexBuffer;
+			}
+
+			VkDeviceSize drawOffset = sizeof(VkDrawIndexedIndirectCommand) * i * Settings::CHUNK_ARENA_PAGE_SECTIONS;
+
+			commandWrapper.recordIndirectChunks(commandBuffer, vertexBuffer, indexBuffer, drawBuffers[imageIndex], drawOffset, sectionEnds[i], multiDrawIndirect, indexType);
+		}
+
+		return;
+	}
+
+	size_t drawCount = 0;
+	for (size_t i = 0; i < pageDraws.size(); i++) {
+		drawCount += pageDraws[i].size();
+	}
+
+	if (drawCount == 0) {
+		return;
+	}
+
+	if (!drawIndirectFirstInstance) {
+		for (size_t i = 0; i < pageDraws.size(); i++) {
+			if (pageDraws[i].empty()) {
+				continue;
+			}
+
+			VkBuffer vertexBuffer;
+			VkBuffer indexBuffer;
+			{
+				std::lock_guard<std::mutex> lockGuard(mutex);
+				vertexBuffer = pages[i].vertexBuffer;
+				indexBuffer = Settings::SHARED_QUAD_INDICES ? quadIndexBuffer : pages[i].indexBuffer;
+			}
+
+			commandWrapper.recordDirectChunks(commandBuffer, vertexBuffer, indexBuffer, pageDraws[i].data(), (uint32_t)pageDraws[i].size(), indexType);
+
+			pageDraws[i].clear();
+		}
+
+		return;
+	}
+
+	reserveIndirectBuffer(imageIndex, drawCount);
+
+	VkDrawIndexedIndirectCommand *commands = static_cast<VkDrawIndexedIndirectCommand *>(indirectBufferAllocations[imageIndex].mapped);
+	size_t commandOffset = 0;
+
+	for (size_t i = 0; i < pageDraws.size(); i++) {
+		if (pageDraws[i].empty()) {
+			continue;
+		}
+
+		memcpy(commands + commandOffset, pageDraws[i].data(), sizeof(VkDrawIndexedIndirectCommand) * pageDraws[i].size());
+
+		VkBuffer vertexBuffer;
+		VkBuffer indexBuffer;
+		{
+			std::lock_guard<std::mutex> lockGuard(mutex);
+			vertexBuffer = pages[i].vertexBuffer;
+			indexBuffer = Settings::SHARED_QUAD_INDICES ? quadIndexBuffer : pages[i].indexBuffer;
+		}
+
+		commandWrapper.recordIndirectChunks(commandBuffer, vertexBuffer, indexBuffer, indirectBuffers[imageIndex], sizeof(VkDrawIndexedIndirectCommand) * commandOffset, (uint32_t)pageDraws[i].size(), multiDrawIndirect, indexType);
+
+		commandOffset += pageDraws[i].size();
+		pageDraws[i].clear();
+	}
+}
+
+bool ChunkArena::prepareCulling(uint32_t const imageIndex, bool const occlusionCulling, VkBuffer &sectionBuffer, VkBuffer &drawBuffer, VkBuffer &visibilityBuffer, uint32_t &sectionCount) {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	bool recreated = reserveCullingBuffers(imageIndex, sections.size());
+
+	//Only copied after a section was uploaded or freed, not every frame
+	if (recreated || cullingVersions[imageIndex] != sectionVersion) {
+		memcpy(sectionBufferAllocations[imageIndex].mapped, sections.data(), sizeof(CullSection) * sections.size());
+		cullingVersions[imageIndex] = sectionVersion;
+	}
+
+	if (occlusionCulling) {
+		memset(visibilityBufferAllocations[imageIndex].mapped, 0, sizeof(uint32_t) * (sections.size() / 32));
+	}
+
+	if (imageIndex >= culledSectionEnds.size()) {
+		culledSectionEnds.resize(imageIndex + 1);
+	}
+
+	culledSectionEnds[imageIndex].resize(pages.size());
+	for (size_t i = 0; i < pages.size(); i++) {
+		culledSectionEnds[imageIndex][i] = pages[i].sectionEnd;
+	}
+
+	sectionBuffer = sectionBuffers[imageIndex];
+	drawBuffer = drawBuffers[imageIndex];
+	visibilityBuffer = visibilityBuffers[imageIndex];
+	sectionCount = (uint32_t)sections.size();
+
+	return recreated;
+}
+
+void ChunkArena::markVisible(uint32_t const imageIndex, ArenaAllocation const &allocation) {
+	//Sections of pages created after prepareCulling are not in the buffers of this frame
+	if (allocation.sectionCount == 0 || imageIndex >= culledSectionEnds.size() || allocation.page >= culledSectionEnds[imageIndex].size()) {
+		return;
+	}
+
+	uint32_t *visibleBits = static_cast<uint32_t *>(visibilityBufferAllocations[imageIndex].mapped);
+
+	for (uint32_t i = 0; i < allocation.sectionCount; i++) {
+		uint32_t slot = allocation.page * Settings::CHUNK_ARENA_PAGE_SECTIONS + allocation.firstSection + i;
+		visibleBits[slot / 32] |= 1u << (slot % 32);
+	}
+}
+
+bool ChunkArena::isCullingOnGpu() const {
+	return gpuSectionCulling;
+}
+
+void ChunkArena::createPage() {
+	ArenaPage page;
+
+	bufferCreator->createDestinationBuffer(Settings::CHUNK_ARENA_VERTEX_PAGE_SIZE, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, page.vertexBuffer, page.vertexBufferAllocation);
+	page.vertexRanges = RangeAllocator(Settings::CHUNK_ARENA_VERTEX_PAGE_SIZE);
+
+	if (!Settings::SHARED_QUAD_INDICES) {
+		bufferCreator->createDestinationBuffer(Settings::CHUNK_ARENA_INDEX_PAGE_SIZE, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, page.indexBuffer, page.indexBufferAllocation);
+		page.indexRanges = RangeAllocator(Settings::CHUNK_ARENA_INDEX_PAGE_SIZE);
+	}
+
+	if (gpuSectionCulling) {
+		page.sectionRanges = RangeAllocator(Settings::CHUNK_ARENA_PAGE_SECTIONS);
+		sections.resize(sections.size() + Settings::CHUNK_ARENA_PAGE_SECTIONS, CullSection{});
+	}
+
+	pages.push_back(page);
+}
+
+uint32_t ChunkArena::getDrawCount(uint32_t const indexCount) const {
+	if (!Settings::SHARED_QUAD_INDICES) {
+		return 1;
+	}
+
+	uint32_t quadCount = indexCount / 6;
+
+	return (quadCount + Settings::QUAD_INDEX_BUFFER_QUAD_COUNT - 1) / Settings::QUAD_INDEX_BUFFER_QUAD_COUNT;
+}
+
+void ChunkArena::appendDraws(ArenaAllocation const &allocation, uint32_t const chunkOrigin, std::vector<VkDrawIndexedIndirectCommand> &draws) const {
+	VkDrawIndexedIndirectCommand drawIndexedIndirectCommand{};
+	drawIndexedIndirectCommand.indexCount = allocation.indexCount;
+	drawIndexedIndirectCommand.instanceCount = 1;
+	drawIndexedIndirectCommand.firstIndex = allocation.firstIndex;
+	drawIndexedIndirectCommand.vertexOffset = allocation.vertexOffset;
+	drawIndexedIndirectCommand.firstInstance = chunkOrigin;
+
+	if (!Settings::SHARED_QUAD_INDICES) {
+		draws.push_back(drawIndexedIndirectCommand);
+		return;
+	}
+
+	//The uint16 quad indices only reach Settings::QUAD_INDEX_BUFFER_QUAD_COUNT quads, bigger meshes get one draw per part
+	uint32_t quadCount = allocation.indexCount / 6;
+
+	for (uint32_t firstQuad = 0; firstQuad < quadCount; firstQuad += Settings::QUAD_INDEX_BUFFER_QUAD_COUNT) {
+		drawIndexedIndirectCommand.indexCount = std::min(quadCount - firstQuad, Settings::QUAD_INDEX_BUFFER_QUAD_COUNT) * 6;
+		drawIndexedIndirectCommand.vertexOffset = allocation.vertexOffset + (int32_t)(firstQuad * 4);
+
+		draws.push_back(drawIndexedIndirectCommand);
+	}
+}
+
+void ChunkArena::reserveIndirectBuffer(uint32_t const imageIndex, size_t const drawCount) {
+	if (imageIndex >= indirectBuffers.size()) {
+		indirectBuffers.resize(imageIndex + 1, VK_NULL_HANDLE);
+		indirectBufferAllocations.resize(imageIndex + 1);
+		indirectBufferCapacities.resize(imageIndex + 1, 0);
+	}
+
+	if (drawCount <= indirectBufferCapacities[imageIndex]) {
+		return;
+	}
+
+	size_t capacity = std::max(drawCount, indirectBufferCapacities[imageIndex] * 2);
+	capacity = std::max(capacity, (size_t)256);
+
+	bufferCreator->destroyBuffer(indirectBuffers[imageIndex], indirectBufferAllocations[imageIndex]);
+	bufferCreator->createIndirectBuffer(sizeof(VkDrawIndexedIndirectCommand) * capacity, indirectBuffers[imageIndex], indirectBufferAllocations[imageIndex]);
+
+	indirectBufferCapacities[imageIndex] = capacity;
+}
+
+bool ChunkArena::reserveCullingBuffers(uint32_t const imageIndex, size_t const sectionCount) {
+	if (imageIndex >= sectionBuffers.size()) {
+		sectionBuffers.resize(imageIndex + 1, VK_NULL_HANDLE);
+		sectionBufferAllocations.resize(imageIndex + 1);
+		drawBuffers.resize(imageIndex + 1, VK_NULL_HANDLE);
+		drawBufferAllocations.resize(imageIndex + 1);
+		visibilityBuffers.resize(imageIndex + 1, VK_NULL_HANDLE);
+		visibilityBufferAllocations.resize(imageIndex + 1);
+		cullingCapacities.resize(imageIndex + 1, 0);
+		cullingVersions.resize(imageIndex + 1, 0);
+	}
+
+	//Only grows by whole pages, the descriptors of the image have to be written again afterwards
+	if (sectionCount <= cullingCapacities[imageIndex] && sectionBuffers[imageIndex] != VK_NULL_HANDLE) {
+		return false;
+	}
+
+	size_t capacity = std::max(sectionCount, (size_t)Settings::CHUNK_ARENA_PAGE_SECTIONS);
+
+	bufferCreator->destroyBuffer(sectionBuffers[imageIndex], sectionBufferAllocations[imageIndex]);
+	bufferCreator->destroyBuffer(drawBuffers[imageIndex], drawBufferAllocations[imageIndex]);
+	bufferCreator->destroyBuffer(visibilityBuffers[imageIndex], visibilityBufferAllocations[imageIndex]);
+
+	bufferCreator->createHostStorageBuffer(sizeof(CullSection) * capacity, sectionBuffers[imageIndex], sectionBufferAllocations[imageIndex]);
+	bufferCreator->createDestinationBuffer(sizeof(VkDrawIndexedIndirectCommand) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, drawBuffers[imageIndex], drawBufferAllocations[imageIndex]);
+	bufferCreator->createHostStorageBuffer(sizeof(uint32_t) * (capacity / 32), visibilityBuffers[imageIndex], visibilityBufferAllocations[imageIndex]);
+
+	cullingCapacities[imageIndex] = capacity;
+
+	return true;
+}
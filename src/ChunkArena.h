@@ -0,0 +1,100 @@
+#ifndef CHUNKARENA_H
+#define CHUNKARENA_H
+
+#include "ArenaAllocation.h"
+#include "ArenaPage.h"
+#include "BufferCreator.h"
+#include "CommandWrapper.h"
+#include "UploadQueue.h"
+#include "ChunkVertex.h"
+#include "CullSection.h"
+
+#include "vulkan/vulkan.h"
+
+#include <mutex>
+#include <vector>
+
+//All chunk meshes share a few big vertex and index buffers, so visible chunks are drawn with one indirect draw per page
+//With GPU section culling every page has a fixed range of draw slots, which shaders/cull.comp fills every frame
+class ChunkArena {
+public:
+	ChunkArena();
+	ChunkArena(BufferCreator const &bufferCreator, UploadQueue &uploadQueue, VkBuffer const &quadIndexBuffer, bool const multiDrawIndirect, bool const drawIndirectFirstInstance, bool const gpuSectionCulling);
+	~ChunkArena();
+
+	//Called from the chunk generation tasks, returns before the data is on the GPU and calls onComplete once it is
+	//indices are ignored if Settings::SHARED_QUAD_INDICES is set, the pages then have no index buffers
+	//chunkOrigin and the bounds are only used by the GPU section culling, the section gets culled from the moment its data is on the GPU
+	void upload(std::vector<ChunkVertex> const &vertices, std::vector<uint32_t> const &indices, uint32_t const chunkOrigin, glm::vec3 const &minBound, glm::vec3 const &maxBound, ArenaAllocation &allocation, std::function<void()> onComplete);
+
+	//Does nothing for an empty allocation, resets the allocation afterwards
+	void free(ArenaAllocation &allocation);
+
+	//Only called from the render thread, collects the draws until recordDraws, chunkOrigin becomes the firstInstance of the draw
+	void addDraw(ArenaAllocation const &allocation, uint32_t const chunkOrigin);
+
+	//With GPU section culling all sections are drawn, the culling pass of this frame zeroes the instance count of the invisible ones
+	void recordDraws(uint32_t const imageIndex, VkCommandBuffer const &commandBuffer, CommandWrapper &commandWrapper);
+
+	//Copies the section table into the buffers of the image if it changed since, returns true if the buffers were recreated and need new descriptors
+	//With occlusionCulling the visibility bits of the image are cleared, markVisible sets them again until the frame is submitted
+	bool prepareCulling(uint32_t const imageIndex, bool const occlusionCulling, VkBuffer &sectionBuffer, VkBuffer &drawBuffer, VkBuffer &visibilityBuffer, uint32_t &sectionCount);
+
+	//Only called from the render thread between prepareCulling and the submit of the image
+	void markVisible(uint32_t const imageIndex, ArenaAllocation const &allocation);
+
+	bool isCullingOnGpu() const;
+
+private:
+	BufferCreator const *bufferCreator;
+
+	UploadQueue *uploadQueue;
+
+	VkBuffer quadIndexBuffer;
+
+	bool multiDrawIndirect;
+	bool drawIndirectFirstInstance;
+	bool gpuSectionCulling;
+
+	std::mutex mutex;
+
+	std::vector<ArenaPage> pages;
+
+	std::vector<std::vector<VkDrawIndexedIndirectCommand>> pageDraws;
+
+	//One per swapchain image, only grown after the fence of that image was waited on
+	std::vector<VkBuffer> indirectBuffers;
+	std::vector<MemoryAllocation> indirectBufferAllocations;
+	std::vector<size_t> indirectBufferCapacities;
+
+	//Settings::CHUNK_ARENA_PAGE_SECTIONS slots per page, only changed when a section is uploaded or freed
+	std::vector<CullSection> sections;
+	uint64_t sectionVersion = 0;
+
+	//One per swapchain image like the indirect buffers, the draw buffer is written by the culling pass
+	std::vector<VkBuffer> sectionBuffers;
+	std::vector<MemoryAllocation> sectionBufferAllocations;
+	std::vector<VkBuffer> drawBuffers;
+	std::vector<MemoryAllocation> drawBufferAllocations;
+	std::vector<VkBuffer> visibilityBuffers;
+	std::vector<MemoryAllocation> visibilityBufferAllocations;
+	std::vector<size_t> cullingCapacities;
+	std::vector<uint64_t> cullingVersions;
+
+	//Used draw slots of every page at the time the culling of the image was recorded, pages created later are not in its buffers
+	std::vector<std::vector<uint32_t>> culledSectionEnds;
+
+	void createPage();
+
+	//Number of draws a mesh with indexCount indices needs, more than one if it exceeds the shared quad indices
+	uint32_t getDrawCount(uint32_t const indexCount) const;
+
+	//Appends the draws of the allocation, chunkOrigin becomes their firstInstance
+	void appendDraws(ArenaAllocation const &allocation, uint32_t const chunkOrigin, std::vector<VkDrawIndexedIndirectCommand> &draws) const;
+
+	void reserveIndirectBuffer(uint32_t const imageIndex, size_t const drawCount);
+
+	bool reserveCullingBuffers(uint32_t const imageIndex, size_t const sectionCount);
+};
+
+#endif // !CHUNKARENA_H
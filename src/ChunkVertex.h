@@ -0,0 +1,78 @@
+#ifndef CHUNKVERTEX_H
+#define CHUNKVERTEX_H
+
+#include "Vertex.h"
+#include "Settings.h"
+
+#include "vulkan/vulkan.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+//8 byte chunk vertex, the position is relative to the chunk, its origin comes from gl_InstanceIndex (see packChunkOrigin)
+//positionData: x 6 bit, y 6 bit, z 6 bit corner inside the chunk (0 - 32), normalID 3 bit, ambientOcclusionValue 2 bit, lightLevel 4 bit
+//textureData: textureID 8 bit, texture coordinate s 7 bit, t 7 bit, both biased by 64, so the greedy meshed quads can tile the texture
+struct ChunkVertex {
+	uint32_t positionData;
+	uint32_t textureData;
+
+	//Bits per chunk coordinate in the packed chunk origin, x and z are signed
+	static int const ORIGIN_XZ_BITS = 13;
+	static int const ORIGIN_Y_BITS = 6;
+
+	static int const TEXTURE_COORDINATE_BIAS = 64;
+
+	//Packs a chunk local Vertex, its position is the cube center relative to the chunk, so the corners are at half integers
+	static ChunkVertex pack(Vertex const &vertex) {
+		uint32_t x = (uint32_t)std::lround(vertex.position.x + 0.5f);
+		uint32_t y = (uint32_t)std::lround(vertex.position.y + 0.5f);
+		uint32_t z = (uint32_t)std::lround(vertex.position.z + 0.5f);
+
+		uint32_t s = (uint32_t)(std::lround(vertex.textureCoordinate.s) + TEXTURE_COORDINATE_BIAS);
+		uint32_t t = (uint32_t)(std::lround(vertex.textureCoordinate.t) + TEXTURE_COORDINATE_BIAS);
+
+		ChunkVertex chunkVertex;
+		chunkVertex.positionData = (x & 0x3F) | ((y & 0x3F) << 6) | ((z & 0x3F) << 12) | ((vertex.normalID & 0x7u) << 18) | ((vertex.ambientOcclusionValue & 0x3u) << 21) | ((vertex.lightLevel & 0xFu) << 23);
+		chunkVertex.textureData = vertex.textureID | ((s & 0x7F) << 8) | ((t & 0x7F) << 15);
+
+		return chunkVertex;
+	}
+
+	//Used as firstInstance of the chunk draws, chunk x and z wrap after 2^12 chunks in each direction
+	static uint32_t packChunkOrigin(int const x, int const y, int const z) {
+		uint32_t mask = (1u << ORIGIN_XZ_BITS) - 1;
+
+		return ((uint32_t)x & mask) | (((uint32_t)z & mask) << ORIGIN_XZ_BITS) | (((uint32_t)y & ((1u << ORIGIN_Y_BITS) - 1)) << (2 * ORIGIN_XZ_BITS));
+	}
+
+	static VkVertexInputBindingDescription getVertexInputBindingDescription() {
+		VkVertexInputBindingDescription vertexInputBindingDescription{};
+		vertexInputBindingDescription.binding = 0;
+		vertexInputBindingDescription.stride = sizeof(ChunkVertex);
+		vertexInputBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return vertexInputBindingDescription;
+	}
+
+	static std::array<VkVertexInputAttributeDescription, 2> getVertexInputAttributeDescription() {
+		std::array<VkVertexInputAttributeDescription, 2> vertexInputAttributeDescriptions{};
+
+		vertexInputAttributeDescriptions[0].binding = 0;
+		vertexInputAttributeDescriptions[0].location = 0;
+		vertexInputAttributeDescriptions[0].format = VK_FORMAT_R32_UINT;
+		vertexInputAttributeDescriptions[0].offset = offsetof(ChunkVertex, positionData);
+
+		vertexInputAttributeDescriptions[1].binding = 0;
+		vertexInputAttributeDescriptions[1].location = 1;
+		vertexInputAttributeDescriptions[1].format = VK_FORMAT_R32_UINT;
+		vertexInputAttributeDescriptions[1].offset = offsetof(ChunkVertex, textureData);
+
+		return vertexInputAttributeDescriptions;
+	}
+};
+
+static_assert(sizeof(ChunkVertex) == 8, "ChunkVertex has to stay 8 bytes");
+static_assert(Settings::CHUNK_SIZE < 64, "Chunk local vertex positions are stored in 6 bits");
+
+#endif // !CHUNKVERTEX_H
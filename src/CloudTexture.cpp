@@ -1,5 +1,6 @@
 #include "CloudTexture.h"
 #include "FileWriter.h"
+#include "ThreadPool.h"
 
 #include <iostream>
 #include <filesystem>
@@ -7,8 +8,6 @@
 #include <string>
 #include <sstream>
 
-#include <thread>
-
 CloudTexture::CloudTexture(VkDevice const &device, ImageCreator const &imageCreator)
 	: device(device) {
 	if (!std::filesystem::exists("clouds")) {
@@ -45,55 +44,25 @@ float remap(float oldValue, float oldMin, float oldMax, float newMin, float newM
 }
 
 void CloudTexture::setUpNoise() {
-
-	std::thread first([this] {parallelNoiseRange(0, 16); });
-	std::thread second([this] {parallelNoiseRange(16, 32); });
-	std::thread third([this] {parallelNoiseRange(32, 48); });
-	std::thread fourth([this] {parallelNoiseRange(48, 64); });
-	std::thread fifth([this] {parallelNoiseRange(64, 80); });
-	std::thread sixth([this] {parallelNoiseRange(80, 96); });
-	std::thread seventh([this] {parallelNoiseRange(96, 112); });
-	std::thread eight([this] {parallelNoiseRange(112, 128); });
-
-	/*std::thread first([this] {parallelNoiseRange(0, 32); });
-	std::thread second([this] {parallelNoiseRange(32, 64); });
-	std::thread third([this] {parallelNoiseRange(64, 96); });
-	std::thread fourth([this] {parallelNoiseRange(96, 128); });
-	std::thread fifth([this] {parallelNoiseRange(128, 160); });
-	std::thread sixth([this] {parallelNoiseRange(160, 192); });
-	std::thread seventh([this] {parallelNoiseRange(192, 224); });
-	std::thread eight([this] {parallelNoiseRange(224, 256); });*/
-
-	first.join();
-	second.join();
-	third.join();
-	fourth.join();
-	fifth.join();
-	sixth.join();
-	seventh.join();
-	eight.join();
+	//One z slice per task on the shared pool
+	ThreadPool::getInstance().parallelFor(Settings::cloudTextureSize, [this](int z) {parallelNoiseRange(z, z + 1); });
 }
 
 void CloudTexture::parallelNoiseRange(int start, int end) {
-	float counter = 0.0f;
-
-		for (int z = start; z < end; z++) {
-			for (int y = 0; y < Settings::cloudTextureSize; y++) {
-				for (int x = 0; x < Settings::cloudTextureSize; x++) {
-					glm::vec3 position = glm::vec3(x, y, z) / glm::vec3(Settings::cloudTextureSize);
-
-					int index = x + (y * Settings::cloudTextureSize) + (z * Settings::cloudTextureSize * Settings::cloudTextureSize);
+	for (int z = start; z < end; z++) {
+		for (int y = 0; y < Settings::cloudTextureSize; y++) {
+			for (int x = 0; x < Settings::cloudTextureSize; x++) {
+				glm::vec3 position = glm::vec3(x, y, z) / glm::vec3(Settings::cloudTextureSize);
 
-					noiseValues[0][index] = noise.worley3D(position, 0);/*
-					noiseValues[1][index] = noise.worley3D(position, 1);
-					noiseValues[2][index] = noise.worley3D(position, 2);
-					noiseValues[3][index] = noise.worley3D(position, 3);*/
+				int index = x + (y * Settings::cloudTextureSize) + (z * Settings::cloudTextureSize * Settings::cloudTextureSize);
 
-					std::cout << counter / ((end - start) * Settings::cloudTextureSize * Settings::cloudTextureSize) << std::endl;
-					counter++;
-				}
+				noiseValues[0][index] = noise.worley3D(position, 0);/*
+				noiseValues[1][index] = noise.worley3D(position, 1);
+				noiseValues[2][index] = noise.worley3D(position, 2);
+				noiseValues[3][index] = noise.worley3D(position, 3);*/
 			}
 		}
+	}
 }
 
 float CloudTexture::readNoise(glm::vec3 const &position, int level, float frequency) {
@@ -1,8 +1,56 @@
 
 #include "CommandWrapper.h"
 #include "ComputeSettings.h"
+#include "Settings.h"
+#include "WavefrontStage.h"
 
 #include <stdexcept>
+#include <algorithm>
+
+namespace {
+	//The wavefront stages hand the paths and queue counters on through memory, so every stage waits for the writes of the one before
+	void recordMemoryBarrier(VkCommandBuffer const &commandBuffer, VkPipelineStageFlags const sourceStage, VkAccessFlags const sourceAccess, VkPipelineStageFlags const destinationStage, VkAccessFlags const destinationAccess) {
+		VkMemoryBarrier memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = sourceAccess;
+		memoryBarrier.dstAccessMask = destinationAccess;
+
+		vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	//Empties the queues from firstQueue on, see WavefrontQueueBuffer in shaders/compute.comp, the dispatch of an empty queue runs no work groups
+	void recordQueueReset(VkCommandBuffer const &commandBuffer, VkBuffer const &queueBuffer, uint32_t const firstQueue, uint32_t const queueCount) {
+		static glm::uvec4 const emptyQueues[8] = { glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1), glm::uvec4(0, 0, 1, 1) };
+
+		vkCmdUpdateBuffer(commandBuffer, queueBuffer, sizeof(glm::uvec4) * firstQueue, sizeof(glm::uvec4) * queueCount, emptyQueues);
+	}
+
+	//Offset of the VkDispatchIndirectCommand following the size of the queue
+	VkDeviceSize getQueueDispatchOffset(uint32_t const queue) {
+		return sizeof(glm::uvec4) * queue + sizeof(uint32_t);
+	}
+
+	//Passes of shaders/denoise.comp over the whole image, it shares the layout of the path tracer, so the bound descriptor set stays valid
+	//Recorded after the timestamps of the submission finishing a pass, the tile budget only measures the tracing
+	void recordDenoise(VkCommandBuffer const &commandBuffer, VkPipeline const &denoisePipeline, VkPipelineLayout const &pipelineLayout) {
+		VkAccessFlags shaderAccess = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, denoisePipeline);
+
+		uint32_t groupCountX = (ComputeSettings::COMPUTE_WIDTH + ComputeSettings::groupSizeX - 1) / ComputeSettings::groupSizeX;
+		uint32_t groupCountY = (ComputeSettings::COMPUTE_HEIGHT + ComputeSettings::groupSizeY - 1) / ComputeSettings::groupSizeY;
+
+		for (int iteration = 0; iteration < ComputeSettings::DENOISE_ITERATIONS; iteration++) {
+			//Every pass reads the neighbours written by the tiles or by the pass before
+			recordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess);
+
+			glm::ivec4 denoisePass = glm::ivec4(iteration, 0, 0, 0);
+			vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(denoisePass), &denoisePass);
+
+			vkCmdDispatch(commandBuffer, groupCountX, groupCountY, 1);
+		}
+	}
+}
 
 std::mutex CommandWrapper::mutexCommandPool = std::mutex();
 std::mutex CommandWrapper::mutexQueueSubmit = std::mutex();
@@ -15,6 +63,13 @@ CommandWrapper::CommandWrapper(VkDevice const &device, QueueFamilyIndices const
 	createCommandPool(queueFamilyIndices.transferFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, transferCommandPool);
 	createCommandPool(queueFamilyIndices.computeFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, computeCommandPool);
 	createCommandPool(queueFamilyIndices.graphicsFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, quadCommandPool);
+
+	secondaryCommandPools.resize(Settings::CHUNK_RECORDING_SLICES + 1);
+	secondaryCommandBuffers.resize(secondaryCommandPools.size());
+
+	for (size_t i = 0; i < secondaryCommandPools.size(); i++) {
+		createCommandPool(queueFamilyIndices.graphicsFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, secondaryCommandPools[i]);
+	}
 }
 
 CommandWrapper::~CommandWrapper() {
@@ -22,6 +77,10 @@ CommandWrapper::~CommandWrapper() {
 	vkDestroyCommandPool(device, transferCommandPool, nullptr);
 	vkDestroyCommandPool(device, computeCommandPool, nullptr);
 	vkDestroyCommandPool(device, quadCommandPool, nullptr);
+
+	for (size_t i = 0; i < secondaryCommandPools.size(); i++) {
+		vkDestroyCommandPool(device, secondaryCommandPools[i], nullptr);
+	}
 }
 
 VkCommandBuffer CommandWrapper::beginRecordingSingleUseTransferCommandBuffer() const {
@@ -70,11 +129,20 @@ void CommandWrapper::endRecordingSingleUseTransferCommandBuffer(VkCommandBuffer
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &commandBuffer;
 
+	//Waiting on an own fence instead of the whole queue, so other threads can submit meanwhile
+	VkFenceCreateInfo fenceCreateInfo{};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	VkFence fence;
+	vkCreateFence(device, &fenceCreateInfo, nullptr, &fence);
+
 	{
 		std::lock_guard<std::mutex> lockGuard(mutexQueueSubmit);
-		vkQueueSubmit(queues.transferQueue, 1, &submitInfo, nullptr);
-		vkQueueWaitIdle(queues.transferQueue);
+		vkQueueSubmit(queues.transferQueue, 1, &submitInfo, fence);
 	}
+
+	vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+	vkDestroyFence(device, fence, nullptr);
 	//Submitting the commands to the transfer queue and waiting until the transfer is over
 	//vkQueueSubmit(queues.transferQueue, 1, &submitInfo, nullptr);
 	//vkQueueWaitIdle(queues.transferQueue);
@@ -87,10 +155,14 @@ void CommandWrapper::endRecordingSingleUseTransferCommandBuffer(VkCommandBuffer
 }
 
 void CommandWrapper::createCommandBuffers(size_t const commandBufferCount) {
-	createCommandBuffers(commandBufferCount, commandPool, commandBuffers);
+	createCommandBuffers(commandBufferCount, commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, commandBuffers);
+
+	for (size_t i = 0; i < secondaryCommandPools.size(); i++) {
+		createCommandBuffers(commandBufferCount, secondaryCommandPools[i], VK_COMMAND_BUFFER_LEVEL_SECONDARY, secondaryCommandBuffers[i]);
+	}
 }
 
-void CommandWrapper::startRecordingCommandBuffer(size_t const commandBufferIndex, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer, VkExtent2D const &extent, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet) {
+void CommandWrapper::startRecordingCommandBuffer(size_t const commandBufferIndex) {
 	//Setting up the information needed to start recording into the command buffer
 	VkCommandBufferBeginInfo commandBufferBeginInfo{};
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -100,7 +172,9 @@ void CommandWrapper::startRecordingCommandBuffer(size_t const commandBufferIndex
 	if (vkBeginCommandBuffer(commandBuffers[commandBufferIndex], &commandBufferBeginInfo) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to begin recording command buffer");
 	}
+}
 
+void CommandWrapper::startRenderPass(size_t const commandBufferIndex, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer, VkExtent2D const &extent) {
 	//Setting up the neccessary render pass info
 	VkRenderPassBeginInfo renderPassBeginInfo{};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -114,30 +188,130 @@ void CommandWrapper::startRecordingCommandBuffer(size_t const commandBufferIndex
 	renderPassBeginInfo.clearValueCount = 2;
 	renderPassBeginInfo.pClearValues = clearValue;
 
-	//Starts a new render pass
-	vkCmdBeginRenderPass(commandBuffers[commandBufferIndex], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-	vkCmdBindPipeline(commandBuffers[commandBufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	//Starts a new render pass, its draws come from the secondary command buffers
+	vkCmdBeginRenderPass(commandBuffers[commandBufferIndex], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+void CommandWrapper::recordSectionCulling(size_t const commandBufferIndex, VkPipeline const &cullPipeline, VkPipelineLayout const &cullPipelineLayout, VkDescriptorSet const &descriptorSet, SectionCullData const &sectionCullData) {
+	VkCommandBuffer commandBuffer = commandBuffers[commandBufferIndex];
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+	vkCmdPushConstants(commandBuffer, cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SectionCullData), &sectionCullData);
 
-	vkCmdBindDescriptorSets(commandBuffers[commandBufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+	vkCmdDispatch(commandBuffer, (sectionCullData.sectionCount + Settings::SECTION_CULLING_GROUP_SIZE - 1) / Settings::SECTION_CULLING_GROUP_SIZE, 1, 1);
+
+	//The indirect draws inside the render pass read the commands written by the dispatch
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+VkCommandBuffer CommandWrapper::startRecordingSecondaryCommandBuffer(size_t const commandBufferIndex, size_t const slot, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer) {
+	VkCommandBuffer commandBuffer = secondaryCommandBuffers[slot][commandBufferIndex];
+
+	//The secondary command buffer continues the render pass of the primary one
+	VkCommandBufferInheritanceInfo commandBufferInheritanceInfo{};
+	commandBufferInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	commandBufferInheritanceInfo.renderPass = renderPass;
+	commandBufferInheritanceInfo.subpass = 0;
+	commandBufferInheritanceInfo.framebuffer = framebuffer;
+
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = &commandBufferInheritanceInfo;
+
+	if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin recording secondary command buffer");
+	}
+
+	return commandBuffer;
+}
+
+void CommandWrapper::endRecordingSecondaryCommandBuffer(VkCommandBuffer const &commandBuffer) {
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to record secondary command buffer");
+	}
+}
+
+size_t CommandWrapper::getSecondaryCommandBufferSlotCount() const {
+	return secondaryCommandPools.size();
+}
+
+void CommandWrapper::recordChunk(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, uint32_t const indexCount, uint32_t const firstInstance) {
+	VkBuffer vertexBuffers[] = { vertexBuffer };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+	vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, firstInstance);
 }
 
-void CommandWrapper::recordChunk(size_t const commandBufferIndex, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, uint32_t const indexCount) {
+void CommandWrapper::recordIndirectChunks(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, VkBuffer const &indirectBuffer, VkDeviceSize const indirectOffset, uint32_t const drawCount, bool const multiDrawIndirect, VkIndexType const indexType) {
 	VkBuffer vertexBuffers[] = { vertexBuffer };
 	VkDeviceSize offsets[] = { 0 };
-	vkCmdBindVertexBuffers(commandBuffers[commandBufferIndex], 0, 1, vertexBuffers, offsets);
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
 
-	vkCmdBindIndexBuffer(commandBuffers[commandBufferIndex], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
 
-	vkCmdDrawIndexed(commandBuffers[commandBufferIndex], indexCount, 1, 0, 0, 0);
+	if (multiDrawIndirect) {
+		vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, indirectOffset, drawCount, stride);
+	} else {
+		//Without the multiDrawIndirect feature the draw count has to be 1, but the buffers still stay bound
+		for (uint32_t i = 0; i < drawCount; i++) {
+			vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, indirectOffset + (VkDeviceSize)i * stride, 1, stride);
+		}
+	}
 }
 
-void CommandWrapper::changeShader(size_t const commandBufferIndex, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet) {
-	vkCmdBindPipeline(commandBuffers[commandBufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+void CommandWrapper::recordDirectChunks(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, VkDrawIndexedIndirectCommand const *draws, uint32_t const drawCount, VkIndexType const indexType) {
+	VkBuffer vertexBuffers[] = { vertexBuffer };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
 
-	vkCmdBindDescriptorSets(commandBuffers[commandBufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+	for (uint32_t i = 0; i < drawCount; i++) {
+		vkCmdDrawIndexed(commandBuffer, draws[i].indexCount, draws[i].instanceCount, draws[i].firstIndex, draws[i].vertexOffset, draws[i].firstInstance);
+	}
+}
+
+void CommandWrapper::recordQuadChunk(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &quadIndexBuffer, uint32_t const quadCount, uint32_t const firstInstance) {
+	VkBuffer vertexBuffers[] = { vertexBuffer };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	vkCmdBindIndexBuffer(commandBuffer, quadIndexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+	//The uint16 indices only reach Settings::QUAD_INDEX_BUFFER_QUAD_COUNT quads, the vertexOffset moves on to the next ones
+	for (uint32_t firstQuad = 0; firstQuad < quadCount; firstQuad += Settings::QUAD_INDEX_BUFFER_QUAD_COUNT) {
+		uint32_t drawQuadCount = std::min(quadCount - firstQuad, Settings::QUAD_INDEX_BUFFER_QUAD_COUNT);
+
+		vkCmdDrawIndexed(commandBuffer, drawQuadCount * 6, 1, 0, (int32_t)(firstQuad * 4), firstInstance);
+	}
+}
+
+void CommandWrapper::changeShader(VkCommandBuffer const &commandBuffer, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet) {
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
 }
 
 void CommandWrapper::endRecordingCommandBuffer(size_t const commandBufferIndex) {
+	std::vector<VkCommandBuffer> slotCommandBuffers(secondaryCommandBuffers.size());
+	for (size_t i = 0; i < secondaryCommandBuffers.size(); i++) {
+		slotCommandBuffers[i] = secondaryCommandBuffers[i][commandBufferIndex];
+	}
+
+	vkCmdExecuteCommands(commandBuffers[commandBufferIndex], static_cast<uint32_t>(slotCommandBuffers.size()), slotCommandBuffers.data());
+
 	vkCmdEndRenderPass(commandBuffers[commandBufferIndex]);
 
 	//Ends recording into the command buffer
@@ -151,6 +325,11 @@ void CommandWrapper::freeCommandBuffers() {
 		//std::lock_guard<std::mutex> lockGuard(CommandWrapper::mutexCommandPool);
 		vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
 		vkResetCommandPool(device, commandPool, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT);
+
+		for (size_t i = 0; i < secondaryCommandPools.size(); i++) {
+			vkFreeCommandBuffers(device, secondaryCommandPools[i], static_cast<uint32_t>(secondaryCommandBuffers[i].size()), secondaryCommandBuffers[i].data());
+			vkResetCommandPool(device, secondaryCommandPools[i], VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT);
+		}
 	}
 }
 
@@ -170,7 +349,7 @@ void CommandWrapper::createComputeCommandBuffer() {
 	}
 }
 
-void CommandWrapper::recordComputeCommandBuffer(VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet) {
+void CommandWrapper::recordComputeCommandBuffer(VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet, std::vector<uint32_t> const &tiles, VkQueryPool const &timestampQueryPool, VkPipeline const &denoisePipeline) {
 	VkCommandBufferBeginInfo computeCommandBufferBeginInfo{};
 	computeCommandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
@@ -180,16 +359,129 @@ void CommandWrapper::recordComputeCommandBuffer(VkPipeline const &pipeline, VkPi
 		vkBeginCommandBuffer(computeCommandBuffer, &computeCommandBufferBeginInfo);
 	}
 
+	if (timestampQueryPool != VK_NULL_HANDLE) {
+		vkCmdResetQueryPool(computeCommandBuffer, timestampQueryPool, 0, 2);
+		vkCmdWriteTimestamp(computeCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampQueryPool, 0);
+	}
+
 	vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 	vkCmdBindDescriptorSets(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, 0);
 
-	vkCmdDispatch(computeCommandBuffer, ComputeSettings::COMPUTE_WIDTH / ComputeSettings::groupSizeX, ComputeSettings::COMPUTE_HEIGHT / ComputeSettings::groupSizeY, 1);
+	uint32_t tileSize = ComputeSettings::PHOTO_MODE_TILE_SIZE;
+	uint32_t tilesX = (ComputeSettings::COMPUTE_WIDTH + tileSize - 1) / tileSize;
+
+	//The tiles write disjoint pixels, so the dispatches need no barriers in between
+	for (size_t i = 0; i < tiles.size(); i++) {
+		//Offset of the tile in x and y, its index in z, w is only used by the wavefront stages
+		glm::ivec4 tile = glm::ivec4(glm::ivec2(tiles[i] % tilesX, tiles[i] / tilesX) * (int)tileSize, (int)tiles[i], 0);
+		vkCmdPushConstants(computeCommandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(tile), &tile);
+
+		uint32_t width = std::min(tileSize, (uint32_t)(ComputeSettings::COMPUTE_WIDTH - tile.x));
+		uint32_t height = std::min(tileSize, (uint32_t)(ComputeSettings::COMPUTE_HEIGHT - tile.y));
+
+		vkCmdDispatch(computeCommandBuffer, (width + ComputeSettings::groupSizeX - 1) / ComputeSettings::groupSizeX, (height + ComputeSettings::groupSizeY - 1) / ComputeSettings::groupSizeY, 1);
+	}
+
+	if (timestampQueryPool != VK_NULL_HANDLE) {
+		vkCmdWriteTimestamp(computeCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, 1);
+	}
+
+	if (denoisePipeline != VK_NULL_HANDLE) {
+		recordDenoise(computeCommandBuffer, denoisePipeline, pipelineLayout);
+	}
+
+	vkEndCommandBuffer(computeCommandBuffer);
+}
+
+void CommandWrapper::recordWavefrontCommandBuffer(std::vector<VkPipeline> const &pipelines, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet, std::vector<uint32_t> const &tiles, VkBuffer const &queueBuffer, VkQueryPool const &timestampQueryPool, VkPipeline const &denoisePipeline) {
+	VkCommandBufferBeginInfo computeCommandBufferBeginInfo{};
+	computeCommandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	{
+		std::lock_guard<std::mutex> lockGuard(CommandWrapper::mutexCommandPool);
+		//Starts recording into the compute command buffer
+		vkBeginCommandBuffer(computeCommandBuffer, &computeCommandBufferBeginInfo);
+	}
+
+	if (timestampQueryPool != VK_NULL_HANDLE) {
+		vkCmdResetQueryPool(computeCommandBuffer, timestampQueryPool, 0, 2);
+		vkCmdWriteTimestamp(computeCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampQueryPool, 0);
+	}
+
+	//The stages share the layout, so the descriptor set and push constants stay bound across the pipelines
+	vkCmdBindDescriptorSets(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, 0);
+
+	uint32_t tileSize = ComputeSettings::PHOTO_MODE_TILE_SIZE;
+	uint32_t tilesX = (ComputeSettings::COMPUTE_WIDTH + tileSize - 1) / tileSize;
+
+	//Generating and accumulating runs over the whole tile, the stages between only get the work groups their queue was filled for
+	uint32_t groupCountX = tileSize / ComputeSettings::groupSizeX;
+	uint32_t groupCountY = tileSize / ComputeSettings::groupSizeY;
+
+	VkAccessFlags shaderAccess = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+	//The queue counters written by a stage are read as dispatch by the stages after it
+	VkPipelineStageFlags queueStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	VkAccessFlags queueAccess = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | shaderAccess;
+
+	for (size_t i = 0; i < tiles.size(); i++) {
+		glm::ivec4 tile = glm::ivec4(glm::ivec2(tiles[i] % tilesX, tiles[i] / tilesX) * (int)tileSize, (int)tiles[i], 0);
+		vkCmdPushConstants(computeCommandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(tile), &tile);
+
+		//The paths and queues of the tile before are done with
+		recordMemoryBarrier(computeCommandBuffer, queueStages, queueAccess, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT | shaderAccess);
+		recordQueueReset(computeCommandBuffer, queueBuffer, 0, 8);
+		recordMemoryBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, queueStages, queueAccess);
+
+		vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[GENERATE]);
+		vkCmdDispatch(computeCommandBuffer, groupCountX, groupCountY, 1);
+
+		for (uint32_t bounce = 0; bounce < ComputeSettings::WAVEFRONT_BOUNCES; bounce++) {
+			tile.w = (int)bounce;
+			vkCmdPushConstants(computeCommandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(tile), &tile);
+
+			//Clears the ray queue of the next bounce and the material and shadow queues, see RAY_QUEUE in shaders/compute.comp
+			recordMemoryBarrier(computeCommandBuffer, queueStages, queueAccess, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT | shaderAccess);
+			recordQueueReset(computeCommandBuffer, queueBuffer, (bounce + 1) % 2, 1);
+			recordQueueReset(computeCommandBuffer, queueBuffer, 2, 4);
+			recordMemoryBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, queueStages, queueAccess);
+
+			vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[EXTEND]);
+			vkCmdDispatchIndirect(computeCommandBuffer, queueBuffer, getQueueDispatchOffset(bounce % 2));
+
+			recordMemoryBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess, queueStages, queueAccess);
+
+			//Each material works on its own paths, so the shading stages may overlap
+			for (int stage = SHADE_SKY; stage <= SHADE_LAMBERTIAN; stage++) {
+				vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[stage]);
+				vkCmdDispatchIndirect(computeCommandBuffer, queueBuffer, getQueueDispatchOffset(2 + stage - SHADE_SKY));
+			}
+
+			recordMemoryBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess, queueStages, queueAccess);
+
+			vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[SHADOW]);
+			vkCmdDispatchIndirect(computeCommandBuffer, queueBuffer, getQueueDispatchOffset(5));
+		}
+
+		recordMemoryBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderAccess);
+
+		vkCmdBindPipeline(computeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[ACCUMULATE]);
+		vkCmdDispatch(computeCommandBuffer, groupCountX, groupCountY, 1);
+	}
+
+	if (timestampQueryPool != VK_NULL_HANDLE) {
+		vkCmdWriteTimestamp(computeCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, 1);
+	}
+
+	if (denoisePipeline != VK_NULL_HANDLE) {
+		recordDenoise(computeCommandBuffer, denoisePipeline, pipelineLayout);
+	}
 
 	vkEndCommandBuffer(computeCommandBuffer);
 }
 
 void CommandWrapper::createQuadCommandBuffers(size_t const commandBufferCount) {
-	createCommandBuffers(commandBufferCount, quadCommandPool, quadCommandBuffers);
+	createCommandBuffers(commandBufferCount, quadCommandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, quadCommandBuffers);
 }
 
 void CommandWrapper::recordQuadCommandBuffers(size_t const commandBufferIndex, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer, VkExtent2D const &extent, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet, VkImage const &image, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer) {
@@ -266,14 +558,14 @@ void CommandWrapper::createCommandPool(uint32_t const queueFamilyIndex, VkComman
 	}
 }
 
-void CommandWrapper::createCommandBuffers(size_t const commandBufferCount, VkCommandPool const &commandPool, std::vector<VkCommandBuffer> &commandBuffers) {
+void CommandWrapper::createCommandBuffers(size_t const commandBufferCount, VkCommandPool const &commandPool, VkCommandBufferLevel const commandBufferLevel, std::vector<VkCommandBuffer> &commandBuffers) {
 	commandBuffers.resize(commandBufferCount);
 
 	//Creating the command buffer allocate info struct, which will be passed as argument to the allocateCommandBuffers call
 	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
 	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	commandBufferAllocateInfo.commandPool = commandPool;
-	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.level = commandBufferLevel;
 	commandBufferAllocateInfo.commandBufferCount = static_cast<uint32_t>(commandBufferCount);
 
 	{
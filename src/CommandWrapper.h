@@ -14,6 +14,7 @@
 
 #include "QueueFamilyIndices.h"
 #include "Queues.h"
+#include "SectionCullData.h"
 
 #include "vulkan/vulkan.h"
 
@@ -73,34 +74,107 @@ public:
 	void createCommandBuffers(size_t const commandBufferCount);
 
 	/**
-	 * @brief Starts recording into the command buffer used for rendering.
+	 * @brief Starts recording into the command buffer used for rendering, work outside of the render pass can be recorded until startRenderPass.
+	 *
+	 * @param commandBufferIndex Index of the command buffer which should be recorded in.
+	 */
+	void startRecordingCommandBuffer(size_t const commandBufferIndex);
+
+	/**
+	 * @brief Starts the render pass in the command buffer used for rendering.
+	 *
+	 * The render pass only executes the secondary command buffers, all draws are recorded into those.
 	 *
 	 * @param commandBufferIndex Index of the command buffer which should be recorded in.
 	 * @param renderPass Renderpass used in the recording to start a render pass.
 	 * @param framebuffer Framebuffer of the used swapchain image.
 	 * @param extent Swapchain extent.
-	 * @param pipeline Used pipeline for the rendering.
-	 * @param pipelineLayout Layout of the used pipeline.
-	 * @param descriptorSet Descriptor set to use for this render pass.
 	 */
-	void startRecordingCommandBuffer(size_t const commandBufferIndex, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer, VkExtent2D const &extent, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet);
+	void startRenderPass(size_t const commandBufferIndex, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer, VkExtent2D const &extent);
 
 	/**
-	 * @brief Records the drawIndexed commands for a chunk with the given data.
+	 * @brief Records the dispatch of the section culling compute shader, followed by a barrier for the indirect draws reading its output.
+	 *
+	 * Has to be recorded before the render pass starts.
 	 *
 	 * @param commandBufferIndex Index of the command buffer which should be recorded in.
+	 * @param cullPipeline Compute pipeline of shaders/cull.comp.
+	 * @param cullPipelineLayout Layout of the cullPipeline, the sectionCullData is pushed as push constants.
+	 * @param descriptorSet Binds the section buffer and the draw buffer of the image.
+	 * @param sectionCullData Frustum planes and number of section slots to cull.
+	 */
+	void recordSectionCulling(size_t const commandBufferIndex, VkPipeline const &cullPipeline, VkPipelineLayout const &cullPipelineLayout, VkDescriptorSet const &descriptorSet, SectionCullData const &sectionCullData);
+
+	/**
+	 * @brief Starts recording into one secondary command buffer of the render pass, every slot can be recorded on its own thread.
+	 *
+	 * @param commandBufferIndex Index of the swapchain image the secondary command buffer belongs to.
+	 * @param slot Slot of the secondary command buffer, smaller than getSecondaryCommandBufferSlotCount.
+	 * @param renderPass Renderpass the secondary command buffer continues.
+	 * @param framebuffer Framebuffer of the used swapchain image.
+	 * @return VkCommandBuffer The secondary command buffer in which will be used for recording.
+	 */
+	VkCommandBuffer startRecordingSecondaryCommandBuffer(size_t const commandBufferIndex, size_t const slot, VkRenderPass const &renderPass, VkFramebuffer const &framebuffer);
+
+	void endRecordingSecondaryCommandBuffer(VkCommandBuffer const &commandBuffer);
+
+	//Settings::CHUNK_RECORDING_SLICES slots for the chunk slices and one for the arena draws and the sky
+	size_t getSecondaryCommandBufferSlotCount() const;
+
+	/**
+	 * @brief Records the drawIndexed commands for a chunk with the given data.
+	 *
+	 * @param commandBuffer Primary or secondary command buffer which should be recorded in.
 	 * @param vertexBuffer Contains the vertices which are used in the draw command.
 	 * @param indexBuffer Contains the indices for the triangle creation.
 	 * @param indexCount Number of indices in the indexBuffer.
+	 * @param firstInstance Packed chunk origin for chunk meshes, 0 for everything else.
 	 */
-	void recordChunk(size_t const commandBufferIndex, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, uint32_t const indexCount);
+	void recordChunk(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, uint32_t const indexCount, uint32_t const firstInstance);
 
-	void changeShader(size_t const commandBufferIndex, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet);
+	/**
+	 * @brief Records the indirect draw commands for all chunks inside one chunk arena page.
+	 *
+	 * @param commandBuffer Primary or secondary command buffer which should be recorded in.
+	 * @param vertexBuffer Vertex buffer of the arena page.
+	 * @param indexBuffer Index buffer of the arena page.
+	 * @param indirectBuffer Contains the VkDrawIndexedIndirectCommands of the visible chunks.
+	 * @param indirectOffset Byte offset of the first draw command of this page in the indirectBuffer.
+	 * @param drawCount Number of draw commands for this page.
+	 * @param multiDrawIndirect If the device supports more than one draw per vkCmdDrawIndexedIndirect call.
+	 * @param indexType VK_INDEX_TYPE_UINT16 for the shared quad index buffer, VK_INDEX_TYPE_UINT32 for the index buffer of the page.
+	 */
+	void recordIndirectChunks(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, VkBuffer const &indirectBuffer, VkDeviceSize const indirectOffset, uint32_t const drawCount, bool const multiDrawIndirect, VkIndexType const indexType);
+
+	/**
+	 * @brief Records the draw commands of one chunk arena page as direct draws, used if the device does not support drawIndirectFirstInstance.
+	 *
+	 * @param commandBuffer Primary or secondary command buffer which should be recorded in.
+	 * @param vertexBuffer Vertex buffer of the arena page.
+	 * @param indexBuffer Index buffer of the arena page.
+	 * @param draws Draw commands of the visible chunks of this page.
+	 * @param drawCount Number of draw commands for this page.
+	 * @param indexType VK_INDEX_TYPE_UINT16 for the shared quad index buffer, VK_INDEX_TYPE_UINT32 for the index buffer of the page.
+	 */
+	void recordDirectChunks(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &indexBuffer, VkDrawIndexedIndirectCommand const *draws, uint32_t const drawCount, VkIndexType const indexType);
+
+	/**
+	 * @brief Records the drawIndexed commands for a chunk using the shared uint16 quad index buffer.
+	 *
+	 * @param commandBuffer Primary or secondary command buffer which should be recorded in.
+	 * @param vertexBuffer Contains the vertices of the chunk, four per quad.
+	 * @param quadIndexBuffer Shared index pattern of Settings::QUAD_INDEX_BUFFER_QUAD_COUNT quads.
+	 * @param quadCount Number of quads of the chunk, split into several draws if the index buffer is too short.
+	 * @param firstInstance Packed chunk origin.
+	 */
+	void recordQuadChunk(VkCommandBuffer const &commandBuffer, VkBuffer const &vertexBuffer, VkBuffer const &quadIndexBuffer, uint32_t const quadCount, uint32_t const firstInstance);
+
+	void changeShader(VkCommandBuffer const &commandBuffer, VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet);
 
 	//void recordObjChunk();
 
 	/**
-	 * @brief Ends the recording in the specified commandBuffer.
+	 * @brief Executes the secondary command buffers of all slots in order and ends the recording in the specified commandBuffer.
 	 *
 	 * @param commandBufferIndex Index of the command buffer which should be recorded in.
 	 */
@@ -116,7 +190,14 @@ public:
 
 	void createComputeCommandBuffer();
 
-	void recordComputeCommandBuffer(VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet);
+	//Traces the given tiles, numbered in rows from the top left, see ComputeSettings::PHOTO_MODE_TILE_SIZE
+	//Timestamps 0 and 1 of the query pool enclose the dispatches if it is not VK_NULL_HANDLE
+	//The denoiser runs over the whole image after the tiles if its pipeline is not VK_NULL_HANDLE
+	void recordComputeCommandBuffer(VkPipeline const &pipeline, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet, std::vector<uint32_t> const &tiles, VkQueryPool const &timestampQueryPool, VkPipeline const &denoisePipeline);
+
+	//Same as above with the wavefront stages, indexed by WavefrontStage, run over one tile after another
+	//Each bounce resets the queue counters it fills in the queue buffer, the stages popping a queue are dispatched indirectly from its counter without reading it back
+	void recordWavefrontCommandBuffer(std::vector<VkPipeline> const &pipelines, VkPipelineLayout const &pipelineLayout, VkDescriptorSet const &descriptorSet, std::vector<uint32_t> const &tiles, VkBuffer const &queueBuffer, VkQueryPool const &timestampQueryPool, VkPipeline const &denoisePipeline);
 
 	std::vector<VkCommandBuffer> quadCommandBuffers;
 
@@ -150,6 +231,12 @@ private:
 
 	VkCommandPool quadCommandPool;
 
+	//One pool per slot, so the slots can be recorded on different threads
+	std::vector<VkCommandPool> secondaryCommandPools;
+
+	//Indexed by slot and then by swapchain image
+	std::vector<std::vector<VkCommandBuffer>> secondaryCommandBuffers;
+
 	/**
 	 * @brief Creates a command pool.
 	 *
@@ -159,7 +246,7 @@ private:
 	 */
 	void createCommandPool(uint32_t const queueFamilyIndex, VkCommandPoolCreateFlags const commandPoolCreateFlags, VkCommandPool &commandPool);
 
-	void createCommandBuffers(size_t const commandBufferCount, VkCommandPool const &commandPool, std::vector<VkCommandBuffer> &commandBuffers);
+	void createCommandBuffers(size_t const commandBufferCount, VkCommandPool const &commandPool, VkCommandBufferLevel const commandBufferLevel, std::vector<VkCommandBuffer> &commandBuffers);
 };
 
 #endif // !COMMANDWRAPPER_H
\ No newline at end of file
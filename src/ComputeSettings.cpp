@@ -12,9 +12,21 @@ int ComputeSettings::oldScaling = 1;
 
 int ComputeSettings::oldCamera = 0;
 
+int ComputeSettings::oldFlags = 0;
+
 BenchmarkStatus ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
 
 uint64_t ComputeSettings::benchmarkMaxIterations = 256;
 double ComputeSettings::benchmarkMaxTime = 10000;
+double const ComputeSettings::BENCHMARK_CONVERGED_SHARE = 0.99;
+
+WriteBackData ComputeSettings::writeBackData = { glm::ivec4(0) };
+
+bool ComputeSettings::renderCpuReference = false;
+
+double const ComputeSettings::PHOTO_MODE_FRAME_BUDGET = 8.0;
+
+bool ComputeSettings::adaptiveSampling = false;
+float const ComputeSettings::CONVERGENCE_THRESHOLD = 0.02f;
 
-WriteBackData ComputeSettings::writeBackData = { glm::ivec4(0) };
\ No newline at end of file
+bool ComputeSettings::denoise = false;
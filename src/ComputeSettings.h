@@ -1,8 +1,9 @@
 #ifndef COMPUTESETTINGS_H
-#define COMPUTESETTING_H
+#define COMPUTESETTINGS_H
 
 #include "BenchmarkStatus.h"
 #include "WriteBackData.h"
+#include "ShaderDirectory.h"
 
 #include "glm/glm.hpp"
 
@@ -13,13 +14,55 @@ public:
 	static int COMPUTE_WIDTH;
 	static int COMPUTE_HEIGHT;
 
-	static constexpr char const COMPUTE_VERTEX_SHADER_PATH[] = "shaders/compute.vert.spv";
-	static constexpr char const COMPUTE_FRAGMENT_SHADER_PATH[] = "shaders/compute.frag.spv";
-	static constexpr char const COMPUTE_SHADER_PATH[] = "shaders/compute.comp.spv";
+	static constexpr char const COMPUTE_VERTEX_SHADER_PATH[] = SHADER_DIRECTORY "compute.vert.spv";
+	static constexpr char const COMPUTE_FRAGMENT_SHADER_PATH[] = SHADER_DIRECTORY "compute.frag.spv";
+	static constexpr char const COMPUTE_SHADER_PATH[] = SHADER_DIRECTORY "compute.comp.spv";
 
 	static uint32_t const groupSizeX = 32;
 	static uint32_t const groupSizeY = 32;
 
+	//The photo mode traces the image in tiles of this many pixels, a multiple of the group sizes, has to match PHOTO_MODE_TILE_SIZE of shaders/compute.comp
+	//Each frame gets as many tiles as fit in the budget in milliseconds of GPU time, the image is presented meanwhile
+	//Without progressive rendering every frame waits for a sample over the whole image like the benchmarks do
+	static bool const PHOTO_MODE_PROGRESSIVE = true;
+	static uint32_t const PHOTO_MODE_TILE_SIZE = 128;
+	static double const PHOTO_MODE_FRAME_BUDGET;
+
+	//Every pixel tracks the mean and variance of its samples in a float buffer, a pixel is converged once the standard error of its luminance falls below the threshold relative to it
+	//Adaptive sampling skips converged pixels and tiles and gives the noisy ones up to ADAPTIVE_MAX_SAMPLES samples per dispatch, toggled by the V key
+	static bool adaptiveSampling;
+	static float const CONVERGENCE_THRESHOLD;
+	//Has to match ADAPTIVE_MIN_SAMPLES of shaders/compute.comp
+	static int const ADAPTIVE_MIN_SAMPLES = 16;
+	static int const ADAPTIVE_MAX_SAMPLES = 4;
+
+	//Edge aware a-trous filter of shaders/denoise.comp over the accumulated mean, guided by normal, plane and albedo of the first hit, toggled by the X key
+	//Only the image shows the filtered mean, the accumulation and the adaptive sampling keep working on the samples
+	static bool denoise;
+	static constexpr char const DENOISE_SHADER_PATH[] = SHADER_DIRECTORY "denoise.comp.spv";
+	//Pass i reads taps 2^i pixels apart, see Denoiser for the CPU version of the filter
+	static int const DENOISE_ITERATIONS = 5;
+
+	//Flags of iData.w, WAVEFRONT_FLAG traces WAVEFRONT_INTEGRATOR with the wavefront stages of WavefrontStage.h instead of the megakernel, toggled by the N key
+	//Every bounce of a tile takes one dispatch per stage, so all threads of a shading dispatch run the code of the same material
+	static int const WAVEFRONT_FLAG = 1;
+	//Samples the lights uniformly instead of from the cell of the light grid, toggled by the L key
+	static int const UNIFORM_LIGHTS_FLAG = 2;
+	static int const WAVEFRONT_INTEGRATOR = 9;
+	//Enough for the longest path of pathTraceNEEIntegrator in shaders/compute.comp
+	static uint32_t const WAVEFRONT_BOUNCES = 11;
+
+	//The light grid stores the LIGHT_GRID_CELL_LIGHTS strongest lights of the cells within LIGHT_GRID_RADIUS cells, see LightGridBuilder
+	static int const LIGHT_GRID_CELL_SIZE = 16;
+	//Has to match LIGHT_GRID_CELL_LIGHTS of shaders/compute.comp
+	static int const LIGHT_GRID_CELL_LIGHTS = 16;
+	static int const LIGHT_GRID_RADIUS = 2;
+
+	//Traces the rays through a voxel grid of the loaded chunks instead of the BVH over the visible boxes
+	static bool const VOXEL_TRACING = true;
+	//Has to match VOXEL_BRICK_SIZE of shaders/compute.comp, divides Settings::CHUNK_SIZE
+	static int const VOXEL_BRICK_SIZE = 8;
+
 	static glm::vec4 sensorData;
 
 	static glm::ivec4 iData;
@@ -32,14 +75,27 @@ public:
 	static int oldCamera;
 	static int const cameraCount = 3;
 
+	//iData.w of the accumulated samples, the flags change the integrator just like iData.x does
+	static int oldFlags;
+
 	static BenchmarkStatus benchmarkStatus;
 
 	static int const benchmarkStartIntegrator = 5;
 	static uint64_t benchmarkMaxIterations;
 	static double benchmarkMaxTime;
+	//The benchmarks report the time until this share of the pixels is converged
+	static double const BENCHMARK_CONVERGED_SHARE;
 
 	static WriteBackData writeBackData;
 
+	//Renders the current photo mode view once with the CPU reference path tracer, set by the R key
+	static bool renderCpuReference;
+	static int const CPU_REFERENCE_SAMPLES = 64;
+	static constexpr char const CPU_REFERENCE_IMAGE_PATH[] = "cpu_reference.ppm";
+	//With the denoiser on and always with "TerraMater --reference", a render with few samples is also filtered by Denoiser and compared against the reference
+	static int const CPU_DENOISE_SAMPLES = 4;
+	static constexpr char const CPU_DENOISED_IMAGE_PATH[] = "cpu_denoised.ppm";
+
 private:
 	ComputeSettings();
 	~ComputeSettings();
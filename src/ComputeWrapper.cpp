@@ -3,25 +3,76 @@
 #include "Vertex.h"
 #include "PipelineCreator.h"
 #include "CameraData.h"
+#include "BrickMap.h"
+#include "LightGridBuilder.h"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <iostream>
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+	//BoxData and PointLight have no padding, so comparing the bytes compares the lights
+	template <typename T>
+	bool sameData(std::vector<T> const &a, std::vector<T> const &b) {
+		return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), sizeof(T) * a.size()) == 0);
+	}
+
+	//Counted down by the upload thread as the batches complete, the first dispatch of the photo mode reads the buffers right away
+	class PendingUploads {
+	public:
+		PendingUploads(size_t const count) : count(count) {}
+
+		std::function<void()> getOnComplete() {
+			return [this] {
+				std::lock_guard<std::mutex> lockGuard(mutex);
+				if (--count == 0) {
+					uploadsDone.notify_one();
+				}
+			};
+		}
+
+		void wait() {
+			std::unique_lock<std::mutex> lock(mutex);
+			uploadsDone.wait(lock, [this] {return count == 0; });
+		}
+
+	private:
+		size_t count;
+		std::mutex mutex;
+		std::condition_variable uploadsDone;
+	};
+}
 
-ComputeWrapper::ComputeWrapper(VkDevice &device, ImageCreator const &imageCreator, BufferCreator const &bufferCreator, VkExtent2D const extent, size_t const bufferCount, VkDescriptorSetLayout const &quadDescriptorSetLayout, VkRenderPass const &renderPass, VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath)
-	: device(device), bufferCreator(bufferCreator) {
+ComputeWrapper::ComputeWrapper(VkDevice &device, ImageCreator const &imageCreator, BufferCreator const &bufferCreator, VkExtent2D const extent, size_t const bufferCount, VkDescriptorSetLayout const &quadDescriptorSetLayout, VkRenderPass const &renderPass, VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath, float const timestampPeriod)
+	: device(device), bufferCreator(bufferCreator), timestampPeriod(timestampPeriod) {
 	createQuad();
 	createTexture(imageCreator);
 	createCameraData(bufferCount);
 	createQuadPipeline(extent, quadDescriptorSetLayout, renderPass);
 	createComputePipeline(computeDescriptorSetLayout, computeShaderPath);
 	createWriteBackDataBuffer();
+	createTimestampQueryPool();
+	createAccumulationBuffers();
+	createWavefrontBuffers();
+	createDenoiseBuffers();
 }
 
 ComputeWrapper::~ComputeWrapper() {
 	vkDestroyPipeline(device, quadPipeline, nullptr);
 	vkDestroyPipeline(device, computePipeline, nullptr);
 
+	for (size_t i = 0; i < wavefrontPipelines.size(); i++) {
+		vkDestroyPipeline(device, wavefrontPipelines[i], nullptr);
+	}
+
+	vkDestroyPipeline(device, denoisePipeline, nullptr);
+
 	vkDestroyPipelineLayout(device, quadPipelineLayout, nullptr);
 	vkDestroyPipelineLayout(device, computePipelineLayout, nullptr);
 
@@ -43,6 +94,20 @@ ComputeWrapper::~ComputeWrapper() {
 
 	vkDestroyBuffer(device, writeBackDataBuffer, nullptr);
 	vkFreeMemory(device, writeBackDataBufferMemory, nullptr);
+
+	bufferCreator.destroyBuffer(boxDataBuffer, boxDataBufferAllocation);
+	bufferCreator.destroyBuffer(bvhNodeBuffer, bvhNodeBufferAllocation);
+	bufferCreator.destroyBuffer(voxelBuffer, voxelBufferAllocation);
+	bufferCreator.destroyBuffer(brickBuffer, brickBufferAllocation);
+
+	vkDestroyQueryPool(device, timestampQueryPool, nullptr);
+
+	bufferCreator.destroyBuffer(accumulationBuffer, accumulationBufferAllocation);
+	bufferCreator.destroyBuffer(tileBuffer, tileBufferAllocation);
+	bufferCreator.destroyBuffer(wavefrontPathBuffer, wavefrontPathBufferAllocation);
+	bufferCreator.destroyBuffer(wavefrontQueueBuffer, wavefrontQueueBufferAllocation);
+	bufferCreator.destroyBuffer(gBufferBuffer, gBufferBufferAllocation);
+	bufferCreator.destroyBuffer(denoiseBuffer, denoiseBufferAllocation);
 }
 
 void ComputeWrapper::storeAndResetWriteBackData() {
@@ -66,21 +131,33 @@ void ComputeWrapper::updateCameraData(uint32_t const imageIndex, glm::vec3 const
 
 	cameraData.iData = iData;
 
+	//The accumulated samples belong to the old settings, so they start over like after a camera movement
+	bool settingsChanged = false;
+
 	if (ComputeSettings::oldIntegrator != iData.x) {
 		counter = 0.0f;
+		settingsChanged = true;
 		ComputeSettings::oldIntegrator = iData.x;
 	}
 
 	if (ComputeSettings::oldScaling != iData.z) {
 		counter = 0.0f;
+		settingsChanged = true;
 		ComputeSettings::oldScaling = iData.z;
 	}
 
 	if (ComputeSettings::oldCamera != iData.y) {
 		counter = 0.0f;
+		settingsChanged = true;
 		ComputeSettings::oldCamera = iData.y;
 	}
 
+	if (ComputeSettings::oldFlags != iData.w) {
+		counter = 0.0f;
+		settingsChanged = true;
+		ComputeSettings::oldFlags = iData.w;
+	}
+
 
 	cameraData.position = glm::vec4(cameraPosition, 0.0f);
 	cameraData.direction = glm::vec4(normalize(cameraDirection), 0.0f);
@@ -88,7 +165,7 @@ void ComputeWrapper::updateCameraData(uint32_t const imageIndex, glm::vec3 const
 	cameraData.sensorData = ComputeSettings::sensorData;
 	cameraData.sensorData.w = counter + 1.0f;
 
-	if (glm::length(cameraDirection - oldCameraDirection) > 1e-6f || glm::length(cameraPosition - oldCameraPosition) > 1e-6f) {
+	if (settingsChanged || glm::length(cameraDirection - oldCameraDirection) > 1e-6f || glm::length(cameraPosition - oldCameraPosition) > 1e-6f) {
 		counter = 0.0f;
 	}
 	else {
@@ -98,6 +175,14 @@ void ComputeWrapper::updateCameraData(uint32_t const imageIndex, glm::vec3 const
 	oldCameraPosition = cameraPosition;
 
 	cameraData.data.x = counter;
+	cameraData.data.y = ComputeSettings::CONVERGENCE_THRESHOLD;
+	cameraData.data.z = ComputeSettings::adaptiveSampling ? 1.0f : 0.0f;
+	cameraData.data.w = (float)ComputeSettings::ADAPTIVE_MAX_SAMPLES;
+
+	//The shader starts the accumulation over, so every tile has work again
+	if (counter < 1.0f) {
+		convergedTiles.assign(getTileCount(), false);
+	}
 
 	void *data;
 	vkMapMemory(device, cameraDataBuffersMemory[imageIndex], 0, sizeof(CameraData), 0, &data);
@@ -105,15 +190,209 @@ void ComputeWrapper::updateCameraData(uint32_t const imageIndex, glm::vec3 const
 	vkUnmapMemory(device, cameraDataBuffersMemory[imageIndex]);
 }
 
-void ComputeWrapper::createDataBuffers(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights) {
-	bufferCreator.createBoxDataBuffer(boxDataBuffer, boxDataBufferMemory, boxData);
-	if (emissiveBoxData.size() > 0) {
-		bufferCreator.createBoxDataBuffer(emissiveBoxDataBuffer, emissiveBoxDataBufferMemory, emissiveBoxData);
+uint32_t ComputeWrapper::getTileCount() const {
+	uint32_t tilesX = (ComputeSettings::COMPUTE_WIDTH + ComputeSettings::PHOTO_MODE_TILE_SIZE - 1) / ComputeSettings::PHOTO_MODE_TILE_SIZE;
+	uint32_t tilesY = (ComputeSettings::COMPUTE_HEIGHT + ComputeSettings::PHOTO_MODE_TILE_SIZE - 1) / ComputeSettings::PHOTO_MODE_TILE_SIZE;
+
+	return tilesX * tilesY;
+}
+
+bool ComputeWrapper::isPassOutdated(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec4 const &iData) const {
+	if (ComputeSettings::oldIntegrator != iData.x || ComputeSettings::oldScaling != iData.z || ComputeSettings::oldCamera != iData.y || ComputeSettings::oldFlags != iData.w) {
+		return true;
+	}
+
+	return glm::length(cameraDirection - oldCameraDirection) > 1e-6f || glm::length(cameraPosition - oldCameraPosition) > 1e-6f;
+}
+
+void ComputeWrapper::selectTiles(uint32_t const maxTiles, std::vector<uint32_t> &tiles) {
+	uint32_t tileCount = getTileCount();
+
+	tiles.clear();
+
+	while (nextTile < tileCount && tiles.size() < maxTiles) {
+		if (!ComputeSettings::adaptiveSampling || !convergedTiles[nextTile]) {
+			tiles.push_back(nextTile);
+		}
+
+		nextTile++;
+	}
+
+	if (nextTile == tileCount) {
+		nextTile = 0;
+	}
+}
+
+void ComputeWrapper::finishSubmission() {
+	storeAndResetWriteBackData();
+	computeSubmitted = false;
+
+	//A tile without unconverged pixels stays converged until the accumulation starts over
+	uint32_t *unconvergedPixels = static_cast<uint32_t *>(tileBufferAllocation.mapped);
+
+	for (size_t i = 0; i < submittedTiles.size(); i++) {
+		convergedTiles[submittedTiles[i]] = unconvergedPixels[submittedTiles[i]] == 0;
+		unconvergedPixels[submittedTiles[i]] = 0;
+	}
+
+	uint32_t tileCount = getTileCount();
+
+	if (timestampQueryPool == VK_NULL_HANDLE) {
+		//Nothing to hold against the budget, so every submission traces the whole image
+		tilesPerSubmit = tileCount;
+		return;
+	}
+
+	uint64_t timestamps[2];
+	if (vkGetQueryPoolResults(device, timestampQueryPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+		return;
+	}
+
+	double milliseconds = (double)(timestamps[1] - timestamps[0]) * timestampPeriod / 1000000.0;
+	double tileMilliseconds = std::max(milliseconds / submittedTiles.size(), 0.001);
+
+	//The cost of a tile depends on what it sees, so the count changes at most by a factor of two per submission
+	uint32_t fittingTiles = (uint32_t)(ComputeSettings::PHOTO_MODE_FRAME_BUDGET / tileMilliseconds);
+	uint32_t currentTiles = std::min(tilesPerSubmit, tileCount);
+
+	tilesPerSubmit = std::clamp(fittingTiles, std::max(currentTiles / 2, 1u), std::min(currentTiles * 2, tileCount));
+}
+
+bool ComputeWrapper::updateDataBuffers(std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights) {
+	bool recreated = false;
+
+	//Streaming mostly moves columns without lights, then the light buffers and the light grid are kept
+	if (!boxesGenerated || !sameData(emissiveBoxData, this->emissiveBoxData) || !sameData(pointLights, this->pointLights)) {
+		if (boxesGenerated) {
+			vkDestroyBuffer(device, emissiveBoxDataBuffer, nullptr);
+			vkFreeMemory(device, emissiveBoxDataBufferMemory, nullptr);
+			vkDestroyBuffer(device, pointLightBuffer, nullptr);
+			vkFreeMemory(device, pointLightBufferMemory, nullptr);
+			vkDestroyBuffer(device, lightGridBuffer, nullptr);
+			vkFreeMemory(device, lightGridBufferMemory, nullptr);
+
+			emissiveBoxDataBuffer = VK_NULL_HANDLE;
+			emissiveBoxDataBufferMemory = VK_NULL_HANDLE;
+			pointLightBuffer = VK_NULL_HANDLE;
+			pointLightBufferMemory = VK_NULL_HANDLE;
+		}
+
+		LightGrid lightGrid;
+		LightGridBuilder().build(emissiveBoxData, pointLights, lightGrid);
+
+		bufferCreator.createLightGridBuffer(lightGridBuffer, lightGridBufferMemory, lightGridBufferSize, lightGrid);
+
+		if (lightGrid.size.x > 0) {
+			std::cout << "Light grid with " << lightGrid.size.x * lightGrid.size.y * lightGrid.size.z << " cells for " << emissiveBoxData.size() + pointLights.size() << " lights, " << lightGridBufferSize / 1024 << "KiB" << std::endl;
+		}
+
+		if (emissiveBoxData.size() > 0) {
+			bufferCreator.createBoxDataBuffer(emissiveBoxDataBuffer, emissiveBoxDataBufferMemory, emissiveBoxData);
+		}
+
+		if (pointLights.size() > 0) {
+			bufferCreator.createPointLightBuffer(pointLightBuffer, pointLightBufferMemory, pointLights);
+		}
+
+		this->emissiveBoxData = emissiveBoxData;
+		this->pointLights = pointLights;
+		recreated = true;
+	}
+
+	boxesGenerated = true;
+
+	return recreated;
+}
+
+void ComputeWrapper::uploadBoxPool(BoxPool &boxPool, bool const grown, UploadQueue &uploadQueue) {
+	std::vector<BoxData> const &boxes = boxPool.getBoxes();
+	std::vector<BvhNode> const &nodes = boxPool.getNodes();
+
+	if (grown) {
+		bufferCreator.destroyBuffer(boxDataBuffer, boxDataBufferAllocation);
+		bufferCreator.destroyBuffer(bvhNodeBuffer, bvhNodeBufferAllocation);
+
+		bufferCreator.createDestinationBuffer(sizeof(BoxData) * boxes.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, boxDataBuffer, boxDataBufferAllocation);
+		bufferCreator.createDestinationBuffer(sizeof(BvhNode) * nodes.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, bvhNodeBuffer, bvhNodeBufferAllocation);
+	}
+
+	bvhNodeCount = nodes.size();
+
+	std::vector<BoxPool::Range> const &dirtyBoxRanges = boxPool.getDirtyBoxRanges();
+	std::vector<BoxPool::Range> const &dirtyNodeRanges = boxPool.getDirtyNodeRanges();
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	PendingUploads pendingUploads(dirtyBoxRanges.size() + dirtyNodeRanges.size());
+
+	VkDeviceSize uploadedBytes = 0;
+
+	for (size_t i = 0; i < dirtyBoxRanges.size(); i++) {
+		VkDeviceSize size = sizeof(BoxData) * dirtyBoxRanges[i].count;
+		uploadQueue.upload(boxes.data() + dirtyBoxRanges[i].first, size, boxDataBuffer, sizeof(BoxData) * dirtyBoxRanges[i].first, pendingUploads.getOnComplete());
+		uploadedBytes += size;
+	}
+
+	for (size_t i = 0; i < dirtyNodeRanges.size(); i++) {
+		VkDeviceSize size = sizeof(BvhNode) * dirtyNodeRanges[i].count;
+		uploadQueue.upload(nodes.data() + dirtyNodeRanges[i].first, size, bvhNodeBuffer, sizeof(BvhNode) * dirtyNodeRanges[i].first, pendingUploads.getOnComplete());
+		uploadedBytes += size;
+	}
+
+	pendingUploads.wait();
+
+	boxPool.clearDirtyRanges();
+
+	std::cout << "Box pool of " << (sizeof(BoxData) * boxes.size() + sizeof(BvhNode) * nodes.size()) / 1024 << "KiB, uploaded " << uploadedBytes / 1024 << "KiB in " << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() << "ms" << std::endl;
+}
+
+bool ComputeWrapper::uploadVoxelGrid(VoxelGrid const &voxelGrid, UploadQueue &uploadQueue) {
+	VkDeviceSize headerSize = sizeof(voxelGrid.origin) + sizeof(voxelGrid.size);
+	VkDeviceSize newVoxelBufferSize = headerSize + sizeof(uint32_t) * std::max(voxelGrid.bricks.size(), (size_t)1);
+	VkDeviceSize newBrickBufferSize = sizeof(uint32_t) * std::max(voxelGrid.brickVoxels.size(), (size_t)1);
+
+	bool voxelBufferRecreated = newVoxelBufferSize != voxelBufferSize;
+	bool brickBufferRecreated = newBrickBufferSize != brickBufferSize;
+
+	if (voxelBufferRecreated) {
+		bufferCreator.destroyBuffer(voxelBuffer, voxelBufferAllocation);
+		bufferCreator.createDestinationBuffer(newVoxelBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, voxelBuffer, voxelBufferAllocation);
+		voxelBufferSize = newVoxelBufferSize;
 	}
-	
-	if (pointLights.size() > 0) {
-		bufferCreator.createPointLightBuffer(pointLightBuffer, pointLightBufferMemory, pointLights);
+
+	if (brickBufferRecreated) {
+		bufferCreator.destroyBuffer(brickBuffer, brickBufferAllocation);
+		bufferCreator.createDestinationBuffer(newBrickBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, brickBuffer, brickBufferAllocation);
+		brickBufferSize = newBrickBufferSize;
 	}
+
+	//A new brick buffer gets the whole pool, otherwise only the bricks the columns loaded since the last time wrote
+	std::vector<std::pair<size_t, size_t>> wholePool = { { 0, voxelGrid.brickVoxels.size() / BrickMap::BRICK_UINTS } };
+	std::vector<std::pair<size_t, size_t>> const &brickRanges = brickBufferRecreated ? wholePool : voxelGrid.dirtyBrickRanges;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	PendingUploads pendingUploads(3 + brickRanges.size());
+
+	uploadQueue.upload(&voxelGrid.origin, sizeof(voxelGrid.origin), voxelBuffer, 0, pendingUploads.getOnComplete());
+	uploadQueue.upload(&voxelGrid.size, sizeof(voxelGrid.size), voxelBuffer, sizeof(voxelGrid.origin), pendingUploads.getOnComplete());
+	uploadQueue.upload(voxelGrid.bricks.data(), sizeof(uint32_t) * voxelGrid.bricks.size(), voxelBuffer, headerSize, pendingUploads.getOnComplete());
+
+	VkDeviceSize uploadedBytes = headerSize + sizeof(uint32_t) * voxelGrid.bricks.size();
+
+	for (size_t i = 0; i < brickRanges.size(); i++) {
+		VkDeviceSize size = sizeof(uint32_t) * BrickMap::BRICK_UINTS * brickRanges[i].second;
+		uploadQueue.upload(voxelGrid.brickVoxels.data() + brickRanges[i].first * BrickMap::BRICK_UINTS, size, brickBuffer, sizeof(uint32_t) * BrickMap::BRICK_UINTS * brickRanges[i].first, pendingUploads.getOnComplete());
+		uploadedBytes += size;
+	}
+
+	pendingUploads.wait();
+
+	if (voxelGrid.size.x > 0) {
+		std::cout << "Brick map with " << voxelGrid.bricks.size() << " bricks, room for " << voxelGrid.brickVoxels.size() / BrickMap::BRICK_UINTS << " stored, " << (voxelBufferSize + brickBufferSize) / 1024 << "KiB, uploaded " << uploadedBytes / 1024 << "KiB in " << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() << "ms" << std::endl;
+	}
+
+	return voxelBufferRecreated || brickBufferRecreated;
 }
 
 void ComputeWrapper::createQuad() {
@@ -150,13 +429,73 @@ void ComputeWrapper::createCameraData(size_t bufferCount) {
 }
 
 void ComputeWrapper::createQuadPipeline(VkExtent2D const extent, VkDescriptorSetLayout const &quadDescriptorSetLayout, VkRenderPass const &renderPass) {
-	PipelineCreator::createPipeLine(device, extent, quadDescriptorSetLayout, renderPass, ComputeSettings::COMPUTE_VERTEX_SHADER_PATH, ComputeSettings::COMPUTE_FRAGMENT_SHADER_PATH, false, false, quadPipelineLayout, quadPipeline);
+	PipelineCreator::createPipeLine(device, extent, quadDescriptorSetLayout, renderPass, ComputeSettings::COMPUTE_VERTEX_SHADER_PATH, ComputeSettings::COMPUTE_FRAGMENT_SHADER_PATH, false, VertexType::VERTEX, quadPipelineLayout, quadPipeline);
 }
 
 void ComputeWrapper::createComputePipeline(VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath) {
-	PipelineCreator::createComputePipeLine(device, computeDescriptorSetLayout, computeShaderPath, computePipelineLayout, computePipeline);
+	//The push constant is the offset and index of the tile and the bounce of the wavefront stages, see CommandWrapper::recordComputeCommandBuffer
+	PipelineCreator::createComputePipeLine(device, computeDescriptorSetLayout, computeShaderPath, sizeof(glm::ivec4), computePipelineLayout, computePipeline);
+
+	wavefrontPipelines.assign(WAVEFRONT_STAGE_COUNT, VK_NULL_HANDLE);
+
+	for (int32_t stage = GENERATE; stage < WAVEFRONT_STAGE_COUNT; stage++) {
+		PipelineCreator::createComputePipeLine(device, computePipelineLayout, computeShaderPath, stage, wavefrontPipelines[stage]);
+	}
+
+	//The specialization constant of the denoiser is its pass count
+	PipelineCreator::createComputePipeLine(device, computePipelineLayout, ComputeSettings::DENOISE_SHADER_PATH, ComputeSettings::DENOISE_ITERATIONS, denoisePipeline);
 }
 
 void ComputeWrapper::createWriteBackDataBuffer() {
 	bufferCreator.createWriteBackDataBuffer(writeBackDataBuffer, writeBackDataBufferMemory);
 }
+
+void ComputeWrapper::createTimestampQueryPool() {
+	if (timestampPeriod <= 0.0f) {
+		return;
+	}
+
+	VkQueryPoolCreateInfo queryPoolCreateInfo{};
+	queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolCreateInfo.queryCount = 2;
+
+	if (vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &timestampQueryPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create timestamp query pool");
+	}
+}
+
+void ComputeWrapper::createAccumulationBuffers() {
+	//Two vec4 per pixel
+	accumulationBufferSize = sizeof(glm::vec4) * 2 * ComputeSettings::COMPUTE_WIDTH * ComputeSettings::COMPUTE_HEIGHT;
+	bufferCreator.createDestinationBuffer(accumulationBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, accumulationBuffer, accumulationBufferAllocation);
+
+	tileBufferSize = sizeof(uint32_t) * getTileCount();
+	bufferCreator.createHostStorageBuffer(tileBufferSize, tileBuffer, tileBufferAllocation);
+	memset(tileBufferAllocation.mapped, 0, tileBufferSize);
+
+	convergedTiles.assign(getTileCount(), false);
+}
+
+void ComputeWrapper::createWavefrontBuffers() {
+	VkDeviceSize pathCount = (VkDeviceSize)ComputeSettings::PHOTO_MODE_TILE_SIZE * ComputeSettings::PHOTO_MODE_TILE_SIZE;
+
+	wavefrontPathBufferSize = PATH_STATE_SIZE * pathCount;
+	bufferCreator.createDestinationBuffer(wavefrontPathBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, wavefrontPathBuffer, wavefrontPathBufferAllocation);
+
+	//The eight queue counters with their indirect dispatch, then the queues
+	wavefrontQueueBufferSize = sizeof(glm::uvec4) * 8 + sizeof(uint32_t) * WAVEFRONT_QUEUE_COUNT * pathCount;
+	bufferCreator.createDestinationBuffer(wavefrontQueueBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, wavefrontQueueBuffer, wavefrontQueueBufferAllocation);
+}
+
+void ComputeWrapper::createDenoiseBuffers() {
+	VkDeviceSize pixelCount = (VkDeviceSize)ComputeSettings::COMPUTE_WIDTH * ComputeSettings::COMPUTE_HEIGHT;
+
+	//Two vec4 per pixel, see GBufferTexel
+	gBufferBufferSize = sizeof(glm::vec4) * 2 * pixelCount;
+	bufferCreator.createDestinationBuffer(gBufferBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, gBufferBuffer, gBufferBufferAllocation);
+
+	//One vec4 per pixel for each of the two images
+	denoiseBufferSize = sizeof(glm::vec4) * 2 * pixelCount;
+	bufferCreator.createDestinationBuffer(denoiseBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, denoiseBuffer, denoiseBufferAllocation);
+}
@@ -4,12 +4,17 @@
 #include "ImageCreator.h"
 #include "BufferCreator.h"
 #include "BoxData.h"
+#include "BvhNode.h"
+#include "VoxelGrid.h"
 #include "PointLight.h"
 #include "WriteBackData.h"
+#include "BoxPool.h"
+#include "UploadQueue.h"
+#include "WavefrontStage.h"
 
 class ComputeWrapper {
 public:
-	ComputeWrapper(VkDevice &device, ImageCreator const &imageCreator, BufferCreator const &bufferCreator, VkExtent2D const extent, size_t const bufferCount, VkDescriptorSetLayout const &quadDescriptorSetLayout, VkRenderPass const &renderPass, VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath);
+	ComputeWrapper(VkDevice &device, ImageCreator const &imageCreator, BufferCreator const &bufferCreator, VkExtent2D const extent, size_t const bufferCount, VkDescriptorSetLayout const &quadDescriptorSetLayout, VkRenderPass const &renderPass, VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath, float const timestampPeriod);
 	~ComputeWrapper();
 
 	VkBuffer quadVertices;
@@ -24,6 +29,12 @@ public:
 	VkPipelineLayout computePipelineLayout;
 	VkPipeline computePipeline;
 
+	//Indexed by WavefrontStage with the layout of computePipeline, the entry of the megakernel is left empty
+	std::vector<VkPipeline> wavefrontPipelines;
+
+	//Pipeline of shaders/denoise.comp with the layout of computePipeline, run over the whole image after the tiles with ComputeSettings::denoise
+	VkPipeline denoisePipeline;
+
 	VkImage computeTextureImage;
 	VkDeviceMemory computeTextureImageMemory;
 	VkImageView computeTextureImageView;
@@ -39,16 +50,92 @@ public:
 
 	void updateCameraData(uint32_t const imageIndex, glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::vec4 const &iData);
 
-	VkBuffer boxDataBuffer;
-	VkDeviceMemory boxDataBufferMemory;
-	VkBuffer emissiveBoxDataBuffer;
-	VkDeviceMemory emissiveBoxDataBufferMemory;
-	VkBuffer pointLightBuffer;
-	VkDeviceMemory pointLightBufferMemory;
+	//Timestamps around the dispatches of the last submission, VK_NULL_HANDLE if the compute queue can not write any
+	VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+
+	//Progress of the photo mode over the tiles, a finished pass adds one sample to every pixel
+	uint32_t nextTile = 0;
+	uint32_t tilesPerSubmit = 1;
+	std::vector<uint32_t> submittedTiles;
+	bool computeSubmitted = false;
+	//Set by the compute submission finishing a pass until the next quad pass waited for its computeFinishedSemaphore
+	bool computeFinishedSemaphorePending = false;
+	//All tiles of a pass read the camera data written at its start
+	uint32_t passImageIndex = 0;
+
+	uint32_t getTileCount() const;
+
+	//True if the camera or the integrator settings differ from the ones the current pass was started with
+	bool isPassOutdated(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec4 const &iData) const;
+
+	//Takes up to maxTiles tiles from nextTile on, the converged ones are skipped with adaptive sampling
+	//Advances nextTile past them and back to 0 at the end of the pass
+	void selectTiles(uint32_t const maxTiles, std::vector<uint32_t> &tiles);
+
+	//Called once the last submission is done, stores its write back data, marks its converged tiles and fits tilesPerSubmit to ComputeSettings::PHOTO_MODE_FRAME_BUDGET
+	void finishSubmission();
+
+	//Mean and variance of the samples of every pixel, see PixelAccumulation in shaders/compute.comp
+	VkBuffer accumulationBuffer = VK_NULL_HANDLE;
+	MemoryAllocation accumulationBufferAllocation;
+	VkDeviceSize accumulationBufferSize = 0;
+	//Unconverged pixels per tile, host visible so the counts of each submission can be read back
+	VkBuffer tileBuffer = VK_NULL_HANDLE;
+	MemoryAllocation tileBufferAllocation;
+	VkDeviceSize tileBufferSize = 0;
+	//First hit per pixel written by the path tracer and two images for the passes of the denoiser in between
+	VkBuffer gBufferBuffer = VK_NULL_HANDLE;
+	MemoryAllocation gBufferBufferAllocation;
+	VkDeviceSize gBufferBufferSize = 0;
+	VkBuffer denoiseBuffer = VK_NULL_HANDLE;
+	MemoryAllocation denoiseBufferAllocation;
+	VkDeviceSize denoiseBufferSize = 0;
+
+	//Paths and ray queues of the wavefront stages, sized for one tile as the tiles are traced one after another
+	VkBuffer wavefrontPathBuffer = VK_NULL_HANDLE;
+	MemoryAllocation wavefrontPathBufferAllocation;
+	VkDeviceSize wavefrontPathBufferSize = 0;
+	VkBuffer wavefrontQueueBuffer = VK_NULL_HANDLE;
+	MemoryAllocation wavefrontQueueBufferAllocation;
+	VkDeviceSize wavefrontQueueBufferSize = 0;
+
+	//Sized to the capacity of the box pool and only recreated when it grows
+	VkBuffer boxDataBuffer = VK_NULL_HANDLE;
+	MemoryAllocation boxDataBufferAllocation;
+	VkBuffer emissiveBoxDataBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory emissiveBoxDataBufferMemory = VK_NULL_HANDLE;
+	VkBuffer pointLightBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory pointLightBufferMemory = VK_NULL_HANDLE;
+	VkBuffer bvhNodeBuffer = VK_NULL_HANDLE;
+	MemoryAllocation bvhNodeBufferAllocation;
+	//Node count of the node pool, node 0 is the root over all columns
+	size_t bvhNodeCount = 0;
+	//The top level grid is uploaded as a whole, the brick buffer is sized to the capacity of the brick pool and only recreated when it grows
+	VkBuffer voxelBuffer = VK_NULL_HANDLE;
+	MemoryAllocation voxelBufferAllocation;
+	VkDeviceSize voxelBufferSize = 0;
+	VkBuffer brickBuffer = VK_NULL_HANDLE;
+	MemoryAllocation brickBufferAllocation;
+	VkDeviceSize brickBufferSize = 0;
+	VkBuffer lightGridBuffer;
+	VkDeviceMemory lightGridBufferMemory;
+	VkDeviceSize lightGridBufferSize = 0;
 	bool boxesGenerated = false;
 	bool allocated = false;
 
-	void createDataBuffers(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights);
+	//Lights in the buffers above, the descriptor sets are sized to them
+	std::vector<BoxData> emissiveBoxData;
+	std::vector<PointLight> pointLights;
+
+	//Replaces the light buffers if the lights changed, returns true if any buffer was recreated
+	bool updateDataBuffers(std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights);
+
+	//Uploads the top level grid and the dirty bricks, or all bricks into a new buffer if the pool grew, and waits for the transfers
+	//Without voxel tracing the grid stays empty, so its buffers only have to be bindable, returns true if any buffer was recreated
+	bool uploadVoxelGrid(VoxelGrid const &voxelGrid, UploadQueue &uploadQueue);
+
+	//Uploads the dirty ranges of the box pool, or the whole pool into new buffers if it grew, and waits for the transfers
+	void uploadBoxPool(BoxPool &boxPool, bool const grown, UploadQueue &uploadQueue);
 
 private:
 	VkDevice device;
@@ -59,6 +146,16 @@ private:
 	glm::vec3 oldCameraPosition;
 	float counter = 0.0f;
 
+	//Nanoseconds per timestamp tick, 0 without timestamps
+	float timestampPeriod;
+
+	//See PathState and WavefrontQueueBuffer in shaders/compute.comp
+	static VkDeviceSize const PATH_STATE_SIZE = 8 * sizeof(glm::vec4);
+	static uint32_t const WAVEFRONT_QUEUE_COUNT = 6;
+
+	//Cleared whenever the accumulation starts over
+	std::vector<bool> convergedTiles;
+
 	void createQuad();
 	void createTexture(ImageCreator const &imageCreator);
 	void createCameraData(size_t bufferCount);
@@ -66,6 +163,10 @@ private:
 	void createComputePipeline(VkDescriptorSetLayout const &computeDescriptorSetLayout, char const *computeShaderPath);
 
 	void createWriteBackDataBuffer();
+	void createTimestampQueryPool();
+	void createAccumulationBuffers();
+	void createWavefrontBuffers();
+	void createDenoiseBuffers();
 };
 
 #endif // !COMPUTEWRAPPER_H
@@ -0,0 +1,1253 @@
+#include "CpuPathTracer.h"
+#include "BoxBvh.h"
+#include "ComputeSettings.h"
+#include "ThreadPool.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+	float const EPSILON = 1e-3f;
+	float const MAX_FLOAT = 1000000.f;
+	glm::vec3 const BOX_HALF_SIZE = glm::vec3(0.5f);
+	float const M_PI_F = 3.1415926538f;
+
+	int const MAX_DEPTH = 5;
+	int const BVH_STACK_SIZE = BoxBvh::STACK_SIZE;
+	int const DISTRIBUTE_MAX = 1;
+	float const IOR = 1.4f;
+	float const P_E = 256.0f;
+	float const K_D = 1.0f;
+	float const K_S = 0.5f;
+
+	//Same tables as in shaders/compute.comp, indexed by the cube type
+	glm::vec3 const diffuseColor[30] = {
+		glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.35f, 0.41f, 0.85f), glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.47f, 0.33f, 0.22f),
+		glm::vec3(0.31f, 0.43f, 0.16f), glm::vec3(0.31f, 0.43f, 0.16f), glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(0.83f, 0.76f, 0.58f),
+		glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.47f, 0.71f, 0.37f), glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.18f, 0.18f, 0.18f), glm::vec3(0.47f, 0.71f, 0.37f),
+		glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.38f, 0.57f, 0.30f), glm::vec3(0.38f, 0.57f, 0.30f), glm::vec3(0.47f, 0.71f, 0.37f),
+		glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.47f, 0.71f, 0.37f), glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.18f, 0.08f, 0.03f),
+		glm::vec3(0.47f, 0.71f, 0.37f), glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.18f, 0.08f, 0.03f), glm::vec3(0.12f, 0.27f, 0.08f), glm::vec3(0.12f, 0.27f, 0.08f)
+	};
+
+	//0 sky, 1 refractive, 2 lambertian
+	int const materialType[30] = {
+		0, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+	};
+
+	//The logs and the cactus glow
+	bool const isGlowing[30] = {
+		false, false, false, false, false, false, false, false, false, false,
+		false, false, true, true, false, true, true, true, true, false,
+		true, true, false, true, true, false, true, true, false, false
+	};
+
+	glm::vec3 getEmission(int const type) {
+		return type >= 0 && type < 30 && isGlowing[type] ? glm::vec3(10.0f) : glm::vec3(0.0f);
+	}
+
+	uint32_t hash(uint32_t value) {
+		value ^= value >> 16;
+		value *= 0x7feb352du;
+		value ^= value >> 15;
+		value *= 0x846ca68bu;
+		value ^= value >> 16;
+
+		return value;
+	}
+
+	double getRootMeanSquareError(std::vector<glm::vec3> const &image, std::vector<glm::vec3> const &reference) {
+		double squareErrorSum = 0.0;
+
+		for (size_t i = 0; i < image.size(); i++) {
+			glm::vec3 difference = image[i] - reference[i];
+			squareErrorSum += glm::dot(difference, difference) / 3.0f;
+		}
+
+		return std::sqrt(squareErrorSum / image.size());
+	}
+}
+
+float CpuPathTracer::PixelContext::next() {
+	//xorshift32, the upper 24 bits give a float in [0, 1)
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+glm::vec4 CpuPathTracer::CpuTexture::sample(glm::vec2 const &uv) const {
+	if (pixels.empty()) {
+		return glm::vec4(0.0f);
+	}
+
+	int x = (int)std::floor(uv.x * width) % width;
+	int y = (int)std::floor(uv.y * height) % height;
+
+	x = x < 0 ? x + width : x;
+	y = y < 0 ? y + height : y;
+
+	uint8_t const *pixel = &pixels[((size_t)y * width + x) * 4];
+
+	return glm::vec4(pixel[0], pixel[1], pixel[2], pixel[3]) / 255.0f;
+}
+
+CpuPathTracer::CpuPathTracer(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights)
+	: boxes(boxData), emissiveBoxes(emissiveBoxData), pointLights(pointLights), rayCount(0) {
+	//Same traversal order as on the GPU, the boxes are sorted into the leaves
+	BoxBvh().build(boxes, nodes);
+
+	for (size_t i = 0; i < Settings::TEXTURE_COUNT; i++) {
+		loadTexture(TextureArray::getTexturePath(i), textures[i]);
+	}
+
+	//Only the day side is bound to the compute shader
+	for (size_t i = 0; i < 6; i++) {
+		loadTexture(SkyBox::getTexturePath(i), skyBoxTextures[i]);
+	}
+}
+
+CpuPathTracer::~CpuPathTracer() {}
+
+void CpuPathTracer::render(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::ivec4 const &iData, int const width, int const height, int const samples, std::vector<glm::vec3> &image, std::vector<float> &variance) {
+	cd.position = cameraPosition;
+	cd.direction = cameraDirection;
+	cd.up = up;
+	cd.sensorDimensions = ComputeSettings::sensorData;
+	cd.iData = iData;
+	cd.width = width;
+	cd.height = height;
+
+	image.assign((size_t)width * height, glm::vec3(0.0f));
+	variance.assign((size_t)width * height, 0.0f);
+	rayCount = 0;
+
+	int tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	//A tile takes all its samples at once, so the pool threads never share pixels
+	ThreadPool::getInstance().parallelFor(tilesX * tilesY, [&](int tile) {
+		int startX = (tile % tilesX) * TILE_SIZE;
+		int startY = (tile / tilesX) * TILE_SIZE;
+
+		uint64_t tileRays = 0;
+
+		for (int y = startY; y < std::min(startY + TILE_SIZE, height); y++) {
+			for (int x = startX; x < std::min(startX + TILE_SIZE, width); x++) {
+				glm::vec3 color = glm::vec3(0.0f);
+				//Welford like addSample of the shader
+				float luminanceMean = 0.0f;
+				float luminanceM2 = 0.0f;
+
+				for (int s = 0; s < samples; s++) {
+					PixelContext context = { hash(hash((uint32_t)(y * width + x)) ^ hash((uint32_t)s + 0x9e3779b9u)) | 1u, 0 };
+
+					//The shader offsets both coordinates by the same noise value
+					glm::vec2 uvCoordinates = (glm::vec2((float)x, (float)y) + context.next()) / glm::vec2((float)width, (float)height);
+
+					glm::vec3 sample = li(context, getCameraRay(context, uvCoordinates));
+					color += sample;
+					tileRays += context.rays;
+
+					float luminance = glm::dot(sample, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+					float delta = luminance - luminanceMean;
+					luminanceMean += delta / (float)(s + 1);
+					luminanceM2 += delta * (luminance - luminanceMean);
+				}
+
+				image[(size_t)y * width + x] = color / (float)samples;
+
+				//A single sample says nothing about the variance, it is assumed to be as large as the mean like in shaders/denoise.comp
+				variance[(size_t)y * width + x] = samples > 1 ? luminanceM2 / (float)(samples - 1) / (float)samples : luminanceMean * luminanceMean;
+			}
+		}
+
+		rayCount += tileRays;
+		});
+
+	renderMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	std::cout << "CPU reference: " << width << "x" << height << " with " << samples << " samples in " << renderMilliseconds << "ms, " << rayCount / (renderMilliseconds * 1000.0) << " MRays/s" << std::endl;
+}
+
+void CpuPathTracer::renderGBuffer(std::vector<GBufferTexel> &gBuffer) {
+	gBuffer.assign((size_t)cd.width * cd.height, { glm::vec4(0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 0.0f) });
+
+	ThreadPool::getInstance().parallelFor(cd.height, [&](int y) {
+		for (int x = 0; x < cd.width; x++) {
+			PixelContext context = { hash((uint32_t)(y * cd.width + x)) | 1u, 0 };
+
+			glm::vec2 uvCoordinates = (glm::vec2((float)x, (float)y) + 0.5f) / glm::vec2((float)cd.width, (float)cd.height);
+			Intersection intersection = intersectWithBoxes(context, getCameraRay(context, uvCoordinates));
+
+			if (intersection.hit) {
+				glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+
+				GBufferTexel &texel = gBuffer[(size_t)y * cd.width + x];
+				texel.normalPlane = glm::vec4(normal, glm::dot(normal, intersection.point));
+				texel.albedo = glm::vec4(glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, getBoxType(intersection.intersectedObjectId))), 1.0f);
+			}
+		}
+		});
+}
+
+void CpuPathTracer::validateDenoiser(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::ivec4 const &iData, std::vector<glm::vec3> const &reference) {
+	int width = ComputeSettings::COMPUTE_WIDTH;
+	int height = ComputeSettings::COMPUTE_HEIGHT;
+
+	std::vector<glm::vec3> image;
+	std::vector<float> variance;
+	render(cameraPosition, cameraDirection, up, iData, width, height, ComputeSettings::CPU_DENOISE_SAMPLES, image, variance);
+
+	std::vector<GBufferTexel> gBuffer;
+	renderGBuffer(gBuffer);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<glm::vec3> denoisedImage;
+	Denoiser().denoise(width, height, image, variance, gBuffer, denoisedImage);
+
+	double denoiseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	writeImage(ComputeSettings::CPU_DENOISED_IMAGE_PATH, denoisedImage, width, height);
+
+	//The errors are far below 1, so they get more digits than the timings
+	std::cout << std::fixed << std::setprecision(2) << "CPU denoiser: " << ComputeSettings::CPU_DENOISE_SAMPLES << " samples in " << denoiseMilliseconds << "ms, RMSE to the reference " << std::setprecision(4) << getRootMeanSquareError(image, reference) << " noisy, " << getRootMeanSquareError(denoisedImage, reference) << " denoised" << std::endl;
+}
+
+void CpuPathTracer::writeImage(char const *filePath, std::vector<glm::vec3> const &image, int const width, int const height) {
+	std::ofstream file(filePath, std::ios::binary);
+
+	if (!file.is_open()) {
+		throw std::runtime_error("Failed to open file for the CPU reference image");
+	}
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+
+	std::vector<uint8_t> row((size_t)width * 3);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			glm::vec3 color = glm::clamp(image[(size_t)y * width + x], glm::vec3(0.0f), glm::vec3(1.0f));
+
+			for (int c = 0; c < 3; c++) {
+				row[(size_t)x * 3 + c] = (uint8_t)std::lround(color[c] * 255.0f);
+			}
+		}
+
+		file.write((char const *)row.data(), row.size());
+	}
+}
+
+uint64_t CpuPathTracer::getRayCount() const {
+	return rayCount;
+}
+
+double CpuPathTracer::getRenderMilliseconds() const {
+	return renderMilliseconds;
+}
+
+void CpuPathTracer::loadTexture(char const *filePath, CpuTexture &texture) {
+	if (filePath == nullptr) {
+		return;
+	}
+
+	int channels;
+	stbi_uc *pixels = stbi_load(filePath, &texture.width, &texture.height, &channels, STBI_rgb_alpha);
+
+	if (!pixels) {
+		throw std::runtime_error("Failed to load texture image");
+	}
+
+	texture.pixels.assign(pixels, pixels + (size_t)texture.width * texture.height * 4);
+
+	stbi_image_free(pixels);
+}
+
+CpuPathTracer::Ray CpuPathTracer::generateRay(PixelContext &context, glm::vec3 const &origin, glm::vec3 const &direction) const {
+	context.rays++;
+
+	Ray ray;
+	ray.direction = glm::normalize(direction);
+	ray.origin = origin + ray.direction * EPSILON;
+
+	return ray;
+}
+
+CpuPathTracer::Intersection CpuPathTracer::getEmptyIntersection(PixelContext &context) const {
+	Intersection intersection;
+	intersection.hit = false;
+	intersection.point = glm::vec3(0.0f);
+	intersection.rayIn = generateRay(context, glm::vec3(0.0f), glm::vec3(0.0f));
+	intersection.t = MAX_FLOAT;
+	intersection.intersectedObjectId = -1;
+
+	return intersection;
+}
+
+glm::vec3 CpuPathTracer::getBoxPosition(int const boxID) const {
+	//The shader reads boxes[-1] for missed shadow rays, here it is the origin
+	return boxID >= 0 && boxID < (int)boxes.size() ? boxes[boxID].position : glm::vec3(0.0f);
+}
+
+int CpuPathTracer::getBoxType(int const boxID) const {
+	return boxID >= 0 && boxID < (int)boxes.size() ? boxes[boxID].id : 0;
+}
+
+glm::vec3 CpuPathTracer::getBoxNormal(glm::vec3 const &point, int const boxID) const {
+	glm::vec3 stretchedPoint = (point - getBoxPosition(boxID)) / BOX_HALF_SIZE;
+
+	glm::vec3 normal;
+	normal.x = 1.0f - std::abs(stretchedPoint.x) < EPSILON ? stretchedPoint.x : 0.0f;
+	normal.y = 1.0f - std::abs(stretchedPoint.y) < EPSILON ? stretchedPoint.y : 0.0f;
+	normal.z = 1.0f - std::abs(stretchedPoint.z) < EPSILON ? stretchedPoint.z : 0.0f;
+
+	return glm::normalize(normal);
+}
+
+glm::vec3 CpuPathTracer::getEmissiveBoxNormal(glm::vec3 const &point, int const boxID) const {
+	glm::vec3 stretchedPoint = (point - emissiveBoxes[boxID].position) / BOX_HALF_SIZE;
+
+	glm::vec3 normal;
+	normal.x = 1.0f - std::abs(stretchedPoint.x) < EPSILON ? stretchedPoint.x : 0.0f;
+	normal.y = 1.0f - std::abs(stretchedPoint.y) < EPSILON ? stretchedPoint.y : 0.0f;
+	normal.z = 1.0f - std::abs(stretchedPoint.z) < EPSILON ? stretchedPoint.z : 0.0f;
+
+	return glm::normalize(normal);
+}
+
+glm::vec2 CpuPathTracer::getUV(glm::vec3 const &localPoint) {
+	glm::vec3 stretchedPoint = localPoint / BOX_HALF_SIZE;
+
+	if (1.0f - std::abs(stretchedPoint.x) < EPSILON) {
+		if (stretchedPoint.x < 0.0f) {
+			return glm::vec2(localPoint.z + 0.5f, 1.0f - (localPoint.y + 0.5f));
+		} else {
+			return glm::vec2(1.0f - (localPoint.z + 0.5f), 1.0f - (localPoint.y + 0.5f));
+		}
+	}
+	if (1.0f - std::abs(stretchedPoint.y) < EPSILON) {
+		if (stretchedPoint.y < 0.0f) {
+			return glm::vec2(1.0f - (localPoint.z + 0.5f), 1.0f - (localPoint.x + 0.5f));
+		} else {
+			return glm::vec2(localPoint.x + 0.5f, localPoint.z + 0.5f);
+		}
+	}
+	if (1.0f - std::abs(stretchedPoint.z) < EPSILON) {
+		if (stretchedPoint.z < 0.0f) {
+			return glm::vec2(1.0f - (localPoint.x + 0.5f), 1.0f - (localPoint.y + 0.5f));
+		} else {
+			return glm::vec2(localPoint.x + 0.5f, 1.0f - (localPoint.y + 0.5f));
+		}
+	}
+
+	return glm::vec2(0.0f);
+}
+
+glm::vec2 CpuPathTracer::getSkyBoxUV(glm::vec3 const &point, int &side) {
+	side = 0;
+
+	if (1.0f - std::abs(point.y) < EPSILON) {
+		if (point.y < 0.0f) {
+			side = 1;
+			return glm::vec2((point.x + 1.0f) / 2.0f, 1.0f - (point.z + 1.0f) / 2.0f);
+		} else {
+			side = 0;
+			return glm::vec2((point.x + 1.0f) / 2.0f, (point.z + 1.0f) / 2.0f);
+		}
+	}
+	if (1.0f - std::abs(point.x) < EPSILON) {
+		if (point.x < 0.0f) {
+			side = 2;
+			return glm::vec2((point.z + 1.0f) / 2.0f, 1.0f - (point.y + 1.0f) / 2.0f);
+		} else {
+			side = 3;
+			return glm::vec2(1.0f - (point.z + 1.0f) / 2.0f, 1.0f - (point.y + 1.0f) / 2.0f);
+		}
+	}
+	if (1.0f - std::abs(point.z) < EPSILON) {
+		if (point.z < 0.0f) {
+			side = 5;
+			return glm::vec2(1.0f - (point.x + 1.0f) / 2.0f, 1.0f - (point.y + 1.0f) / 2.0f);
+		} else {
+			side = 4;
+			return glm::vec2((point.x + 1.0f) / 2.0f, 1.0f - (point.y + 1.0f) / 2.0f);
+		}
+	}
+
+	return glm::vec2(0.0f);
+}
+
+void CpuPathTracer::calculateLocalCoordinateSystem(glm::vec3 const &upVector, glm::vec3 &localX, glm::vec3 &localZ) {
+	glm::vec3 vec = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	if (1.0f - std::abs(glm::dot(vec, upVector)) < EPSILON) {
+		vec = glm::vec3(1.0f, 0.0f, 0.0f);
+	}
+
+	localX = glm::normalize(glm::cross(upVector, vec));
+	localZ = glm::normalize(glm::cross(upVector, localX));
+}
+
+glm::vec3 CpuPathTracer::rotateVectorInCoordinateSystem(glm::vec3 const &vector, glm::vec3 const &x, glm::vec3 const &y, glm::vec3 const &z) {
+	return glm::vec3(vector.x * z.x + vector.y * y.x + vector.z * x.x,
+		vector.x * z.y + vector.y * y.y + vector.z * x.y,
+		vector.x * z.z + vector.y * y.z + vector.z * x.z);
+}
+
+glm::vec3 CpuPathTracer::uniformHemisphereSample(PixelContext &context) {
+	float r1 = context.next();
+	float r2 = context.next();
+
+	float sinTheta = std::sqrt(1.0f - r1 * r1);
+	float phi = 2.0f * M_PI_F * r2;
+
+	return glm::vec3(sinTheta * std::cos(phi), r1, sinTheta * std::sin(phi));
+}
+
+glm::vec3 CpuPathTracer::uniformBoxSample(PixelContext &context) {
+	int side = (int)(context.next() * 6);
+	int axis = side % 3;
+
+	glm::vec3 point = glm::vec3(0.0f);
+
+	point[axis] = side > 2 ? 0.5f : -0.5f;
+	point[(axis + 1) % 3] = context.next() - 0.5f;
+	point[(axis + 2) % 3] = context.next() - 0.5f;
+
+	return point;
+}
+
+glm::vec3 CpuPathTracer::getLightIntensityAtPoint(glm::vec3 const &point, glm::vec3 const &pointOnLightSource, glm::vec3 const &emission) {
+	//The shader calls .length() on the vector, which is its component count in GLSL and not the distance, kept so both images match
+	float radius = 3.0f;
+	float radiusSquare = radius * radius;
+
+	return emission / (4.f * M_PI_F * radiusSquare);
+}
+
+bool CpuPathTracer::lightSourcesAvailable() const {
+	return emissiveBoxes.size() + pointLights.size() > 0;
+}
+
+void CpuPathTracer::lightSourceIDSample(PixelContext &context, int &lightSourceID, int &lightSourceType) const {
+	float r = context.next();
+	int lightSourceCount = (int)(emissiveBoxes.size() + pointLights.size());
+
+	int idUncapped = (int)(r * lightSourceCount);
+
+	if (idUncapped < (int)emissiveBoxes.size()) {
+		lightSourceType = 0;
+		lightSourceID = idUncapped;
+	} else {
+		lightSourceType = 1;
+		lightSourceID = idUncapped - (int)emissiveBoxes.size();
+	}
+}
+
+int CpuPathTracer::pointLightSourceIDSample(PixelContext &context) const {
+	return (int)(context.next() * pointLights.size());
+}
+
+float CpuPathTracer::getLightSourcePdf() const {
+	return 1.0f / (emissiveBoxes.size() + pointLights.size());
+}
+
+float CpuPathTracer::getEmissiveBoxPdf() {
+	return 1.0f / 6.0f;
+}
+
+float CpuPathTracer::getPointLightPdf() {
+	return 1.0f;
+}
+
+float CpuPathTracer::getMaterialPdf(int const materialType) {
+	return materialType == 2 ? 1.0f / (2.0f * M_PI_F) : 1.0f;
+}
+
+CpuPathTracer::Ray CpuPathTracer::getCameraRay(PixelContext &context, glm::vec2 const &uvCoordinates) const {
+	//timsGetCameraRay, the only camera of the shader so far
+	glm::vec3 w = cd.direction;
+	glm::vec3 u = glm::normalize(glm::cross(w, cd.up));
+	glm::vec3 v = glm::normalize(glm::cross(w, u));
+
+	float frameBufferAspectRatio = (float)cd.width / (float)cd.height;
+	float sensorAspectRatio = cd.sensorDimensions.x / cd.sensorDimensions.y;
+
+	float transformedWidth = cd.sensorDimensions.x / 2.0f;
+	float transformedHeight = cd.sensorDimensions.y / 2.0f;
+
+	float horizontalScale = 1.0f;
+	float verticalScale = 1.0f;
+
+	if (sensorAspectRatio > frameBufferAspectRatio) {
+		horizontalScale = frameBufferAspectRatio / sensorAspectRatio;
+	} else {
+		verticalScale = sensorAspectRatio / frameBufferAspectRatio;
+	}
+
+	transformedWidth *= horizontalScale * cd.iData.z;
+	transformedHeight *= verticalScale * cd.iData.z;
+
+	glm::vec3 width = 2.0f * transformedWidth * u;
+	glm::vec3 height = 2.0f * transformedHeight * v;
+
+	glm::vec3 lowerLeftCorner = cd.position - u * transformedWidth - v * transformedHeight + w * cd.sensorDimensions.z;
+
+	return generateRay(context, cd.position, (lowerLeftCorner + (uvCoordinates.x * width) + (uvCoordinates.y * height)) - cd.position);
+}
+
+CpuPathTracer::Intersection CpuPathTracer::rayAABBTest(PixelContext &context, Ray const &ray, int const boxID) const {
+	Intersection intersection = getEmptyIntersection(context);
+
+	glm::vec3 boxOrigin = getBoxPosition(boxID);
+	glm::vec3 directionInverse = glm::vec3(1.0f) / ray.direction;
+
+	glm::vec3 tMinVec = (boxOrigin - BOX_HALF_SIZE - ray.origin) * directionInverse;
+	glm::vec3 tMaxVec = (boxOrigin + BOX_HALF_SIZE - ray.origin) * directionInverse;
+
+	float tmin = std::max(std::max(std::min(tMinVec.x, tMaxVec.x), std::min(tMinVec.y, tMaxVec.y)), std::min(tMinVec.z, tMaxVec.z));
+	float tmax = std::min(std::min(std::max(tMinVec.x, tMaxVec.x), std::max(tMinVec.y, tMaxVec.y)), std::max(tMinVec.z, tMaxVec.z));
+
+	if (tmax < 0 || tmin > tmax) {
+		return intersection;
+	}
+
+	intersection.hit = true;
+	intersection.t = std::abs(tmin);
+	intersection.point = ray.origin + ray.direction * intersection.t;
+	intersection.rayIn = ray;
+	intersection.intersectedObjectId = boxID;
+
+	return intersection;
+}
+
+CpuPathTracer::Intersection CpuPathTracer::raySkyBoxTest(PixelContext &context, Ray const &ray) const {
+	Intersection intersection = getEmptyIntersection(context);
+
+	glm::vec3 directionInverse = glm::vec3(1.0f) / ray.direction;
+
+	glm::vec3 tMinVec = glm::vec3(-1.0f) * directionInverse;
+	glm::vec3 tMaxVec = glm::vec3(1.0f) * directionInverse;
+
+	float tmin = std::max(std::max(std::min(tMinVec.x, tMaxVec.x), std::min(tMinVec.y, tMaxVec.y)), std::min(tMinVec.z, tMaxVec.z));
+	float tmax = std::min(std::min(std::max(tMinVec.x, tMaxVec.x), std::max(tMinVec.y, tMaxVec.y)), std::max(tMinVec.z, tMaxVec.z));
+
+	if (tmax < 0 || tmin > tmax) {
+		return intersection;
+	}
+
+	intersection.hit = false;
+	intersection.t = std::abs(tmin);
+	intersection.point = ray.direction * intersection.t;
+	intersection.rayIn = ray;
+	intersection.intersectedObjectId = -1;
+
+	return intersection;
+}
+
+float CpuPathTracer::rayNodeTest(glm::vec3 const &origin, glm::vec3 const &directionInverse, int const nodeID, float const maxT) const {
+	glm::vec3 tMinVec = (nodes[nodeID].minBound - origin) * directionInverse;
+	glm::vec3 tMaxVec = (nodes[nodeID].maxBound - origin) * directionInverse;
+
+	float tmin = std::max(std::max(std::min(tMinVec.x, tMaxVec.x), std::min(tMinVec.y, tMaxVec.y)), std::min(tMinVec.z, tMaxVec.z));
+	float tmax = std::min(std::min(std::max(tMinVec.x, tMaxVec.x), std::max(tMinVec.y, tMaxVec.y)), std::max(tMinVec.z, tMaxVec.z));
+
+	if (tmax < 0 || tmin > tmax || tmin > maxT) {
+		return MAX_FLOAT;
+	}
+
+	return tmin;
+}
+
+CpuPathTracer::Intersection CpuPathTracer::intersectWithBoxes(PixelContext &context, Ray const &ray) const {
+	//intersectWithBvh of the shader
+	Intersection closest = getEmptyIntersection(context);
+
+	if (nodes.empty()) {
+		return closest;
+	}
+
+	glm::vec3 directionInverse = glm::vec3(1.0f) / ray.direction;
+
+	int stack[BVH_STACK_SIZE];
+	int stackSize = 0;
+	int nodeID = 0;
+
+	if (rayNodeTest(ray.origin, directionInverse, 0, closest.t) == MAX_FLOAT) {
+		return closest;
+	}
+
+	while (true) {
+		if (nodes[nodeID].count > 0) {
+			for (int i = nodes[nodeID].leftOrFirst; i < nodes[nodeID].leftOrFirst + nodes[nodeID].count; i++) {
+				Intersection intersection = rayAABBTest(context, ray, i);
+
+				if (intersection.hit && intersection.t < closest.t) {
+					int type = getBoxType(i);
+
+					if (1.0f - sampleTexture(intersection.point, i, type).w < EPSILON || type == 1 || type == 2) {
+						closest = intersection;
+					}
+				}
+			}
+		} else {
+			int nearID = nodes[nodeID].leftOrFirst;
+			int farID = nearID + 1;
+
+			float nearT = rayNodeTest(ray.origin, directionInverse, nearID, closest.t);
+			float farT = rayNodeTest(ray.origin, directionInverse, farID, closest.t);
+
+			if (farT < nearT) {
+				std::swap(nearT, farT);
+				std::swap(nearID, farID);
+			}
+
+			if (nearT != MAX_FLOAT) {
+				if (farT != MAX_FLOAT && stackSize < BVH_STACK_SIZE) {
+					stack[stackSize++] = farID;
+				}
+
+				nodeID = nearID;
+				continue;
+			}
+		}
+
+		bool found = false;
+
+		while (stackSize > 0 && !found) {
+			nodeID = stack[--stackSize];
+			found = rayNodeTest(ray.origin, directionInverse, nodeID, closest.t) != MAX_FLOAT;
+		}
+
+		if (!found) {
+			break;
+		}
+	}
+
+	return closest;
+}
+
+CpuPathTracer::Intersection CpuPathTracer::intersectWithScene(PixelContext &context, Ray const &ray) const {
+	Intersection closest = getEmptyIntersection(context);
+
+	Intersection boxIntersection = intersectWithBoxes(context, ray);
+	Intersection skyBoxIntersection = raySkyBoxTest(context, ray);
+
+	return boxIntersection.hit ? boxIntersection : skyBoxIntersection;
+}
+
+glm::vec4 CpuPathTracer::sampleTexture(glm::vec3 const &point, int const boxID, int type) const {
+	if (type == 5 || type == 12 || type == 15 || type == 17 || type == 20 || type == 23 || type == 26 || type == 28) {
+		if (1.0f - getBoxNormal(point, boxID).y < EPSILON) {
+			type += 1;
+		}
+	}
+
+	return textures[std::min(std::max(type, 0), Settings::TEXTURE_COUNT - 1)].sample(getUV(point - getBoxPosition(boxID)));
+}
+
+glm::vec4 CpuPathTracer::sampleEmissiveTexture(glm::vec3 const &point, int const boxID, int type) const {
+	if (type == 5 || type == 12 || type == 15 || type == 17 || type == 20 || type == 23 || type == 26 || type == 28) {
+		if (1.0f - getEmissiveBoxNormal(point, boxID).y < EPSILON) {
+			type += 1;
+		}
+	}
+
+	return textures[std::min(std::max(type, 0), Settings::TEXTURE_COUNT - 1)].sample(getUV(point - emissiveBoxes[boxID].position));
+}
+
+int CpuPathTracer::getMaterialType(Intersection const &intersection) const {
+	if (intersection.intersectedObjectId == -1) {
+		return 0;
+	}
+
+	return materialType[getBoxType(intersection.intersectedObjectId)];
+}
+
+bool CpuPathTracer::scatterSkyBox(Intersection const &intersection, glm::vec3 &attenuation) const {
+	int side;
+	glm::vec2 uvCoordinates = getSkyBoxUV(intersection.point, side);
+
+	attenuation = glm::vec3(skyBoxTextures[side].sample(uvCoordinates));
+
+	return false;
+}
+
+bool CpuPathTracer::scatterRefractive(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const {
+	glm::vec3 directionIn = intersection.rayIn.direction;
+
+	glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+	float eta = 1.0f / IOR;
+	float cosTheta = -glm::dot(directionIn, normal);
+
+	if (glm::dot(directionIn, normal) > 0.0f) {
+		cosTheta = IOR * glm::dot(directionIn, normal);
+		normal = -normal;
+		eta = IOR;
+	}
+
+	float reflectProbability = 1.0f;
+
+	glm::vec3 directionOut = glm::refract(directionIn, normal, eta);
+
+	if (directionOut != glm::vec3(0.0f)) {
+		//schlick
+		float r0 = ((1.0f - IOR) / (1.0f + IOR)) * ((1.0f - IOR) / (1.0f + IOR));
+		float oCTheta = 1.0f - cosTheta;
+		reflectProbability = r0 + (1.0f - r0) * oCTheta * oCTheta * oCTheta * oCTheta * oCTheta;
+	}
+
+	if (context.next() < reflectProbability) {
+		directionOut = glm::reflect(directionIn, normal);
+	}
+
+	rayOut = generateRay(context, intersection.point, directionOut);
+
+	attenuation = glm::vec3(1.0f);
+
+	return true;
+}
+
+bool CpuPathTracer::scatterLambertian(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const {
+	attenuation = glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, getBoxType(intersection.intersectedObjectId))) / M_PI_F;
+
+	glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+	glm::vec3 normalX = glm::vec3(0.0f);
+	glm::vec3 normalZ = glm::vec3(0.0f);
+
+	calculateLocalCoordinateSystem(normal, normalX, normalZ);
+
+	glm::vec3 directionOut = rotateVectorInCoordinateSystem(uniformHemisphereSample(context), normalX, normal, normalZ);
+
+	rayOut = generateRay(context, intersection.point, directionOut);
+
+	return true;
+}
+
+bool CpuPathTracer::scatter(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const {
+	int type = intersection.hit ? getMaterialType(intersection) : 0;
+
+	switch (type) {
+	case 1:
+		return scatterRefractive(context, intersection, attenuation, rayOut);
+	case 2:
+		return scatterLambertian(context, intersection, attenuation, rayOut);
+	default:
+		return scatterSkyBox(intersection, attenuation);
+	}
+}
+
+glm::vec3 CpuPathTracer::intersectionIntegrator(PixelContext &context, Ray const &ray) const {
+	return intersectWithBoxes(context, ray).hit ? glm::vec3(1.0f) : glm::vec3(0.0f);
+}
+
+glm::vec3 CpuPathTracer::normalIntegrator(PixelContext &context, Ray const &ray) const {
+	Intersection intersection = intersectWithBoxes(context, ray);
+
+	return intersection.hit ? glm::abs(getBoxNormal(intersection.point, intersection.intersectedObjectId)) : glm::vec3(0.0f);
+}
+
+glm::vec3 CpuPathTracer::diffuseColorIntegrator(PixelContext &context, Ray const &ray) const {
+	Intersection intersection = intersectWithBoxes(context, ray);
+
+	return intersection.hit ? diffuseColor[getBoxType(intersection.intersectedObjectId)] : glm::vec3(0.0f);
+}
+
+glm::vec3 CpuPathTracer::uvIntegrator(PixelContext &context, Ray const &ray) const {
+	Intersection intersection = intersectWithBoxes(context, ray);
+
+	return intersection.hit ? glm::vec3(getUV(intersection.point - getBoxPosition(intersection.intersectedObjectId)), 0.0f) : glm::vec3(0.0f);
+}
+
+glm::vec3 CpuPathTracer::textureIntegrator(PixelContext &context, Ray const &ray) const {
+	Intersection intersection = intersectWithBoxes(context, ray);
+
+	return intersection.hit ? glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, getBoxType(intersection.intersectedObjectId))) : glm::vec3(0.0f);
+}
+
+glm::vec3 CpuPathTracer::ambientOcclusionIntegrator(PixelContext &context, Ray const &ray) const {
+	glm::vec3 color = glm::vec3(0.0f);
+
+	Intersection intersection = intersectWithBoxes(context, ray);
+
+	if (intersection.hit) {
+		glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+		glm::vec3 normalX = glm::vec3(0.0f);
+		glm::vec3 normalZ = glm::vec3(0.0f);
+
+		calculateLocalCoordinateSystem(normal, normalX, normalZ);
+
+		glm::vec3 directionOut = rotateVectorInCoordinateSystem(uniformHemisphereSample(context), normalX, normal, normalZ);
+
+		Ray rayOut = generateRay(context, intersection.point, directionOut);
+
+		if (!intersectWithBoxes(context, rayOut).hit) {
+			color += glm::vec3(std::max(glm::dot(directionOut, normal), 0.0f)) * 2.0f;
+		}
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::whittedIntegrator(PixelContext &context, Ray const &ray) const {
+	glm::vec3 color = glm::vec3(0.0f);
+
+	Ray rayIn = ray;
+	Ray rayOut;
+
+	//Counted like the unused intersection the shader starts with
+	getEmptyIntersection(context);
+
+	glm::vec3 attenuation = glm::vec3(1.0f);
+
+	for (int depth = 0; depth < MAX_DEPTH; depth++) {
+		Intersection intersection = intersectWithScene(context, rayIn);
+		int type = getMaterialType(intersection);
+
+		if (intersection.hit) {
+			if (pointLights.empty()) {
+				break;
+			}
+
+			int pointLightID = pointLightSourceIDSample(context);
+
+			glm::vec3 lightDirection = glm::normalize(glm::vec3(pointLights[pointLightID].position) - intersection.point);
+
+			Ray shadowRay = generateRay(context, intersection.point, lightDirection);
+			Intersection shadowIntersection = intersectWithScene(context, shadowRay);
+
+			if (!shadowIntersection.hit) {
+				color = glm::vec3(0.0f);
+
+				if (type != 1) {
+					glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+					glm::vec3 lightIntensity = getLightIntensityAtPoint(intersection.point, glm::vec3(pointLights[0].position), glm::vec3(pointLights[0].intensity));
+
+					//Diffuse
+					float diffuse = std::max(glm::dot(normal, lightDirection), 0.0f);
+					glm::vec3 diffusePart = glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, getBoxType(intersection.intersectedObjectId))) * diffuse * lightIntensity / M_PI_F;
+
+					//Specular
+					glm::vec3 reflectDirection = glm::reflect(lightDirection, normal);
+					float specular = std::pow(std::max(glm::dot(ray.direction, reflectDirection), 0.0f), P_E);
+					glm::vec3 specularPart = lightIntensity * specular;
+
+					color += diffusePart * K_D + specularPart * K_S;
+					color *= attenuation;
+					color /= (1.0f / pointLights.size()) * getPointLightPdf();
+
+					break;
+				} else {
+					scatter(context, intersection, attenuation, rayOut);
+					rayIn = rayOut;
+				}
+			}
+		} else {
+			scatterSkyBox(intersection, attenuation);
+			color += attenuation;
+			break;
+		}
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::distributedIntegrator(PixelContext &context, Ray const &ray) const {
+	glm::vec3 color = glm::vec3(0.0f);
+
+	Ray rayIn = ray;
+	Ray rayOut;
+
+	//Counted like the unused intersection the shader starts with
+	getEmptyIntersection(context);
+
+	glm::vec3 attenuation = glm::vec3(1.0f);
+
+	for (int depth = 0; depth < MAX_DEPTH; depth++) {
+		Intersection intersection = intersectWithScene(context, rayIn);
+		int type = getMaterialType(intersection);
+
+		if (intersection.hit) {
+			int boxType = getBoxType(intersection.intersectedObjectId);
+
+			if (glm::length(getEmission(boxType)) > 0.0f) {
+				return getEmission(boxType) * glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, boxType));
+			}
+
+			for (int i = 0; i < DISTRIBUTE_MAX; i++) {
+				glm::vec3 colorLocal = glm::vec3(0.0f);
+
+				if (lightSourcesAvailable()) {
+					int lightSourceID;
+					int lightSourceType;
+					lightSourceIDSample(context, lightSourceID, lightSourceType);
+
+					glm::vec3 positionOnLightSource;
+
+					if (lightSourceType == 0) { //Box (Area)
+						positionOnLightSource = emissiveBoxes[lightSourceID].position + uniformBoxSample(context);
+					} else { //Point Light
+						positionOnLightSource = glm::vec3(pointLights[lightSourceID].position);
+					}
+
+					glm::vec3 shadowRayDirection = positionOnLightSource - intersection.point;
+
+					Ray shadowRay = generateRay(context, intersection.point, shadowRayDirection);
+					Intersection shadowIntersection = intersectWithBoxes(context, shadowRay);
+
+					glm::vec3 emissionReached;
+
+					if (lightSourceType == 0) { //Box (Area)
+						glm::vec3 emission = getEmission(emissiveBoxes[lightSourceID].id) * glm::vec3(sampleTexture(shadowIntersection.point, shadowIntersection.intersectedObjectId, emissiveBoxes[lightSourceID].id));
+						emissionReached = getLightIntensityAtPoint(intersection.point, positionOnLightSource, emission);
+						emissionReached *= std::max(glm::dot(getBoxNormal(shadowIntersection.point, shadowIntersection.intersectedObjectId), -shadowRay.direction), 0.0f);
+						emissionReached /= getLightSourcePdf() * getEmissiveBoxPdf();
+					} else { //Point Light
+						emissionReached = getLightIntensityAtPoint(intersection.point, glm::vec3(pointLights[lightSourceID].position), glm::vec3(pointLights[lightSourceID].intensity));
+					}
+
+					glm::vec3 lightDirection = glm::normalize(shadowRayDirection);
+
+					if (!shadowIntersection.hit || (lightSourceType == 0 && glm::length(positionOnLightSource - shadowIntersection.point) < 2.0f * EPSILON)) {
+						if (type != 1) {
+							glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+
+							//Diffuse
+							float diffuse = std::max(glm::dot(normal, lightDirection), 0.0f);
+							glm::vec3 diffusePart = glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, boxType)) * diffuse * emissionReached / M_PI_F;
+
+							//Specular
+							glm::vec3 reflectDirection = glm::reflect(lightDirection, normal);
+							float specular = std::pow(std::max(glm::dot(ray.direction, reflectDirection), 0.0f), P_E);
+							glm::vec3 specularPart = emissionReached * specular;
+
+							colorLocal += diffusePart * K_D + specularPart * K_S;
+						} else {
+							scatter(context, intersection, attenuation, rayOut);
+							rayIn = rayOut;
+						}
+					} else {
+						colorLocal = glm::vec3(0.0f);
+					}
+				}
+
+				color += colorLocal * attenuation;
+			}
+
+			color /= (float)DISTRIBUTE_MAX;
+		} else {
+			scatterSkyBox(intersection, attenuation);
+			color += attenuation;
+			break;
+		}
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::timsPathTraceIntegrator(PixelContext &context, Ray const &ray) const {
+	glm::vec3 color = glm::vec3(0.0f);
+	glm::vec3 li = glm::vec3(1.0f);
+
+	Ray rayIn = ray;
+	Ray rayOut;
+
+	float alpha = 0.995f;
+	int i = 0;
+
+	while (i <= 10) {
+		if (context.next() > alpha && i > 3) {
+			break;
+		}
+		++i;
+
+		Intersection intersection = intersectWithScene(context, rayIn);
+		int type = getMaterialType(intersection);
+
+		glm::vec3 attenuation = glm::vec3(0.0f);
+		bool scattered = scatter(context, intersection, attenuation, rayOut);
+
+		if (intersection.hit) {
+			float cos = 1.0f;
+
+			if (type != 1) {
+				cos = std::max(glm::dot(getBoxNormal(intersection.point, intersection.intersectedObjectId), rayOut.direction), 0.0f);
+			}
+
+			li *= attenuation * cos / getMaterialPdf(type) / alpha;
+
+			glm::vec3 emission = getEmission(getBoxType(intersection.intersectedObjectId));
+
+			if (glm::length(emission) > 0.0f) {
+				li *= emission;
+				color += li;
+			}
+		} else {
+			color += li * attenuation / alpha;
+			break;
+		}
+
+		if (!scattered) {
+			break;
+		}
+
+		rayIn = rayOut;
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::pathTraceNEEIntegrator(PixelContext &context, Ray const &ray) const {
+	glm::vec3 color = glm::vec3(0.0f);
+	glm::vec3 li = glm::vec3(1.0f);
+
+	Ray rayIn = ray;
+	Ray rayOut;
+	int lastMaterial = -1;
+
+	float alpha = 0.995f;
+	int i = 0;
+
+	while (i <= 10) {
+		if (context.next() > alpha && i > 3) {
+			break;
+		}
+		++i;
+
+		Intersection intersection = intersectWithScene(context, rayIn);
+		int type = getMaterialType(intersection);
+
+		glm::vec3 attenuation = glm::vec3(0.0f);
+		bool scattered = scatter(context, intersection, attenuation, rayOut);
+
+		if (intersection.hit) {
+			int boxType = getBoxType(intersection.intersectedObjectId);
+
+			//Direct Lighting
+			if (lightSourcesAvailable() && type != 1) {
+				int lightSourceID;
+				int lightSourceType;
+				lightSourceIDSample(context, lightSourceID, lightSourceType);
+
+				glm::vec3 positionOnLightSource;
+
+				if (lightSourceType == 0) { //Box (Area)
+					positionOnLightSource = emissiveBoxes[lightSourceID].position + uniformBoxSample(context);
+				} else { //Point Light
+					positionOnLightSource = glm::vec3(pointLights[lightSourceID].position);
+				}
+
+				Ray shadowRay = generateRay(context, intersection.point, positionOnLightSource - intersection.point);
+				Intersection shadowIntersection = intersectWithScene(context, shadowRay);
+
+				glm::vec3 normal = getBoxNormal(intersection.point, intersection.intersectedObjectId);
+				glm::vec3 attenuationAtPoint = li * glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, boxType)) / M_PI_F;
+
+				if (lightSourceType == 0 && shadowIntersection.hit && glm::length(positionOnLightSource - shadowIntersection.point) < 2.0f * EPSILON) {
+					glm::vec3 emissionReached = getEmission(emissiveBoxes[lightSourceID].id) * glm::vec3(sampleTexture(shadowIntersection.point, shadowIntersection.intersectedObjectId, emissiveBoxes[lightSourceID].id));
+					float g = (std::max(glm::dot(normal, shadowRay.direction), 0.0f) * std::max(glm::dot(getBoxNormal(shadowIntersection.point, shadowIntersection.intersectedObjectId), -shadowRay.direction), 0.0f))
+						/ (shadowIntersection.t * shadowIntersection.t);
+					color += attenuationAtPoint * emissionReached * g / (getLightSourcePdf() * getEmissiveBoxPdf());
+				}
+
+				if (lightSourceType == 1 && !shadowIntersection.hit) {
+					glm::vec3 emissionReached = getLightIntensityAtPoint(intersection.point, glm::vec3(pointLights[lightSourceID].position), glm::vec3(pointLights[lightSourceID].intensity));
+					float g = std::max(glm::dot(normal, shadowRay.direction), 0.0f);
+					color += attenuationAtPoint * emissionReached * g / (getLightSourcePdf() * getPointLightPdf());
+				}
+			}
+
+			float cos = 1.0f;
+
+			if (type != 1) {
+				cos = std::max(glm::dot(getBoxNormal(intersection.point, intersection.intersectedObjectId), rayOut.direction), 0.0f);
+			}
+
+			li *= attenuation * cos / getMaterialPdf(type) / alpha;
+
+			if ((lastMaterial == 1 || i == 1) && glm::length(getEmission(boxType)) > 0.0f) {
+				color += getEmission(boxType) * glm::vec3(sampleTexture(intersection.point, intersection.intersectedObjectId, boxType));
+				break;
+			}
+
+			lastMaterial = type;
+		} else {
+			color += li * attenuation / alpha;
+			break;
+		}
+
+		if (!scattered) {
+			break;
+		}
+
+		rayIn = rayOut;
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::bidirectionalPathTraceIntegrator(PixelContext &context, Ray const &ray) const {
+	if (!lightSourcesAvailable()) {
+		return glm::vec3(0.0f);
+	}
+
+	glm::vec3 color = glm::vec3(0.0f);
+
+	glm::vec3 liCamera = glm::vec3(1.0f);
+	glm::vec3 liLight = glm::vec3(1.0f);
+
+	Ray rayInCamera = ray;
+	Ray rayOutCamera;
+
+	Ray rayInLight;
+	Ray rayOutLight;
+
+	//Sample point on light source
+	int lightSourceID;
+	int lightSourceType;
+	lightSourceIDSample(context, lightSourceID, lightSourceType);
+
+	glm::vec3 positionOnLightSource;
+	glm::vec3 directionFromLightSource;
+	float lightSourcePdf;
+
+	if (lightSourceType == 0) { //Box (Area)
+		positionOnLightSource = emissiveBoxes[lightSourceID].position + uniformBoxSample(context);
+
+		glm::vec3 normal = getEmissiveBoxNormal(positionOnLightSource, lightSourceID);
+		glm::vec3 normalX = glm::vec3(0.0f);
+		glm::vec3 normalZ = glm::vec3(0.0f);
+
+		calculateLocalCoordinateSystem(normal, normalX, normalZ);
+
+		directionFromLightSource = rotateVectorInCoordinateSystem(uniformHemisphereSample(context), normalX, normal, normalZ);
+
+		liLight = getEmission(emissiveBoxes[lightSourceID].id) * glm::vec3(sampleEmissiveTexture(positionOnLightSource, lightSourceID, emissiveBoxes[lightSourceID].id));
+
+		lightSourcePdf = getLightSourcePdf() * getEmissiveBoxPdf();
+	} else { //Point Light
+		positionOnLightSource = glm::vec3(pointLights[lightSourceID].position);
+
+		float x = (context.next() - 0.5f) * 2.0f;
+		float y = (context.next() - 0.5f) * 2.0f;
+		float z = (context.next() - 0.5f) * 2.0f;
+		directionFromLightSource = glm::normalize(glm::vec3(x, y, z));
+
+		liLight = glm::vec3(pointLights[lightSourceID].intensity);
+
+		lightSourcePdf = getLightSourcePdf() * getPointLightPdf();
+	}
+
+	rayInLight = generateRay(context, positionOnLightSource, directionFromLightSource);
+
+	for (int i = 1; i <= 6; i++) {
+		Intersection intersectionCamera = intersectWithScene(context, rayInCamera);
+		Intersection intersectionLight = intersectWithScene(context, rayInLight);
+
+		int materialTypeCamera = getMaterialType(intersectionCamera);
+		int materialTypeLight = getMaterialType(intersectionLight);
+
+		glm::vec3 attenuationCamera = glm::vec3(0.0f);
+		glm::vec3 attenuationLight = glm::vec3(0.0f);
+
+		bool scatteredCamera = scatter(context, intersectionCamera, attenuationCamera, rayOutCamera);
+		bool scatteredLight = scatter(context, intersectionLight, attenuationLight, rayOutLight);
+
+		if (intersectionCamera.hit && intersectionLight.hit) {
+			Ray connectionRay = generateRay(context, intersectionCamera.point, intersectionLight.point - intersectionCamera.point);
+			Intersection connectionIntersection = intersectWithScene(context, connectionRay);
+
+			if (glm::length(intersectionLight.point - connectionIntersection.point) < 2.0f * EPSILON) {
+				float cosThetaI = std::max(glm::dot(getBoxNormal(intersectionCamera.point, intersectionCamera.intersectedObjectId), connectionRay.direction), 0.0f);
+				float cosThetaJ = std::max(glm::dot(getBoxNormal(intersectionLight.point, intersectionLight.intersectedObjectId), -connectionRay.direction), 0.0f);
+				float rSquared = connectionIntersection.t * connectionIntersection.t;
+
+				color += (liCamera * attenuationCamera / getMaterialPdf(materialTypeCamera)) * (liLight * attenuationLight / getMaterialPdf(materialTypeLight)) * cosThetaI * cosThetaJ / rSquared / lightSourcePdf;
+				color /= 2.0f * i;
+			}
+		}
+
+		if (intersectionCamera.hit) {
+			float cos = 1.0f;
+
+			if (materialTypeCamera != 1) {
+				cos = std::max(glm::dot(getBoxNormal(intersectionCamera.point, intersectionCamera.intersectedObjectId), rayOutCamera.direction), 0.0f);
+			}
+
+			liCamera *= attenuationCamera * cos / getMaterialPdf(materialTypeCamera);
+
+			int boxType = getBoxType(intersectionCamera.intersectedObjectId);
+
+			if (glm::length(getEmission(boxType)) > 0.0f) {
+				liCamera += getEmission(boxType) * glm::vec3(sampleTexture(intersectionCamera.point, intersectionCamera.intersectedObjectId, boxType));
+				color += liCamera;
+			}
+		} else {
+			color += liCamera * attenuationCamera;
+			return color;
+		}
+
+		if (intersectionLight.hit) {
+			float cos = 1.0f;
+
+			if (materialTypeLight != 1) {
+				cos = std::max(glm::dot(getBoxNormal(intersectionLight.point, intersectionLight.intersectedObjectId), rayOutLight.direction), 0.0f);
+			}
+
+			liLight *= attenuationLight * cos / getMaterialPdf(materialTypeLight);
+		} else {
+			return color;
+		}
+
+		if (!scatteredCamera || !scatteredLight) {
+			break;
+		}
+
+		rayInCamera = rayOutCamera;
+		rayInLight = rayOutLight;
+	}
+
+	return color;
+}
+
+glm::vec3 CpuPathTracer::li(PixelContext &context, Ray const &ray) const {
+	switch (cd.iData.x) {
+	case 0:
+		return intersectionIntegrator(context, ray);
+	case 1:
+		return normalIntegrator(context, ray);
+	case 2:
+		return diffuseColorIntegrator(context, ray);
+	case 3:
+		return uvIntegrator(context, ray);
+	case 4:
+		return textureIntegrator(context, ray);
+	case 5:
+		return ambientOcclusionIntegrator(context, ray);
+	case 6:
+		return whittedIntegrator(context, ray);
+	case 7:
+		return distributedIntegrator(context, ray);
+	case 8:
+		return timsPathTraceIntegrator(context, ray);
+	case 9:
+		return pathTraceNEEIntegrator(context, ray);
+	case 10:
+		return bidirectionalPathTraceIntegrator(context, ray);
+	default:
+		return glm::vec3(0.0f);
+	}
+}
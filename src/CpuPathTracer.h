@@ -0,0 +1,161 @@
+#ifndef CPUPATHTRACER_H
+#define CPUPATHTRACER_H
+
+#include "BoxData.h"
+#include "BvhNode.h"
+#include "Denoiser.h"
+#include "PointLight.h"
+#include "TextureArray.h"
+#include "SkyBox.h"
+#include "Settings.h"
+
+#include "glm/glm.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//CPU port of the integrators and the camera of shaders/compute.comp over the same boxes and lights
+//Used as reference for the shader on machines without a GPU and as offline renderer with a high sample count
+class CpuPathTracer {
+public:
+	//The textures are read from the same files as the TextureArray and the SkyBox, so no device is needed
+	CpuPathTracer(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights);
+
+	~CpuPathTracer();
+
+	//Same inputs as ComputeWrapper::updateCameraData, iData.x selects the integrator and iData.z scales the sensor
+	//The image holds the mean of all samples per pixel, row 0 is the top row like in the storage image of the shader
+	//The variance is the one of the mean luminance per pixel like the denoiser reads it from the accumulation of the shader
+	void render(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::ivec4 const &iData, int const width, int const height, int const samples, std::vector<glm::vec3> &image, std::vector<float> &variance);
+
+	//First hits through the pixel centres of the view of the last render, like writeGBuffer of the shader
+	void renderGBuffer(std::vector<GBufferTexel> &gBuffer);
+
+	//Filters a render with few samples like the photo mode shows it after a handful of frames and compares both against the reference
+	//Writes the filtered image to ComputeSettings::CPU_DENOISED_IMAGE_PATH, the reference is a render of the same view with more samples
+	void validateDenoiser(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::ivec4 const &iData, std::vector<glm::vec3> const &reference);
+
+	//Binary PPM, the colors are clamped like in the rgba8 storage image
+	static void writeImage(char const *filePath, std::vector<glm::vec3> const &image, int const width, int const height);
+
+	//Rays generated by the last render, counted like raysGenerated in the shader
+	uint64_t getRayCount() const;
+
+	double getRenderMilliseconds() const;
+
+private:
+	struct Ray {
+		glm::vec3 origin;
+		glm::vec3 direction;
+	};
+
+	struct Intersection {
+		bool hit;
+		glm::vec3 point;
+		Ray rayIn;
+		float t;
+		int intersectedObjectId;
+	};
+
+	//Per pixel state, takes the place of gold_noise and raysGenerated
+	struct PixelContext {
+		uint32_t state;
+		uint64_t rays;
+
+		float next();
+	};
+
+	struct CameraData {
+		glm::vec3 position;
+		glm::vec3 direction;
+		glm::vec3 up;
+		glm::vec4 sensorDimensions;
+		glm::ivec4 iData;
+		int width;
+		int height;
+	};
+
+	struct CpuTexture {
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> pixels;
+
+		//Nearest and repeating like the texture samplers of the compute shader
+		glm::vec4 sample(glm::vec2 const &uv) const;
+	};
+
+	static int const TILE_SIZE = 16;
+
+	std::vector<BoxData> boxes;
+	std::vector<BvhNode> nodes;
+	std::vector<BoxData> emissiveBoxes;
+	std::vector<PointLight> pointLights;
+
+	CpuTexture textures[Settings::TEXTURE_COUNT];
+	CpuTexture skyBoxTextures[6];
+
+	CameraData cd;
+
+	std::atomic<uint64_t> rayCount;
+	double renderMilliseconds = 0.0;
+
+	static void loadTexture(char const *filePath, CpuTexture &texture);
+
+	Ray generateRay(PixelContext &context, glm::vec3 const &origin, glm::vec3 const &direction) const;
+	Intersection getEmptyIntersection(PixelContext &context) const;
+
+	glm::vec3 getBoxPosition(int const boxID) const;
+	int getBoxType(int const boxID) const;
+	glm::vec3 getBoxNormal(glm::vec3 const &point, int const boxID) const;
+	glm::vec3 getEmissiveBoxNormal(glm::vec3 const &point, int const boxID) const;
+	static glm::vec2 getUV(glm::vec3 const &localPoint);
+	static glm::vec2 getSkyBoxUV(glm::vec3 const &point, int &side);
+
+	static void calculateLocalCoordinateSystem(glm::vec3 const &upVector, glm::vec3 &localX, glm::vec3 &localZ);
+	static glm::vec3 rotateVectorInCoordinateSystem(glm::vec3 const &vector, glm::vec3 const &x, glm::vec3 const &y, glm::vec3 const &z);
+	static glm::vec3 uniformHemisphereSample(PixelContext &context);
+	static glm::vec3 uniformBoxSample(PixelContext &context);
+	static glm::vec3 getLightIntensityAtPoint(glm::vec3 const &point, glm::vec3 const &pointOnLightSource, glm::vec3 const &emission);
+
+	bool lightSourcesAvailable() const;
+	void lightSourceIDSample(PixelContext &context, int &lightSourceID, int &lightSourceType) const;
+	int pointLightSourceIDSample(PixelContext &context) const;
+	float getLightSourcePdf() const;
+	static float getEmissiveBoxPdf();
+	static float getPointLightPdf();
+	static float getMaterialPdf(int const materialType);
+
+	Ray getCameraRay(PixelContext &context, glm::vec2 const &uvCoordinates) const;
+
+	Intersection rayAABBTest(PixelContext &context, Ray const &ray, int const boxID) const;
+	Intersection raySkyBoxTest(PixelContext &context, Ray const &ray) const;
+	float rayNodeTest(glm::vec3 const &origin, glm::vec3 const &directionInverse, int const nodeID, float const maxT) const;
+	Intersection intersectWithBoxes(PixelContext &context, Ray const &ray) const;
+	Intersection intersectWithScene(PixelContext &context, Ray const &ray) const;
+
+	glm::vec4 sampleTexture(glm::vec3 const &point, int const boxID, int type) const;
+	glm::vec4 sampleEmissiveTexture(glm::vec3 const &point, int const boxID, int type) const;
+	int getMaterialType(Intersection const &intersection) const;
+
+	bool scatterSkyBox(Intersection const &intersection, glm::vec3 &attenuation) const;
+	bool scatterRefractive(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const;
+	bool scatterLambertian(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const;
+	bool scatter(PixelContext &context, Intersection const &intersection, glm::vec3 &attenuation, Ray &rayOut) const;
+
+	glm::vec3 intersectionIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 normalIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 diffuseColorIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 uvIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 textureIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 ambientOcclusionIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 whittedIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 distributedIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 timsPathTraceIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 pathTraceNEEIntegrator(PixelContext &context, Ray const &ray) const;
+	glm::vec3 bidirectionalPathTraceIntegrator(PixelContext &context, Ray const &ray) const;
+
+	glm::vec3 li(PixelContext &context, Ray const &ray) const;
+};
+
+#endif // !CPUPATHTRACER_H
@@ -0,0 +1,21 @@
+#ifndef CULLSECTION_H
+#define CULLSECTION_H
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+
+//One draw of a chunk section as read by shaders/cull.comp, laid out for std430
+//indexCount 0 marks a free slot, the culling pass then writes an empty draw
+struct CullSection {
+	glm::vec4 minBound;
+	glm::vec4 maxBound;
+	uint32_t indexCount;
+	uint32_t firstIndex;
+	int32_t vertexOffset;
+	uint32_t firstInstance;
+};
+
+static_assert(sizeof(CullSection) == 48, "CullSection has to match the std430 layout of shaders/cull.comp");
+
+#endif // !CULLSECTION_H
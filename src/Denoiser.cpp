@@ -0,0 +1,109 @@
+#include "Denoiser.h"
+#include "ComputeSettings.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+float const Denoiser::SIGMA_NORMAL = 128.0f;
+float const Denoiser::SIGMA_PLANE = 0.25f;
+float const Denoiser::SIGMA_LUMINANCE = 4.0f;
+float const Denoiser::MIN_ALBEDO = 0.01f;
+
+Denoiser::Denoiser() {}
+
+Denoiser::~Denoiser() {}
+
+void Denoiser::denoise(int const width, int const height, std::vector<glm::vec3> const &color, std::vector<float> const &variance, std::vector<GBufferTexel> const &gBuffer, std::vector<glm::vec3> &image) {
+	size_t pixelCount = (size_t)width * height;
+
+	input.resize(pixelCount);
+	output.resize(pixelCount);
+
+	for (size_t i = 0; i < pixelCount; i++) {
+		glm::vec3 albedo = getAlbedo(gBuffer[i]);
+		float albedoLuminance = luminance(albedo);
+
+		input[i] = glm::vec4(color[i] / albedo, variance[i] / (albedoLuminance * albedoLuminance));
+	}
+
+	for (int iteration = 0; iteration < ComputeSettings::DENOISE_ITERATIONS; iteration++) {
+		filterPass(width, height, 1 << iteration, gBuffer);
+		std::swap(input, output);
+	}
+
+	image.resize(pixelCount);
+
+	for (size_t i = 0; i < pixelCount; i++) {
+		image[i] = glm::vec3(input[i]) * getAlbedo(gBuffer[i]);
+	}
+}
+
+void Denoiser::filterPass(int const width, int const height, int const stepWidth, std::vector<GBufferTexel> const &gBuffer) {
+	//B3 spline
+	float const kernel[3] = { 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+	//Every row only writes its own pixels of the output
+	ThreadPool::getInstance().parallelFor(height, [&](int y) {
+		for (int x = 0; x < width; x++) {
+			size_t pixelIndex = (size_t)y * width + x;
+
+			GBufferTexel const &centreTexel = gBuffer[pixelIndex];
+			glm::vec4 centre = input[pixelIndex];
+
+			//The sky has no edges to keep, it is left as it is and not used by its neighbours
+			if (centreTexel.albedo.w <= 0.0f) {
+				output[pixelIndex] = centre;
+				continue;
+			}
+
+			float centreLuminance = luminance(glm::vec3(centre));
+			float luminanceScale = SIGMA_LUMINANCE * std::sqrt(std::max(centre.w, 0.0f)) + 1e-4f;
+
+			glm::vec3 colorSum = glm::vec3(0.0f);
+			float varianceSum = 0.0f;
+			float weightSum = 0.0f;
+
+			for (int tapY = -2; tapY <= 2; tapY++) {
+				for (int tapX = -2; tapX <= 2; tapX++) {
+					int u = x + tapX * stepWidth;
+					int v = y + tapY * stepWidth;
+
+					if (u < 0 || v < 0 || u >= width || v >= height) {
+						continue;
+					}
+
+					size_t tapIndex = (size_t)v * width + u;
+					GBufferTexel const &tapTexel = gBuffer[tapIndex];
+
+					if (tapTexel.albedo.w <= 0.0f) {
+						continue;
+					}
+
+					glm::vec4 const &tapInput = input[tapIndex];
+
+					float weight = kernel[std::abs(tapX)] * kernel[std::abs(tapY)];
+					weight *= std::pow(std::max(glm::dot(glm::vec3(centreTexel.normalPlane), glm::vec3(tapTexel.normalPlane)), 0.0f), SIGMA_NORMAL);
+					weight *= std::exp(-std::abs(centreTexel.normalPlane.w - tapTexel.normalPlane.w) / SIGMA_PLANE);
+					weight *= std::exp(-std::abs(centreLuminance - luminance(glm::vec3(tapInput))) / luminanceScale);
+
+					colorSum += weight * glm::vec3(tapInput);
+					varianceSum += weight * weight * tapInput.w;
+					weightSum += weight;
+				}
+			}
+
+			output[pixelIndex] = glm::vec4(colorSum / weightSum, varianceSum / (weightSum * weightSum));
+		}
+		});
+}
+
+float Denoiser::luminance(glm::vec3 const &color) {
+	return glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+//The sky is not divided by anything
+glm::vec3 Denoiser::getAlbedo(GBufferTexel const &texel) {
+	return texel.albedo.w > 0.0f ? glm::max(glm::vec3(texel.albedo), glm::vec3(MIN_ALBEDO)) : glm::vec3(1.0f);
+}
@@ -0,0 +1,44 @@
+#ifndef DENOISER_H
+#define DENOISER_H
+
+#include "glm/glm.hpp"
+
+#include <vector>
+
+//First hit of the ray through the pixel centre, same layout as GBufferTexel of shaders/compute.comp
+struct GBufferTexel {
+	//Normal of the hit face in xyz, distance of its plane from the origin along the normal in w, 0 for the sky
+	glm::vec4 normalPlane;
+	//Texture color in xyz, w is 1 for boxes and 0 for the sky
+	glm::vec4 albedo;
+};
+
+//CPU version of the edge aware a-trous filter of shaders/denoise.comp, checks it without a GPU
+//The color is divided by the albedo, filtered in ComputeSettings::DENOISE_ITERATIONS passes with growing gaps between the taps and multiplied with the albedo again
+//Taps are weighted by a B3 spline, by how well normal and plane of their first hit match and by their luminance difference relative to the standard error of the centre
+class Denoiser {
+public:
+	Denoiser();
+	~Denoiser();
+
+	//Mean color and variance of the mean luminance per pixel, row by row like the G-buffer
+	void denoise(int const width, int const height, std::vector<glm::vec3> const &color, std::vector<float> const &variance, std::vector<GBufferTexel> const &gBuffer, std::vector<glm::vec3> &image);
+
+	//Have to match the defines of shaders/denoise.comp
+	static float const SIGMA_NORMAL;
+	static float const SIGMA_PLANE;
+	static float const SIGMA_LUMINANCE;
+	static float const MIN_ALBEDO;
+
+private:
+	//Demodulated color and variance in w, swapped after every pass
+	std::vector<glm::vec4> input;
+	std::vector<glm::vec4> output;
+
+	void filterPass(int const width, int const height, int const stepWidth, std::vector<GBufferTexel> const &gBuffer);
+
+	static float luminance(glm::vec3 const &color);
+	static glm::vec3 getAlbedo(GBufferTexel const &texel);
+};
+
+#endif // !DENOISER_H
@@ -3,6 +3,7 @@
 #include "CameraData.h"
 #include "BoxData.h"
 #include "PointLight.h"
+#include "BvhNode.h"
 #include "SkyUBO.h"
 
 #include <stdexcept>
@@ -24,6 +25,9 @@ DescriptorWrapper::DescriptorWrapper(VkDevice &device, uint32_t descriptorCount)
 
 	createSkyDescriptorSetLayout();
 	createSkyDescriptorPool();
+
+	createCullDescriptorSetLayout();
+	createCullDescriptorPool();
 }
 
 DescriptorWrapper::~DescriptorWrapper() {
@@ -41,6 +45,9 @@ DescriptorWrapper::~DescriptorWrapper() {
 
 	vkDestroyDescriptorSetLayout(device, skyDescriptorSetLayout, nullptr);
 	vkDestroyDescriptorPool(device, skyDescriptorPool, nullptr);
+
+	vkDestroyDescriptorSetLayout(device, cullDescriptorSetLayout, nullptr);
+	vkDestroyDescriptorPool(device, cullDescriptorPool, nullptr);
 }
 
 void DescriptorWrapper::createDescriptorSets(std::vector<VkBuffer> const &uniformBuffers, TextureArray const &textureArray) {
@@ -149,7 +156,7 @@ void DescriptorWrapper::createQuadDescriptorSets(std::vector<VkBuffer> const &un
 	}
 }
 
-void DescriptorWrapper::createComputeDescriptorSets(std::vector<VkBuffer> const &cameraDataBuffers, VkImageView const &imageView, VkSampler const &sampler, TextureArray const &textureArray, SkyBox const &skyBox, VkBuffer const &boxDataBuffer, std::vector<BoxData> const &boxData, VkBuffer const &emissiveBoxDataBuffer, std::vector<BoxData> const &emissiveBoxData, VkBuffer const &pointLightBuffer, std::vector<PointLight> const &pointLights, VkBuffer const &writeBackDataBuffer, bool &allocated) {
+void DescriptorWrapper::createComputeDescriptorSets(std::vector<VkBuffer> const &cameraDataBuffers, VkImageView const &imageView, VkSampler const &sampler, TextureArray const &textureArray, SkyBox const &skyBox, VkBuffer const &boxDataBuffer, std::vector<BoxData> const &boxData, VkBuffer const &emissiveBoxDataBuffer, std::vector<BoxData> const &emissiveBoxData, VkBuffer const &pointLightBuffer, std::vector<PointLight> const &pointLights, VkBuffer const &writeBackDataBuffer, VkBuffer const &bvhNodeBuffer, size_t const bvhNodeCount, VkBuffer const &voxelBuffer, VkDeviceSize const voxelBufferSize, VkBuffer const &brickBuffer, VkDeviceSize const brickBufferSize, VkBuffer const &accumulationBuffer, VkDeviceSize const accumulationBufferSize, VkBuffer const &tileBuffer, VkDeviceSize const tileBufferSize, VkBuffer const &wavefrontPathBuffer, VkDeviceSize const wavefrontPathBufferSize, VkBuffer const &wavefrontQueueBuffer, VkDeviceSize const wavefrontQueueBufferSize, VkBuffer const &lightGridBuffer, VkDeviceSize const lightGridBufferSize, VkBuffer const &gBufferBuffer, VkDeviceSize const gBufferBufferSize, VkBuffer const &denoiseBuffer, VkDeviceSize const denoiseBufferSize, bool &allocated) {
 	if (!allocated) {
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts(descriptorCount, computeDescriptorSetLayout);
 
@@ -220,8 +227,58 @@ void DescriptorWrapper::createComputeDescriptorSets(std::vector<VkBuffer> const
 		descriptorWriteBackDataBufferInfo.offset = 0;
 		descriptorWriteBackDataBufferInfo.range = sizeof(WriteBackData);
 
+		VkDescriptorBufferInfo descriptorBvhNodeBufferInfo{};
+		descriptorBvhNodeBufferInfo.buffer = bvhNodeBuffer;
+		descriptorBvhNodeBufferInfo.offset = 0;
+		descriptorBvhNodeBufferInfo.range = sizeof(BvhNode) * bvhNodeCount;
+
+		VkDescriptorBufferInfo descriptorVoxelBufferInfo{};
+		descriptorVoxelBufferInfo.buffer = voxelBuffer;
+		descriptorVoxelBufferInfo.offset = 0;
+		descriptorVoxelBufferInfo.range = voxelBufferSize;
+
+		VkDescriptorBufferInfo descriptorBrickBufferInfo{};
+		descriptorBrickBufferInfo.buffer = brickBuffer;
+		descriptorBrickBufferInfo.offset = 0;
+		descriptorBrickBufferInfo.range = brickBufferSize;
+
+		VkDescriptorBufferInfo descriptorAccumulationBufferInfo{};
+		descriptorAccumulationBufferInfo.buffer = accumulationBuffer;
+		descriptorAccumulationBufferInfo.offset = 0;
+		descriptorAccumulationBufferInfo.range = accumulationBufferSize;
+
+		VkDescriptorBufferInfo descriptorTileBufferInfo{};
+		descriptorTileBufferInfo.buffer = tileBuffer;
+		descriptorTileBufferInfo.offset = 0;
+		descriptorTileBufferInfo.range = tileBufferSize;
+
+		VkDescriptorBufferInfo descriptorWavefrontPathBufferInfo{};
+		descriptorWavefrontPathBufferInfo.buffer = wavefrontPathBuffer;
+		descriptorWavefrontPathBufferInfo.offset = 0;
+		descriptorWavefrontPathBufferInfo.range = wavefrontPathBufferSize;
+
+		VkDescriptorBufferInfo descriptorWavefrontQueueBufferInfo{};
+		descriptorWavefrontQueueBufferInfo.buffer = wavefrontQueueBuffer;
+		descriptorWavefrontQueueBufferInfo.offset = 0;
+		descriptorWavefrontQueueBufferInfo.range = wavefrontQueueBufferSize;
+
+		VkDescriptorBufferInfo descriptorLightGridBufferInfo{};
+		descriptorLightGridBufferInfo.buffer = lightGridBuffer;
+		descriptorLightGridBufferInfo.offset = 0;
+		descriptorLightGridBufferInfo.range = lightGridBufferSize;
+
+		VkDescriptorBufferInfo descriptorGBufferBufferInfo{};
+		descriptorGBufferBufferInfo.buffer = gBufferBuffer;
+		descriptorGBufferBufferInfo.offset = 0;
+		descriptorGBufferBufferInfo.range = gBufferBufferSize;
+
+		VkDescriptorBufferInfo descriptorDenoiseBufferInfo{};
+		descriptorDenoiseBufferInfo.buffer = denoiseBuffer;
+		descriptorDenoiseBufferInfo.offset = 0;
+		descriptorDenoiseBufferInfo.range = denoiseBufferSize;
+
 		//Creating the write descriptor sets structs, which will be filled with the above created infos, after that they get written into the descriptor sets
-		std::array<VkWriteDescriptorSet, 8> writeDescriptorSets{};
+		std::array<VkWriteDescriptorSet, 18> writeDescriptorSets{};
 		writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 		writeDescriptorSets[0].dstSet = computeDescriptorSets[i];
 		writeDescriptorSets[0].dstBinding = 0;
@@ -286,6 +343,86 @@ void DescriptorWrapper::createComputeDescriptorSets(std::vector<VkBuffer> const
 		writeDescriptorSets[7].descriptorCount = 1;
 		writeDescriptorSets[7].pBufferInfo = &descriptorWriteBackDataBufferInfo;
 
+		writeDescriptorSets[8].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[8].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[8].dstBinding = 50;
+		writeDescriptorSets[8].dstArrayElement = 0;
+		writeDescriptorSets[8].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[8].descriptorCount = 1;
+		writeDescriptorSets[8].pBufferInfo = &descriptorBvhNodeBufferInfo;
+
+		writeDescriptorSets[9].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[9].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[9].dstBinding = 51;
+		writeDescriptorSets[9].dstArrayElement = 0;
+		writeDescriptorSets[9].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[9].descriptorCount = 1;
+		writeDescriptorSets[9].pBufferInfo = &descriptorVoxelBufferInfo;
+
+		writeDescriptorSets[10].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[10].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[10].dstBinding = 52;
+		writeDescriptorSets[10].dstArrayElement = 0;
+		writeDescriptorSets[10].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[10].descriptorCount = 1;
+		writeDescriptorSets[10].pBufferInfo = &descriptorBrickBufferInfo;
+
+		writeDescriptorSets[11].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[11].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[11].dstBinding = 53;
+		writeDescriptorSets[11].dstArrayElement = 0;
+		writeDescriptorSets[11].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[11].descriptorCount = 1;
+		writeDescriptorSets[11].pBufferInfo = &descriptorAccumulationBufferInfo;
+
+		writeDescriptorSets[12].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[12].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[12].dstBinding = 54;
+		writeDescriptorSets[12].dstArrayElement = 0;
+		writeDescriptorSets[12].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[12].descriptorCount = 1;
+		writeDescriptorSets[12].pBufferInfo = &descriptorTileBufferInfo;
+
+		writeDescriptorSets[13].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[13].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[13].dstBinding = 55;
+		writeDescriptorSets[13].dstArrayElement = 0;
+		writeDescriptorSets[13].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[13].descriptorCount = 1;
+		writeDescriptorSets[13].pBufferInfo = &descriptorWavefrontPathBufferInfo;
+
+		writeDescriptorSets[14].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[14].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[14].dstBinding = 56;
+		writeDescriptorSets[14].dstArrayElement = 0;
+		writeDescriptorSets[14].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[14].descriptorCount = 1;
+		writeDescriptorSets[14].pBufferInfo = &descriptorWavefrontQueueBufferInfo;
+
+		writeDescriptorSets[15].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[15].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[15].dstBinding = 57;
+		writeDescriptorSets[15].dstArrayElement = 0;
+		writeDescriptorSets[15].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[15].descriptorCount = 1;
+		writeDescriptorSets[15].pBufferInfo = &descriptorLightGridBufferInfo;
+
+		writeDescriptorSets[16].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[16].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[16].dstBinding = 58;
+		writeDescriptorSets[16].dstArrayElement = 0;
+		writeDescriptorSets[16].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[16].descriptorCount = 1;
+		writeDescriptorSets[16].pBufferInfo = &descriptorGBufferBufferInfo;
+
+		writeDescriptorSets[17].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[17].dstSet = computeDescriptorSets[i];
+		writeDescriptorSets[17].dstBinding = 59;
+		writeDescriptorSets[17].dstArrayElement = 0;
+		writeDescriptorSets[17].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[17].descriptorCount = 1;
+		writeDescriptorSets[17].pBufferInfo = &descriptorDenoiseBufferInfo;
+
 		vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 	}
 }
@@ -410,6 +547,119 @@ void DescriptorWrapper::createSkyDescriptorSets(std::vector<VkBuffer> const &uni
 	}
 }
 
+void DescriptorWrapper::createCullDescriptorSets() {
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts(descriptorCount, cullDescriptorSetLayout);
+
+	//Creating the descriptor set allocate info struct, which will be passed as argument to the allocateDescriptorSets call
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = cullDescriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = descriptorCount;
+	descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayouts.data();
+
+	cullDescriptorSets.resize(descriptorCount);
+	if (vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, cullDescriptorSets.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate cull descriptor sets");
+	}
+}
+
+void DescriptorWrapper::updateCullDescriptorSet(size_t const index, VkBuffer const &sectionBuffer, VkBuffer const &drawBuffer, VkBuffer const &visibilityBuffer) {
+	//The buffers are bound whole, the shader only reads the sections up to the pushed section count
+	VkDescriptorBufferInfo sectionBufferInfo{};
+	sectionBufferInfo.buffer = sectionBuffer;
+	sectionBufferInfo.offset = 0;
+	sectionBufferInfo.range = VK_WHOLE_SIZE;
+
+	VkDescriptorBufferInfo drawBufferInfo{};
+	drawBufferInfo.buffer = drawBuffer;
+	drawBufferInfo.offset = 0;
+	drawBufferInfo.range = VK_WHOLE_SIZE;
+
+	VkDescriptorBufferInfo visibilityBufferInfo{};
+	visibilityBufferInfo.buffer = visibilityBuffer;
+	visibilityBufferInfo.offset = 0;
+	visibilityBufferInfo.range = VK_WHOLE_SIZE;
+
+	std::array<VkWriteDescriptorSet, 3> writeDescriptorSets{};
+	writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSets[0].dstSet = cullDescriptorSets[index];
+	writeDescriptorSets[0].dstBinding = 0;
+	writeDescriptorSets[0].dstArrayElement = 0;
+	writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	writeDescriptorSets[0].descriptorCount = 1;
+	writeDescriptorSets[0].pBufferInfo = &sectionBufferInfo;
+
+	writeDescriptorSets[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSets[1].dstSet = cullDescriptorSets[index];
+	writeDescriptorSets[1].dstBinding = 1;
+	writeDescriptorSets[1].dstArrayElement = 0;
+	writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	writeDescriptorSets[1].descriptorCount = 1;
+	writeDescriptorSets[1].pBufferInfo = &drawBufferInfo;
+
+	writeDescriptorSets[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSets[2].dstSet = cullDescriptorSets[index];
+	writeDescriptorSets[2].dstBinding = 2;
+	writeDescriptorSets[2].dstArrayElement = 0;
+	writeDescriptorSets[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	writeDescriptorSets[2].descriptorCount = 1;
+	writeDescriptorSets[2].pBufferInfo = &visibilityBufferInfo;
+
+	vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+}
+
+void DescriptorWrapper::createCullDescriptorSetLayout() {
+	//Section table read by the culling pass
+	VkDescriptorSetLayoutBinding sectionBinding{};
+	sectionBinding.binding = 0;
+	sectionBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	sectionBinding.descriptorCount = 1;
+	sectionBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	//Indirect draw commands written by the culling pass
+	VkDescriptorSetLayoutBinding drawBinding{};
+	drawBinding.binding = 1;
+	drawBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	drawBinding.descriptorCount = 1;
+	drawBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	//Visibility bits of the occlusion culling
+	VkDescriptorSetLayoutBinding visibilityBinding{};
+	visibilityBinding.binding = 2;
+	visibilityBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	visibilityBinding.descriptorCount = 1;
+	visibilityBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding descriptorSetLayoutBindings[] = { sectionBinding, drawBinding, visibilityBinding };
+
+	//Creating the descriptor set layout create info struct, which will be passed as argument to the CreateDescriptorSetLayout call
+	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
+	descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descriptorSetLayoutCreateInfo.bindingCount = 3;
+	descriptorSetLayoutCreateInfo.pBindings = descriptorSetLayoutBindings;
+
+	if (vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, nullptr, &cullDescriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create cull descriptor set layout");
+	}
+}
+
+void DescriptorWrapper::createCullDescriptorPool() {
+	VkDescriptorPoolSize storageBufferPoolSize{};
+	storageBufferPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	storageBufferPoolSize.descriptorCount = 3 * descriptorCount;
+
+	//Creating the descriptor pool create info struct, which will be passed as argument to the CreateDescriptorPool call
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
+	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.poolSizeCount = 1;
+	descriptorPoolCreateInfo.pPoolSizes = &storageBufferPoolSize;
+	descriptorPoolCreateInfo.maxSets = descriptorCount;
+
+	if (vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, nullptr, &cullDescriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create cull descriptor pool");
+	}
+}
+
 void DescriptorWrapper::createDescriptorPool() { //descriptorPoolSize should be the swapchain image count
 
 	//Setting up the pool size for the uniform buffer object descriptor
@@ -513,12 +763,72 @@ void DescriptorWrapper::createComputeDescriptorSetLayout() {
 	computeWriteBackDataStorageBufferBinding.descriptorCount = 1;
 	computeWriteBackDataStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
-	VkDescriptorSetLayoutBinding computeDescriptorSetLayoutBindings[] = { computeUniformBufferObjectBinding, computeImageBinding, computeTextureSamplerBinding, computeSkyBoxTextureSamplerBinding, computeStorageBufferBinding, computeLightStorageBufferBinding, computePointLightStorageBufferBinding, computeWriteBackDataStorageBufferBinding };
+	VkDescriptorSetLayoutBinding computeBvhNodeStorageBufferBinding{};
+	computeBvhNodeStorageBufferBinding.binding = 50;
+	computeBvhNodeStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeBvhNodeStorageBufferBinding.descriptorCount = 1;
+	computeBvhNodeStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeVoxelStorageBufferBinding{};
+	computeVoxelStorageBufferBinding.binding = 51;
+	computeVoxelStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeVoxelStorageBufferBinding.descriptorCount = 1;
+	computeVoxelStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeBrickStorageBufferBinding{};
+	computeBrickStorageBufferBinding.binding = 52;
+	computeBrickStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeBrickStorageBufferBinding.descriptorCount = 1;
+	computeBrickStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeAccumulationStorageBufferBinding{};
+	computeAccumulationStorageBufferBinding.binding = 53;
+	computeAccumulationStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeAccumulationStorageBufferBinding.descriptorCount = 1;
+	computeAccumulationStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeTileStorageBufferBinding{};
+	computeTileStorageBufferBinding.binding = 54;
+	computeTileStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeTileStorageBufferBinding.descriptorCount = 1;
+	computeTileStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeWavefrontPathStorageBufferBinding{};
+	computeWavefrontPathStorageBufferBinding.binding = 55;
+	computeWavefrontPathStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeWavefrontPathStorageBufferBinding.descriptorCount = 1;
+	computeWavefrontPathStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeWavefrontQueueStorageBufferBinding{};
+	computeWavefrontQueueStorageBufferBinding.binding = 56;
+	computeWavefrontQueueStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeWavefrontQueueStorageBufferBinding.descriptorCount = 1;
+	computeWavefrontQueueStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeLightGridStorageBufferBinding{};
+	computeLightGridStorageBufferBinding.binding = 57;
+	computeLightGridStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeLightGridStorageBufferBinding.descriptorCount = 1;
+	computeLightGridStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeGBufferStorageBufferBinding{};
+	computeGBufferStorageBufferBinding.binding = 58;
+	computeGBufferStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeGBufferStorageBufferBinding.descriptorCount = 1;
+	computeGBufferStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeDenoiseStorageBufferBinding{};
+	computeDenoiseStorageBufferBinding.binding = 59;
+	computeDenoiseStorageBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	computeDenoiseStorageBufferBinding.descriptorCount = 1;
+	computeDenoiseStorageBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutBinding computeDescriptorSetLayoutBindings[] = { computeUniformBufferObjectBinding, computeImageBinding, computeTextureSamplerBinding, computeSkyBoxTextureSamplerBinding, computeStorageBufferBinding, computeLightStorageBufferBinding, computePointLightStorageBufferBinding, computeWriteBackDataStorageBufferBinding, computeBvhNodeStorageBufferBinding, computeVoxelStorageBufferBinding, computeBrickStorageBufferBinding, computeAccumulationStorageBufferBinding, computeTileStorageBufferBinding, computeWavefrontPathStorageBufferBinding, computeWavefrontQueueStorageBufferBinding, computeLightGridStorageBufferBinding, computeGBufferStorageBufferBinding, computeDenoiseStorageBufferBinding };
 
 	//Creating the descriptor set layout create info struct, which will be passed as argument to the CreateDescriptorSetLayout call
 	VkDescriptorSetLayoutCreateInfo computeDescriptorSetLayoutCreateInfo{};
 	computeDescriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	computeDescriptorSetLayoutCreateInfo.bindingCount = 8;
+	computeDescriptorSetLayoutCreateInfo.bindingCount = 18;
 	computeDescriptorSetLayoutCreateInfo.pBindings = computeDescriptorSetLayoutBindings;
 
 	if (vkCreateDescriptorSetLayout(device, &computeDescriptorSetLayoutCreateInfo, nullptr, &computeDescriptorSetLayout) != VK_SUCCESS) {
@@ -547,12 +857,12 @@ void DescriptorWrapper::createComputeDescriptorPool() {
 	storageBufferPoolSize.descriptorCount = descriptorCount;
 
 
-	VkDescriptorPoolSize descriptorPoolSizes[] = { uniformBufferObjectDescriptorPoolSize, computeTextureSamplerDescriptorPoolSize, textureSamplerDescriptorPoolSize, textureSamplerDescriptorPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize };
+	VkDescriptorPoolSize descriptorPoolSizes[] = { uniformBufferObjectDescriptorPoolSize, computeTextureSamplerDescriptorPoolSize, textureSamplerDescriptorPoolSize, textureSamplerDescriptorPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize, storageBufferPoolSize };
 
 	//Creating the descriptor pool create info struct, which will be passed as argument to the CreateDescriptorPool call
 	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
 	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descriptorPoolCreateInfo.poolSizeCount = 6;
+	descriptorPoolCreateInfo.poolSizeCount = 18;
 	descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes;
 	descriptorPoolCreateInfo.maxSets = descriptorCount;
 
@@ -73,7 +73,7 @@ public:
 	std::vector<VkDescriptorSet> computeDescriptorSets;
 
 	void createQuadDescriptorSets(std::vector<VkBuffer> const &uniformBuffers, VkImageView const &imageView, VkSampler const &sampler);
-	void createComputeDescriptorSets(std::vector<VkBuffer> const &cameraDataBuffers, VkImageView const &imageView, VkSampler const &sampler, TextureArray const &textureArray, SkyBox const &skyBox, VkBuffer const &boxDataBuffer, std::vector<BoxData> const &boxData, VkBuffer const &emissiveBoxDataBuffer, std::vector<BoxData> const &emissiveBoxData, VkBuffer const &pointLightBuffer, std::vector<PointLight> const &pointLights, VkBuffer const &writeBackDataBuffer, bool &allocated);
+	void createComputeDescriptorSets(std::vector<VkBuffer> const &cameraDataBuffers, VkImageView const &imageView, VkSampler const &sampler, TextureArray const &textureArray, SkyBox const &skyBox, VkBuffer const &boxDataBuffer, std::vector<BoxData> const &boxData, VkBuffer const &emissiveBoxDataBuffer, std::vector<BoxData> const &emissiveBoxData, VkBuffer const &pointLightBuffer, std::vector<PointLight> const &pointLights, VkBuffer const &writeBackDataBuffer, VkBuffer const &bvhNodeBuffer, size_t const bvhNodeCount, VkBuffer const &voxelBuffer, VkDeviceSize const voxelBufferSize, VkBuffer const &brickBuffer, VkDeviceSize const brickBufferSize, VkBuffer const &accumulationBuffer, VkDeviceSize const accumulationBufferSize, VkBuffer const &tileBuffer, VkDeviceSize const tileBufferSize, VkBuffer const &wavefrontPathBuffer, VkDeviceSize const wavefrontPathBufferSize, VkBuffer const &wavefrontQueueBuffer, VkDeviceSize const wavefrontQueueBufferSize, VkBuffer const &lightGridBuffer, VkDeviceSize const lightGridBufferSize, VkBuffer const &gBufferBuffer, VkDeviceSize const gBufferBufferSize, VkBuffer const &denoiseBuffer, VkDeviceSize const denoiseBufferSize, bool &allocated);
 
 	VkDescriptorSetLayout objDescriptorSetLayout;
 	VkDescriptorPool objDescriptorPool;
@@ -87,6 +87,15 @@ public:
 
 	void createSkyDescriptorSets(std::vector<VkBuffer> const &uniformBuffers, std::vector<VkBuffer> const &skyUniformBuffers, CloudTexture const &cloudTexture);
 
+	VkDescriptorSetLayout cullDescriptorSetLayout;
+	VkDescriptorPool cullDescriptorPool;
+	std::vector<VkDescriptorSet> cullDescriptorSets;
+
+	//The sets are only allocated here, their buffers are written with updateCullDescriptorSet once the chunk arena created them
+	void createCullDescriptorSets();
+
+	void updateCullDescriptorSet(size_t const index, VkBuffer const &sectionBuffer, VkBuffer const &drawBuffer, VkBuffer const &visibilityBuffer);
+
 private:
 	/**
 	* @brief Reference to the device, whis is need for some vulkan function calls.
@@ -118,6 +127,9 @@ private:
 
 	void createSkyDescriptorSetLayout();
 	void createSkyDescriptorPool();
+
+	void createCullDescriptorSetLayout();
+	void createCullDescriptorPool();
 };
 
 #endif // !DESCRIPTORWRAPPER_H
@@ -53,9 +53,14 @@ void DeviceFinder::createDevice(VkPhysicalDevice const &physicalDevice, QueueFam
 		deviceQueueCreateInfos.push_back(deviceQueueCreateInfo);
 	}
 
+	VkPhysicalDeviceFeatures supportedPhysicalDeviceFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedPhysicalDeviceFeatures);
+
 	//Setting up the used physical device features
 	VkPhysicalDeviceFeatures physicalDeviceFeatures{};
 	physicalDeviceFeatures.samplerAnisotropy = VK_TRUE;
+	physicalDeviceFeatures.multiDrawIndirect = supportedPhysicalDeviceFeatures.multiDrawIndirect; //Optional, the chunk arena falls back to one draw per indirect call
+	physicalDeviceFeatures.drawIndirectFirstInstance = supportedPhysicalDeviceFeatures.drawIndirectFirstInstance; //Optional, the chunk arena falls back to direct draws, the chunk origin is passed as firstInstance
 
 	//Creating the device create info struct, used to generate the device
 	VkDeviceCreateInfo deviceCreateInfo{};
@@ -211,8 +216,8 @@ QueueFamilyIndices DeviceFinder::findQueueFamilyIndices(VkSurfaceKHR const &surf
 			queueFamilyIndices.hasTransferFamily = true;
 		}
 
-		//Setting compute family index
-		if (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) {
+		//Setting compute family index, on the graphics family so the image of the photo mode needs no queue family ownership transfer between the compute and the quad pass
+		if (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
 			queueFamilyIndices.computeFamilyIndex = index;
 			queueFamilyIndices.hasComputeFamily = true;
 		}
@@ -4,6 +4,11 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_USE_SSE
+#endif
+
 Frustum::Frustum() {}
 
 Frustum::Frustum(float const farPlaneDistance, float const nearPlaneDistance, glm::vec3 const &up)
@@ -40,26 +45,23 @@ void Frustum::updateFrustum(glm::vec3 const &cameraPosition, glm::vec3 const cam
 	planes[RIGHT_PLANE] = Plane(apex, -glm::normalize(glm::cross(y, rightDirection)));
 	planes[NEAR_PLANE] = Plane(nearPlaneCenter, direction);
 	planes[FAR_PLANE] = Plane(farPlaneCenter, -direction);
+
+	for (int i = 0; i < 6; i++) {
+		planeEquations[i] = glm::vec4(planes[i].normal, -glm::dot(planes[i].normal, planes[i].origin));
+	}
 }
 
-bool Frustum::isInside(AABB const &aabb) {
+bool Frustum::isInside(AABB const &aabb) const {
 	for (int i = 0; i < 6; i++) {
-		int inCounter = 0;
-		int outCounter = 0;
-
-		for (int corner = 0; corner < 8; corner++) {
-			if (inCounter == 0 || outCounter == 0) {
-				
-				if (glm::dot(glm::normalize(aabb.corners[corner] - planes[i].origin), planes[i].normal) >= 0.0f) {
-					inCounter++;
-				}
-				else {
-					outCounter++;
-				}
-			}
-		}
+		glm::vec4 const &plane = planeEquations[i];
+
+		//The corner furthest along the normal, if it is behind the plane all other corners are as well
+		glm::vec3 positiveVertex = glm::vec3(
+			plane.x >= 0.0f ? aabb.maxB.x : aabb.minB.x,
+			plane.y >= 0.0f ? aabb.maxB.y : aabb.minB.y,
+			plane.z >= 0.0f ? aabb.maxB.z : aabb.minB.z);
 
-		if (inCounter == 0) {
+		if (glm::dot(glm::vec3(plane), positiveVertex) + plane.w < 0.0f) {
 			return false;
 		}
 	}
@@ -67,6 +69,64 @@ bool Frustum::isInside(AABB const &aabb) {
 	return true;
 }
 
+size_t Frustum::cullBatch(AABBBatch const &batch, std::vector<uint8_t> &visible) const {
+	size_t count = batch.size();
+	visible.resize(count);
+
+	//Per plane the positive vertex always takes the same min or max array, so the choice is made once instead of per box
+	float const *positiveX[6];
+	float const *positiveY[6];
+	float const *positiveZ[6];
+
+	for (int i = 0; i < 6; i++) {
+		positiveX[i] = planeEquations[i].x >= 0.0f ? batch.maxX.data() : batch.minX.data();
+		positiveY[i] = planeEquations[i].y >= 0.0f ? batch.maxY.data() : batch.minY.data();
+		positiveZ[i] = planeEquations[i].z >= 0.0f ? batch.maxZ.data() : batch.minZ.data();
+	}
+
+	size_t visibleCount = 0;
+	size_t box = 0;
+
+#ifdef FRUSTUM_USE_SSE
+	__m128 zero = _mm_setzero_ps();
+
+	for (; box + 4 <= count; box += 4) {
+		__m128 outside = _mm_setzero_ps();
+
+		for (int i = 0; i < 6; i++) {
+			__m128 distance = _mm_mul_ps(_mm_set1_ps(planeEquations[i].x), _mm_loadu_ps(positiveX[i] + box));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planeEquations[i].y), _mm_loadu_ps(positiveY[i] + box)));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planeEquations[i].z), _mm_loadu_ps(positiveZ[i] + box)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(planeEquations[i].w));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+		}
+
+		int outsideMask = _mm_movemask_ps(outside);
+
+		for (int lane = 0; lane < 4; lane++) {
+			visible[box + lane] = ((outsideMask >> lane) & 1) == 0;
+			visibleCount += visible[box + lane];
+		}
+	}
+#endif
+
+	//Remaining boxes, or all of them without SSE
+	for (; box < count; box++) {
+		bool outside = false;
+
+		for (int i = 0; i < 6; i++) {
+			float distance = planeEquations[i].x * positiveX[i][box] + planeEquations[i].y * positiveY[i][box] + planeEquations[i].z * positiveZ[i][box] + planeEquations[i].w;
+			outside |= distance < 0.0f;
+		}
+
+		visible[box] = !outside;
+		visibleCount += visible[box];
+	}
+
+	return visibleCount;
+}
+
 void Frustum::calculateDimensions() {
 	farPlaneHeight = tanf(fov * (M_PI / 180.f) / 2.0f) * farPlaneDistance;
 	farPlaneWidth = farPlaneHeight * aspectRatio;
@@ -3,9 +3,13 @@
 
 #include "Plane.h"
 #include "AABB.h"
+#include "AABBBatch.h"
 
 #include "glm/glm.hpp"
 
+#include <vector>
+#include <cstdint>
+
 #define TOP_PLANE 0
 #define BOTTOM_PLANE 1
 #define LEFT_PLANE 2
@@ -21,7 +25,10 @@ public:
 
 	void updateFrustum(glm::vec3 const &cameraPosition, glm::vec3 const cameraDirection, float const cameraFov);
 
-	bool isInside(AABB const &aabb);
+	bool isInside(AABB const &aabb) const;
+
+	//Sets visible[i] to 1 if box i is at least partially inside, returns the number of visible boxes
+	size_t cullBatch(AABBBatch const &batch, std::vector<uint8_t> &visible) const;
 
 private:
 
@@ -37,6 +44,9 @@ private:
 
 	Plane planes[6];
 
+	//Normal in xyz and the negative distance to the origin in w, so a point p is inside if dot(normal, p) + w >= 0
+	glm::vec4 planeEquations[6];
+
 	float farPlaneWidth;
 	float farPlaneHeight;
 
@@ -292,6 +292,21 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 			Settings::UPDATE_FRUSTUM = !Settings::UPDATE_FRUSTUM;
 		}
 		break;
+	case GLFW_KEY_M:
+		if (action == GLFW_PRESS) {
+			Settings::PRINT_MEMORY_STATS = true;
+		}
+		break;
+	case GLFW_KEY_C:
+		if (action == GLFW_PRESS) {
+			Settings::PRINT_CULLING_STATS = !Settings::PRINT_CULLING_STATS;
+		}
+		break;
+	case GLFW_KEY_O:
+		if (action == GLFW_PRESS) {
+			Settings::OCCLUSION_CULLING = !Settings::OCCLUSION_CULLING;
+		}
+		break;
 	case GLFW_KEY_I:
 		if (action == GLFW_PRESS) {
 			ComputeSettings::iData.x = (ComputeSettings::iData.x + 1) % ComputeSettings::integratorCount;
@@ -340,6 +355,31 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 			ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
 		}
 		break;
+	case GLFW_KEY_R:
+		if (action == GLFW_PRESS) {
+			ComputeSettings::renderCpuReference = true;
+		}
+		break;
+	case GLFW_KEY_V:
+		if (action == GLFW_PRESS) {
+			ComputeSettings::adaptiveSampling = !ComputeSettings::adaptiveSampling;
+		}
+		break;
+	case GLFW_KEY_X:
+		if (action == GLFW_PRESS) {
+			ComputeSettings::denoise = !ComputeSettings::denoise;
+		}
+		break;
+	case GLFW_KEY_N:
+		if (action == GLFW_PRESS) {
+			ComputeSettings::iData.w ^= ComputeSettings::WAVEFRONT_FLAG;
+		}
+		break;
+	case GLFW_KEY_L:
+		if (action == GLFW_PRESS) {
+			ComputeSettings::iData.w ^= ComputeSettings::UNIFORM_LIGHTS_FLAG;
+		}
+		break;
 	default:
 		//std::cout << " KEY Action : " << actionName << " action : " << action << " scancode: " << scancode << " mods: " << mods << std::endl;
 		break;
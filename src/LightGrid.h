@@ -0,0 +1,29 @@
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+//Light of a cell with the CDF over the lights of the cell up to and including it
+//The emissive boxes come first, point light i has the index emissive box count + i
+struct LightGridEntry {
+	int32_t light;
+	float cdf;
+};
+
+//Grid of light CDFs for the light sampling of shaders/compute.comp, origin and size are uploaded in front of the entries
+struct LightGrid {
+	//Lower corner of cell 0, 0, 0 in xyz, edge length of the cells in w
+	glm::vec4 origin = glm::vec4(0.0f);
+
+	//Cells per axis, x 0 leaves the path tracer on uniform light sampling
+	glm::ivec4 size = glm::ivec4(0);
+
+	//ComputeSettings::LIGHT_GRID_CELL_LIGHTS entries per cell, cell (x, y, z) starts at ((x * size.z + z) * size.y + y) * LIGHT_GRID_CELL_LIGHTS
+	//A cell without lights close to it starts with light -1, the ones with fewer lights repeat the last one with a CDF of 1
+	std::vector<LightGridEntry> entries;
+};
+
+#endif // !LIGHTGRID_H
@@ -0,0 +1,140 @@
+#include "LightGridBuilder.h"
+#include "ComputeSettings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	//All glowing cube types of shaders/compute.comp emit the same, seen through about one face
+	float const BOX_POWER = 10.0f;
+	float const M_PI_F = 3.1415926538f;
+}
+
+LightGridBuilder::LightGridBuilder() {}
+
+LightGridBuilder::~LightGridBuilder() {}
+
+void LightGridBuilder::build(std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights, LightGrid &lightGrid) {
+	lightGrid = LightGrid();
+	lights.clear();
+
+	for (size_t i = 0; i < emissiveBoxData.size(); i++) {
+		lights.push_back({ emissiveBoxData[i].position, BOX_POWER });
+	}
+
+	//getLightIntensityAtPoint spreads the intensity over the sphere
+	for (size_t i = 0; i < pointLights.size(); i++) {
+		float luminance = glm::dot(glm::vec3(pointLights[i].intensity), glm::vec3(0.2126f, 0.7152f, 0.0722f));
+		lights.push_back({ glm::vec3(pointLights[i].position), luminance / (4.0f * M_PI_F) });
+	}
+
+	if (lights.empty()) {
+		return;
+	}
+
+	float cellSize = (float)ComputeSettings::LIGHT_GRID_CELL_SIZE;
+	int radius = ComputeSettings::LIGHT_GRID_RADIUS;
+
+	glm::vec3 minBound = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 maxBound = glm::vec3(-std::numeric_limits<float>::max());
+
+	for (size_t i = 0; i < lights.size(); i++) {
+		minBound = glm::min(minBound, lights[i].position);
+		maxBound = glm::max(maxBound, lights[i].position);
+	}
+
+	//The radius around the lights is covered, points further out use the closest cell
+	glm::vec3 origin = glm::floor(minBound / cellSize) * cellSize - (float)radius * cellSize;
+	glm::ivec3 size = glm::ivec3(glm::floor((maxBound - origin) / cellSize)) + glm::ivec3(1 + radius);
+
+	lightGrid.origin = glm::vec4(origin, cellSize);
+	lightGrid.size = glm::ivec4(size, 0);
+
+	size_t cellCount = (size_t)size.x * size.y * size.z;
+
+	cellLights.assign(cellCount, std::vector<int32_t>());
+
+	for (size_t i = 0; i < lights.size(); i++) {
+		glm::ivec3 cell = glm::ivec3(glm::floor((lights[i].position - origin) / cellSize));
+		cellLights[getCellIndex(lightGrid.size, cell)].push_back((int32_t)i);
+	}
+
+	lightGrid.entries.resize(cellCount * ComputeSettings::LIGHT_GRID_CELL_LIGHTS);
+
+	std::vector<Candidate> candidates;
+
+	for (int x = 0; x < size.x; x++) {
+		for (int z = 0; z < size.z; z++) {
+			for (int y = 0; y < size.y; y++) {
+				fillCell(lightGrid, glm::ivec3(x, y, z), candidates);
+			}
+		}
+	}
+
+	cellLights.clear();
+}
+
+void LightGridBuilder::fillCell(LightGrid &lightGrid, glm::ivec3 const &cell, std::vector<Candidate> &candidates) const {
+	int radius = ComputeSettings::LIGHT_GRID_RADIUS;
+	int cellLightCount = ComputeSettings::LIGHT_GRID_CELL_LIGHTS;
+
+	glm::vec3 centre = glm::vec3(lightGrid.origin) + (glm::vec3(cell) + 0.5f) * lightGrid.origin.w;
+
+	//Lights inside the cell are about this far from its points on average, so they do not take all of the CDF
+	float minDistanceSquare = lightGrid.origin.w * lightGrid.origin.w / 4.0f;
+
+	candidates.clear();
+
+	glm::ivec3 minCell = glm::max(cell - radius, glm::ivec3(0));
+	glm::ivec3 maxCell = glm::min(cell + radius, glm::ivec3(lightGrid.size) - 1);
+
+	for (int x = minCell.x; x <= maxCell.x; x++) {
+		for (int z = minCell.z; z <= maxCell.z; z++) {
+			for (int y = minCell.y; y <= maxCell.y; y++) {
+				std::vector<int32_t> const &neighbourLights = cellLights[getCellIndex(lightGrid.size, glm::ivec3(x, y, z))];
+
+				for (size_t i = 0; i < neighbourLights.size(); i++) {
+					glm::vec3 offset = lights[neighbourLights[i]].position - centre;
+					float distanceSquare = glm::dot(offset, offset);
+
+					candidates.push_back({ neighbourLights[i], lights[neighbourLights[i]].power / std::max(distanceSquare, minDistanceSquare) });
+				}
+			}
+		}
+	}
+
+	LightGridEntry *entries = &lightGrid.entries[(size_t)getCellIndex(lightGrid.size, cell) * cellLightCount];
+
+	if (candidates.empty()) {
+		std::fill(entries, entries + cellLightCount, LightGridEntry{ -1, 1.0f });
+		return;
+	}
+
+	size_t count = std::min(candidates.size(), (size_t)cellLightCount);
+
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](Candidate const &a, Candidate const &b) {
+		return a.weight > b.weight;
+		});
+
+	float weightSum = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		weightSum += candidates[i].weight;
+	}
+
+	float cdf = 0.0f;
+
+	for (size_t i = 0; i < (size_t)cellLightCount; i++) {
+		if (i < count) {
+			cdf += candidates[i].weight / weightSum;
+		}
+
+		//The last light ends at exactly 1, so the search in the shader always stops at a light of the cell
+		entries[i].light = candidates[std::min(i, count - 1)].light;
+		entries[i].cdf = i + 1 >= count ? 1.0f : cdf;
+	}
+}
+
+int LightGridBuilder::getCellIndex(glm::ivec4 const &size, glm::ivec3 const &cell) {
+	return (cell.x * size.z + cell.z) * size.y + cell.y;
+}
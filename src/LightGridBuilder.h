@@ -0,0 +1,42 @@
+#ifndef LIGHTGRIDBUILDER_H
+#define LIGHTGRIDBUILDER_H
+
+#include "BoxData.h"
+#include "PointLight.h"
+#include "LightGrid.h"
+
+#include "glm/glm.hpp"
+
+#include <vector>
+
+//Builds the light grid over the lights of the photo mode, every cell keeps the lights with the largest estimated contribution to it
+//The estimate is the power of a light over the squared distance to the cell centre, occlusion and orientation are left out
+class LightGridBuilder {
+public:
+	LightGridBuilder();
+	~LightGridBuilder();
+
+	void build(std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights, LightGrid &lightGrid);
+
+private:
+	struct Light {
+		glm::vec3 position;
+		float power;
+	};
+
+	struct Candidate {
+		int32_t light;
+		float weight;
+	};
+
+	std::vector<Light> lights;
+
+	//Indices into lights per cell, only used while building
+	std::vector<std::vector<int32_t>> cellLights;
+
+	void fillCell(LightGrid &lightGrid, glm::ivec3 const &cell, std::vector<Candidate> &candidates) const;
+
+	static int getCellIndex(glm::ivec4 const &size, glm::ivec3 const &cell);
+};
+
+#endif // !LIGHTGRIDBUILDER_H
@@ -1,9 +1,12 @@
 #include "LoadedChunkStack.h"
 #include "BigVertex.h"
+#include "ChunkVertex.h"
+#include "SectionVisibility.h"
 
 #include "glm/gtx/rotate_vector.hpp"
 
 #include <iostream>
+#include <algorithm>
 #include <queue>
 
 LoadedChunkStack::LoadedChunkStack(VulkanWrapper &vulkanWrapper, ObjArray *objArray)
@@ -12,9 +15,18 @@ LoadedChunkStack::LoadedChunkStack(VulkanWrapper &vulkanWrapper, ObjArray *objAr
 	updateHeight();
 }
 
+LoadedChunkStack::LoadedChunkStack(ObjArray *objArray)
+	: vulkanWrapper(nullptr), objArray(objArray) {
+	chunkStack = ChunkStack();
+	updateHeight();
+}
+
 LoadedChunkStack::~LoadedChunkStack() {}
 
-void LoadedChunkStack::generateVulkanChunks() {
+void LoadedChunkStack::generateVulkanChunks(std::function<void()> onMeshed) {
+	//Held until all uploads are queued, so an early finished upload can not mark the stack ready
+	pendingUploads = 1;
+
 	updateHeight();
 	for (int y = 0; y < chunkStack.stack.size(); y++) {
 		generateVulkanChunk(y);
@@ -25,7 +37,11 @@ void LoadedChunkStack::generateVulkanChunks() {
 
 	aabb = AABB(minB, maxB);
 
-	chunkStackReady = true;
+	if (onMeshed) {
+		onMeshed();
+	}
+
+	uploadFinished();
 }
 
 void LoadedChunkStack::deleteVulkanChunks() {
@@ -35,32 +51,57 @@ void LoadedChunkStack::deleteVulkanChunks() {
 	}
 }
 
+void LoadedChunkStack::generateVisibilityData() {
+	updateHeight();
+
+	for (size_t y = 0; y < chunkStack.stack.size(); y++) {
+		Chunk const &chunk = chunkStack.stack[y];
+
+		sectionConnectivity[y] = SectionVisibility::calculateConnectivity(chunk);
+		chunkIndexCount[y] = 0;
+
+		for (size_t x = 0; x < Settings::CHUNK_SIZE && chunkIndexCount[y] == 0; x++) {
+			for (size_t j = 0; j < Settings::CHUNK_SIZE && chunkIndexCount[y] == 0; j++) {
+				for (size_t z = 0; z < Settings::CHUNK_SIZE; z++) {
+					if (chunk.cubes[x][j][z].cubeType != CubeType::AIR) {
+						chunkIndexCount[y] = 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	chunkStackReady = true;
+}
+
+void LoadedChunkStack::generateSectionBoxData() {
+	updateHeight();
+
+	for (size_t y = 0; y < chunkStack.stack.size(); y++) {
+		sectionBoxData[y].clear();
+		sectionEmissiveBoxData[y].clear();
+
+		generateSectionBoxData((int)y);
+	}
+}
+
 void LoadedChunkStack::generateBoxData(std::vector<BoxData> &boxData, std::vector<BoxData> &emissiveBoxData) {
-	int size = boxData.size();
+	for (size_t y = 0; y < sectionBoxData.size(); y++) {
+		boxData.insert(boxData.end(), sectionBoxData[y].begin(), sectionBoxData[y].end());
+		emissiveBoxData.insert(emissiveBoxData.end(), sectionEmissiveBoxData[y].begin(), sectionEmissiveBoxData[y].end());
+	}
+}
 
+void LoadedChunkStack::generateEmissiveBoxData(std::vector<BoxData> &emissiveBoxData) {
 	for (int y = 0; y < chunkStack.stack.size(); y++) {
 		for (int u = 0; u < Settings::CHUNK_SIZE; u++) {
 			for (int w = 0; w < Settings::CHUNK_SIZE; w++) {
 				for (int v = 0; v < Settings::CHUNK_SIZE; v++) {
+					CubeType cubeType = chunkStack.stack[y].cubes[u][w][v].cubeType;
 
-					//If cube is visible from atleast one side add its data
-					if (!cullCube(u, w, v, y)) {
-						Cube cube = chunkStack.stack[y].cubes[u][w][v];
-						float xPosition = chunkStack.coordinates.x;
-						float zPosition = chunkStack.coordinates.z;
-
-						glm::vec3 position = glm::vec3(u + xPosition * Settings::CHUNK_SIZE, v + y * Settings::CHUNK_SIZE, w + zPosition * Settings::CHUNK_SIZE);
-
-						boxData.push_back({ position, cube.cubeType });
-
-						if (cube.cubeType == CubeType::ACACIA_LOG ||
-							cube.cubeType == CubeType::BIRCH_LOG ||
-							cube.cubeType == CubeType::CACTUS ||
-							cube.cubeType == CubeType::DARK_OAK_LOG ||
-							cube.cubeType == CubeType::OAK_LOG ||
-							cube.cubeType == CubeType::SPRUCE_LOG) {
-							emissiveBoxData.push_back({ position, cube.cubeType });
-						}
+					if (isEmissive(cubeType) && !cullCube(u, w, v, y)) {
+						emissiveBoxData.push_back({ glm::vec3(u + chunkStack.coordinates.x * Settings::CHUNK_SIZE, v + y * Settings::CHUNK_SIZE, w + chunkStack.coordinates.z * Settings::CHUNK_SIZE), cubeType });
 					}
 				}
 			}
@@ -68,6 +109,19 @@ void LoadedChunkStack::generateBoxData(std::vector<BoxData> &boxData, std::vecto
 	}
 }
 
+void LoadedChunkStack::copyChunkStacks(LoadedChunkStack const &other) {
+	chunkStack = other.chunkStack;
+
+	leftStack = other.leftStack;
+	rightStack = other.rightStack;
+	frontStack = other.frontStack;
+	backStack = other.backStack;
+	frontLeftStack = other.frontLeftStack;
+	frontRightStack = other.frontRightStack;
+	backLeftStack = other.backLeftStack;
+	backRightStack = other.backRightStack;
+}
+
 void LoadedChunkStack::updateHeight() {
 	size_t size = chunkStack.stack.size();
 
@@ -75,6 +129,7 @@ void LoadedChunkStack::updateHeight() {
 	chunkVertexBufferMemory.resize(size);
 	chunkIndexBuffer.resize(size);
 	chunkIndexBufferMemory.resize(size);
+	chunkArenaAllocation.resize(size);
 	chunkIndexCount.resize(size);
 
 	objVertexBuffer.resize(size);
@@ -82,12 +137,19 @@ void LoadedChunkStack::updateHeight() {
 	objIndexBuffer.resize(size);
 	objIndexBufferMemory.resize(size);
 	objIndexCount.resize(size);
+
+	sectionConnectivity.resize(size);
+
+	sectionBoxData.resize(size);
+	sectionEmissiveBoxData.resize(size);
 }
 
 void LoadedChunkStack::generateVulkanChunk(int const y) {
 	calculateLightLevels();
 
-	std::vector<Vertex> vertices;
+	sectionConnectivity[y] = SectionVisibility::calculateConnectivity(chunkStack.stack[y]);
+
+	std::vector<ChunkVertex> vertices;
 	std::vector<uint32_t> indices;
 
 	std::vector<BigVertex> objVertices;
@@ -99,16 +161,25 @@ void LoadedChunkStack::generateVulkanChunk(int const y) {
 
 	int cou = 0;
 
+	sectionBoxData[y].clear();
+	sectionEmissiveBoxData[y].clear();
+
+	//Distant sections are meshed from blocks and leave out the objs
+	if (lodLevel != 0) {
+		generateLodQuads(y, cubeSideQuads);
+		generateSectionBoxData(y);
+	}
+
 	//Iterates over all cubes
-	for (int u = 0; u < Settings::CHUNK_SIZE; u++) {
+	for (int u = 0; u < Settings::CHUNK_SIZE && lodLevel == 0; u++) {
 		for (int w = 0; w < Settings::CHUNK_SIZE; w++) {
 			for (int v = 0; v < Settings::CHUNK_SIZE; v++) {
 
 				//If cube is visible from atleast one side add its data
 				if (!cullCube(u, w, v, y)) {
 					Cube cube = chunkStack.stack[y].cubes[u][w][v];
-					float xPosition = chunkStack.coordinates.x;
-					float zPosition = chunkStack.coordinates.z;
+
+					addBoxData(u, w, v, y, cube.cubeType);
 
 					std::vector<Vertex> cubeVertices;
 					cube.getVertices(cubeVertices);
@@ -116,30 +187,23 @@ void LoadedChunkStack::generateVulkanChunk(int const y) {
 					for (int side = 0; side < 6; side++) {
 						if (!cullSide(u, w, v, y, side)) {
 							cubeSideQuads[side].push_back({});
-							Vertex *sideVertices = cubeSideQuads[side][cubeSideQuads[side].size() - 1].vertices;
-							uint32_t *sideIndices = cubeSideQuads[side][cubeSideQuads[side].size() - 1].indices;
+							Quad &sideQuad = cubeSideQuads[side][cubeSideQuads[side].size() - 1];
+							Vertex *sideVertices = sideQuad.vertices;
 
 							int8_t lightLevel = getLightLevel(u, w, v, y, side);
 
 							for (int i = 0; i < 4; i++) {
 								sideVertices[i] = cubeVertices[i + side * 4];
 
-								sideVertices[i].position += glm::vec3(u + xPosition * Settings::CHUNK_SIZE, v + y * Settings::CHUNK_SIZE, w + zPosition * Settings::CHUNK_SIZE);
+								//Relative to the chunk, the chunk origin is added in the vertex shader
+								sideVertices[i].position += glm::vec3(u, v, w);
 
 								sideVertices[i].ambientOcclusionValue = calculateAmbientOcclusionValue(u, w, v, y, i + side * 4);
 
 								sideVertices[i].lightLevel = lightLevel;
 							}
 
-							bool flipped = flippedTriangles(sideVertices[0].ambientOcclusionValue, sideVertices[2].ambientOcclusionValue, sideVertices[1].ambientOcclusionValue, sideVertices[3].ambientOcclusionValue);
-
-							if (flipped) {
-								sideIndices[0] = 3;
-
-								sideIndices[3] = 0;
-								sideIndices[4] = 3;
-								sideIndices[5] = 2;
-							}
+							sideQuad.flipped = flippedTriangles(sideVertices[0].ambientOcclusionValue, sideVertices[2].ambientOcclusionValue, sideVertices[1].ambientOcclusionValue, sideVertices[3].ambientOcclusionValue);
 						}
 					}
 				}
@@ -187,19 +251,26 @@ void LoadedChunkStack::generateVulkanChunk(int const y) {
 		for (int i = 0; i < cubeSideQuads[side].size(); i++) {
 			Quad *quad = &cubeSideQuads[side][i];
 
-			vertices.insert(vertices.end(), quad->vertices, quad->vertices + 4);
+			if (lodLevel != 0) {
+				scaleLodQuad(*quad);
+			}
 
-			for (int j = 0; j < 6; j++) {
-				quad->indices[j] += sideCounter * 4;
+			//The rotated order gives the triangles (3, 1, 2) and (0, 3, 2) with the shared index pattern
+			for (int j = 0; j < 4; j++) {
+				vertices.push_back(ChunkVertex::pack(quad->vertices[quad->flipped ? Quad::FLIPPED_ORDER[j] : j]));
 			}
 
-			indices.insert(indices.end(), quad->indices, quad->indices + 6);
+			if (!Settings::SHARED_QUAD_INDICES) {
+				for (int j = 0; j < 6; j++) {
+					indices.push_back(Quad::INDICES[j] + static_cast<uint32_t>(sideCounter * 4));
+				}
+			}
 
 			sideCounter++;
 		}
 	}
 
-	chunkIndexCount[y] = static_cast<uint32_t>(indices.size());
+	chunkIndexCount[y] = static_cast<uint32_t>(sideCounter * 6);
 
 	//if (vertices.size() == 0) {
 	//	return;
@@ -210,13 +281,23 @@ void LoadedChunkStack::generateVulkanChunk(int const y) {
 
 	if (vertices.size() != 0) {
 		//Generates vulkan usable data
-		vulkanWrapper->createVulkanLoadedChunk(vertices, indices, chunkVertexBuffer[y], chunkVertexBufferMemory[y], chunkIndexBuffer[y], chunkIndexBufferMemory[y]);
+		if (Settings::DRAW_CHUNKS_INDIRECT) {
+			glm::vec3 minB;
+			glm::vec3 maxB;
+			getSectionBounds(y, minB, maxB);
+
+			pendingUploads++;
+			vulkanWrapper->createArenaLoadedChunk(vertices, indices, getChunkOrigin(y), minB, maxB, chunkArenaAllocation[y], [this] {uploadFinished(); });
+		} else {
+			vulkanWrapper->createVulkanLoadedChunk(vertices, indices, chunkVertexBuffer[y], chunkVertexBufferMemory[y], chunkIndexBuffer[y], chunkIndexBufferMemory[y]);
+		}
 	}
 
 	objIndexCount[y] = static_cast<uint32_t>(objIndices.size());
 
 	if (objVertices.size() != 0) {
-		vulkanWrapper->createVulkanObjChunk(objVertices, objIndices, objVertexBuffer[y], objVertexBufferMemory[y], objIndexBuffer[y], objIndexBufferMemory[y]);
+		pendingUploads++;
+		vulkanWrapper->createVulkanObjChunk(objVertices, objIndices, objVertexBuffer[y], objVertexBufferMemory[y], objIndexBuffer[y], objIndexBufferMemory[y], [this] {uploadFinished(); });
 	}
 
 	std::cout << cou << std::endl;
@@ -224,9 +305,31 @@ void LoadedChunkStack::generateVulkanChunk(int const y) {
 
 void LoadedChunkStack::deleteVulkanChunk(int const y) {
 	vulkanWrapper->deleteVulkanLoadedChunk(chunkVertexBuffer[y], chunkVertexBufferMemory[y], chunkIndexBuffer[y], chunkIndexBufferMemory[y]);
+	vulkanWrapper->deleteArenaLoadedChunk(chunkArenaAllocation[y]);
 	vulkanWrapper->deleteVulkanLoadedChunk(objVertexBuffer[y], objVertexBufferMemory[y], objIndexBuffer[y], objIndexBufferMemory[y]);
 }
 
+uint32_t LoadedChunkStack::getChunkOrigin(int const y) const {
+	return ChunkVertex::packChunkOrigin(chunkStack.coordinates.x, y, chunkStack.coordinates.z);
+}
+
+void LoadedChunkStack::getSectionBounds(int const y, glm::vec3 &minB, glm::vec3 &maxB) const {
+	getSectionBounds(chunkStack.coordinates.x, y, chunkStack.coordinates.z, minB, maxB);
+}
+
+void LoadedChunkStack::getSectionBounds(int const x, int const y, int const z, glm::vec3 &minB, glm::vec3 &maxB) {
+	//Cubes are centered on the integer positions, the extra half cube keeps the objs standing at the border inside
+	minB = glm::vec3(x, y, z) * (float)Settings::CHUNK_SIZE - glm::vec3(1.0f);
+	maxB = minB + glm::vec3(Settings::CHUNK_SIZE + 1.0f);
+}
+
+void LoadedChunkStack::uploadFinished() {
+	//Last access to this stack from the upload thread, it can only be removed once it is ready
+	if (--pendingUploads == 0) {
+		chunkStackReady = true;
+	}
+}
+
 bool LoadedChunkStack::cullCube(int const u, int const w, int const v, int const y) {
 	Chunk *chunk = &chunkStack.stack[y];
 	Cube cube = chunkStack.stack[y].cubes[u][w][v];
@@ -234,7 +337,7 @@ bool LoadedChunkStack::cullCube(int const u, int const w, int const v, int const
 	if (cube.cubeType != CubeType::AIR) {// && cube.cubeType != CubeType::WATER) {
 		//Left
 		if (u - 1 < 0) {
-			if (y >= leftStack.stack.size()) {
+			if (y >= leftStack.stack.size() || isBorderOpen(0)) {
 				return false;
 			}
 			else {
@@ -251,7 +354,7 @@ bool LoadedChunkStack::cullCube(int const u, int const w, int const v, int const
 
 		//Right
 		if (u + 1 >= Settings::CHUNK_SIZE) {
-			if (y >= rightStack.stack.size()) {
+			if (y >= rightStack.stack.size() || isBorderOpen(1)) {
 				return false;
 			}
 			else {
@@ -268,7 +371,7 @@ bool LoadedChunkStack::cullCube(int const u, int const w, int const v, int const
 
 		//Front
 		if (w - 1 < 0) {
-			if (y >= frontStack.stack.size()) {
+			if (y >= frontStack.stack.size() || isBorderOpen(2)) {
 				return false;
 			}
 			else {
@@ -285,7 +388,7 @@ bool LoadedChunkStack::cullCube(int const u, int const w, int const v, int const
 
 		//Back
 		if (w + 1 >= Settings::CHUNK_SIZE) {
-			if (y >= backStack.stack.size()) {
+			if (y >= backStack.stack.size() || isBorderOpen(3)) {
 				return false;
 			}
 			else {
@@ -2777,7 +2880,7 @@ bool LoadedChunkStack::cullSide(int const u, int const w, int const v, int const
 		break;
 	case 1:
 		if (w + 1 >= Settings::CHUNK_SIZE) {
-			if (y >= backStack.stack.size()) {
+			if (y >= backStack.stack.size() || isBorderOpen(3)) {
 				return false;
 			}
 			else {
@@ -2794,7 +2897,7 @@ bool LoadedChunkStack::cullSide(int const u, int const w, int const v, int const
 		break;
 	case 2:
 		if (u - 1 < 0) {
-			if (y >= leftStack.stack.size()) {
+			if (y >= leftStack.stack.size() || isBorderOpen(0)) {
 				return false;
 			}
 			else {
@@ -2828,7 +2931,7 @@ bool LoadedChunkStack::cullSide(int const u, int const w, int const v, int const
 		break;
 	case 4:
 		if (u + 1 >= Settings::CHUNK_SIZE) {
-			if (y >= rightStack.stack.size()) {
+			if (y >= rightStack.stack.size() || isBorderOpen(1)) {
 				return false;
 			}
 			else {
@@ -2845,7 +2948,7 @@ bool LoadedChunkStack::cullSide(int const u, int const w, int const v, int const
 		break;
 	case 5:
 		if (w - 1 < 0) {
-			if (y >= frontStack.stack.size()) {
+			if (y >= frontStack.stack.size() || isBorderOpen(2)) {
 				return false;
 			}
 			else {
@@ -3041,3 +3144,213 @@ void LoadedChunkStack::greedyMesh2D(std::vector<Quad> &cubeSideQuads, int const
 		std::cout << "Saved " << (q1.size() - q2.size()) * 2 << " triangles" << std::endl;
 	}*/
 }
+
+void LoadedChunkStack::generateLodQuads(int const y, std::vector<Quad> cubeSideQuads[6]) {
+	int const size = Settings::CHUNK_SIZE >> lodLevel;
+
+	std::vector<Vertex> cubeVertices;
+
+	for (int cu = 0; cu < size; cu++) {
+		for (int cw = 0; cw < size; cw++) {
+			for (int v = 0; v < size; v++) {
+				int cv = y * size + v;
+
+				CubeType cubeType = getLodCube(chunkStack, cu, cw, cv);
+				if (cubeType == CubeType::AIR) {
+					continue;
+				}
+
+				Cube(cubeType).getVertices(cubeVertices);
+
+				for (int side = 0; side < 6; side++) {
+					if (getLodNeighbour(cu, cw, cv, side) != CubeType::AIR) {
+						continue;
+					}
+
+					cubeSideQuads[side].push_back({});
+					Vertex *sideVertices = cubeSideQuads[side].back().vertices;
+
+					int8_t lightLevel = getLodLightLevel(cu, cw, cv, side);
+
+					for (int i = 0; i < 4; i++) {
+						sideVertices[i] = cubeVertices[i + side * 4];
+
+						//In blocks relative to the section, scaleLodQuad turns them into cubes
+						sideVertices[i].position += glm::vec3(cu, v, cw);
+
+						//No ambient occlusion, blocks this size would darken whole hillsides
+						sideVertices[i].ambientOcclusionValue = 3;
+
+						sideVertices[i].lightLevel = lightLevel;
+					}
+				}
+			}
+		}
+	}
+}
+
+void LoadedChunkStack::scaleLodQuad(Quad &quad) {
+	float scale = (float)(1 << lodLevel);
+
+	for (int i = 0; i < 4; i++) {
+		//Block corners lie on half integers like the cube corners, so shift them to integers before scaling
+		quad.vertices[i].position = (quad.vertices[i].position + glm::vec3(0.5f)) * scale - glm::vec3(0.5f);
+
+		//The texture repeats once per cube
+		quad.vertices[i].textureCoordinate *= scale;
+	}
+}
+
+CubeType LoadedChunkStack::getLodCube(ChunkStack const &stack, int const cu, int const cw, int const cv) {
+	int const scale = 1 << lodLevel;
+
+	if (cv < 0) {
+		return CubeType::AIR;
+	}
+
+	CubeType cubeType = CubeType::AIR;
+	int solidCount = 0;
+
+	//Top down, so the block gets the type of its surface
+	for (int height = (cv + 1) * scale - 1; height >= cv * scale; height--) {
+		size_t y = height / Settings::CHUNK_SIZE;
+		if (y >= stack.stack.size()) {
+			continue;
+		}
+
+		Chunk const &chunk = stack.stack[y];
+
+		for (int u = cu * scale; u < (cu + 1) * scale; u++) {
+			for (int w = cw * scale; w < (cw + 1) * scale; w++) {
+				CubeType type = chunk.cubes[u][w][height % Settings::CHUNK_SIZE].cubeType;
+
+				if (type != CubeType::AIR) {
+					if (solidCount == 0) {
+						cubeType = type;
+					}
+
+					solidCount++;
+				}
+			}
+		}
+	}
+
+	if (solidCount * 2 < scale * scale * scale) {
+		return CubeType::AIR;
+	}
+
+	return cubeType;
+}
+
+CubeType LoadedChunkStack::getLodNeighbour(int const cu, int const cw, int const cv, int const side) {
+	int const size = Settings::CHUNK_SIZE >> lodLevel;
+
+	switch (side) {
+	case 0:
+		return getLodCube(chunkStack, cu, cw, cv + 1);
+	case 1:
+		if (cw + 1 >= size) {
+			return isBorderOpen(3) ? CubeType::AIR : getLodCube(backStack, cu, 0, cv);
+		}
+		return getLodCube(chunkStack, cu, cw + 1, cv);
+	case 2:
+		if (cu - 1 < 0) {
+			return isBorderOpen(0) ? CubeType::AIR : getLodCube(leftStack, size - 1, cw, cv);
+		}
+		return getLodCube(chunkStack, cu - 1, cw, cv);
+	case 3:
+		return getLodCube(chunkStack, cu, cw, cv - 1);
+	case 4:
+		if (cu + 1 >= size) {
+			return isBorderOpen(1) ? CubeType::AIR : getLodCube(rightStack, 0, cw, cv);
+		}
+		return getLodCube(chunkStack, cu + 1, cw, cv);
+	case 5:
+		if (cw - 1 < 0) {
+			return isBorderOpen(2) ? CubeType::AIR : getLodCube(frontStack, cu, size - 1, cv);
+		}
+		return getLodCube(chunkStack, cu, cw - 1, cv);
+	default:
+		return CubeType::AIR;
+	}
+}
+
+int8_t LoadedChunkStack::getLodLightLevel(int const cu, int const cw, int const cv, int const side) {
+	int const scale = 1 << lodLevel;
+
+	//Same side order as cullSide, the offsets are given as u, w, v
+	int const offsets[6][3] = { {0, 0, 1}, {0, 1, 0}, {-1, 0, 0}, {0, 0, -1}, {1, 0, 0}, {0, -1, 0} };
+
+	int nu = cu + offsets[side][0];
+	int nw = cw + offsets[side][1];
+	int nv = cv + offsets[side][2];
+
+	//The light of the neighbour columns is not known here, sides facing them are mostly hidden anyway
+	if (nu < 0 || nu * scale >= Settings::CHUNK_SIZE || nw < 0 || nw * scale >= Settings::CHUNK_SIZE || nv < 0) {
+		return 15;
+	}
+
+	//Brightest air cube in the layer of the neighbouring block that touches the side
+	int uBegin = offsets[side][0] < 0 ? nu * scale + scale - 1 : nu * scale;
+	int uEnd = offsets[side][0] > 0 ? nu * scale + 1 : nu * scale + scale;
+	int wBegin = offsets[side][1] < 0 ? nw * scale + scale - 1 : nw * scale;
+	int wEnd = offsets[side][1] > 0 ? nw * scale + 1 : nw * scale + scale;
+	int vBegin = offsets[side][2] < 0 ? nv * scale + scale - 1 : nv * scale;
+	int vEnd = offsets[side][2] > 0 ? nv * scale + 1 : nv * scale + scale;
+
+	int8_t value = 0;
+
+	for (int height = vBegin; height < vEnd; height++) {
+		size_t y = height / Settings::CHUNK_SIZE;
+		if (y >= chunkStack.stack.size()) {
+			return 15;
+		}
+
+		Chunk const &chunk = chunkStack.stack[y];
+
+		for (int u = uBegin; u < uEnd; u++) {
+			for (int w = wBegin; w < wEnd; w++) {
+				if (chunk.cubes[u][w][height % Settings::CHUNK_SIZE].cubeType == CubeType::AIR) {
+					value = std::max(value, chunk.lightLevel[u][w][height % Settings::CHUNK_SIZE]);
+				}
+			}
+		}
+	}
+
+	return value;
+}
+
+bool LoadedChunkStack::isEmissive(CubeType const cubeType) {
+	return cubeType == CubeType::ACACIA_LOG ||
+		cubeType == CubeType::BIRCH_LOG ||
+		cubeType == CubeType::CACTUS ||
+		cubeType == CubeType::DARK_OAK_LOG ||
+		cubeType == CubeType::OAK_LOG ||
+		cubeType == CubeType::SPRUCE_LOG;
+}
+
+void LoadedChunkStack::addBoxData(int const u, int const w, int const v, int const y, CubeType const cubeType) {
+	glm::vec3 position = glm::vec3(u + chunkStack.coordinates.x * Settings::CHUNK_SIZE, v + y * Settings::CHUNK_SIZE, w + chunkStack.coordinates.z * Settings::CHUNK_SIZE);
+
+	sectionBoxData[y].push_back({ position, cubeType });
+
+	if (isEmissive(cubeType)) {
+		sectionEmissiveBoxData[y].push_back({ position, cubeType });
+	}
+}
+
+void LoadedChunkStack::generateSectionBoxData(int const y) {
+	for (int u = 0; u < Settings::CHUNK_SIZE; u++) {
+		for (int w = 0; w < Settings::CHUNK_SIZE; w++) {
+			for (int v = 0; v < Settings::CHUNK_SIZE; v++) {
+				if (!cullCube(u, w, v, y)) {
+					addBoxData(u, w, v, y, chunkStack.stack[y].cubes[u][w][v].cubeType);
+				}
+			}
+		}
+	}
+}
+
+bool LoadedChunkStack::isBorderOpen(int const neighbour) {
+	return neighbourLodLevels[neighbour] != lodLevel;
+}
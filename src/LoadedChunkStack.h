@@ -8,11 +8,15 @@
 #include "AABB.h"
 
 #include <atomic>
+#include <functional>
 
 class LoadedChunkStack {
 public:
 	LoadedChunkStack(VulkanWrapper &vulkanWrapper, ObjArray *objArray);
 
+	//Without a vulkan wrapper the stack can not be meshed, only generateVisibilityData and generateSectionBoxData can be used, see Benchmark
+	LoadedChunkStack(ObjArray *objArray);
+
 	~LoadedChunkStack();
 
 	/**
@@ -38,15 +42,18 @@ public:
 	bool willBeRemoved = false;
 	volatile std::atomic<int> lifeCounter = 10;
 
+	//Uploads still on their way to the GPU, chunkStackReady is only set once this drops to zero
+	std::atomic<int> pendingUploads = 0;
+
 	/**
 	 * @brief Array of the vertex buffers of the chunks.
 	 */
 	std::vector<VkBuffer> chunkVertexBuffer;
 
 	/**
-	 * @brief Array of the vertex buffer memorys of the chunks.
+	 * @brief Array of the vertex buffer memory ranges of the chunks.
 	 */
-	std::vector<VkDeviceMemory> chunkVertexBufferMemory;
+	std::vector<MemoryAllocation> chunkVertexBufferMemory;
 
 	/**
 	 * @brief Array of the index buffers of the chunks.
@@ -54,9 +61,14 @@ public:
 	std::vector<VkBuffer> chunkIndexBuffer;
 
 	/**
-	 * @brief Array of the index buffer memorys of the chunks.
+	 * @brief Array of the index buffer memory ranges of the chunks.
+	 */
+	std::vector<MemoryAllocation> chunkIndexBufferMemory;
+
+	/**
+	 * @brief Array of the mesh locations inside the chunk arena, only used if Settings::DRAW_CHUNKS_INDIRECT is set.
 	 */
-	std::vector<VkDeviceMemory> chunkIndexBufferMemory;
+	std::vector<ArenaAllocation> chunkArenaAllocation;
 
 	/**
 	 * @brief Array of the indices counts of the chunks.
@@ -64,21 +76,61 @@ public:
 	std::vector<uint32_t> chunkIndexCount;
 
 	std::vector<VkBuffer> objVertexBuffer;
-	std::vector<VkDeviceMemory> objVertexBufferMemory;
+	std::vector<MemoryAllocation> objVertexBufferMemory;
 	std::vector<VkBuffer> objIndexBuffer;
-	std::vector<VkDeviceMemory> objIndexBufferMemory;
+	std::vector<MemoryAllocation> objIndexBufferMemory;
 	std::vector<uint32_t> objIndexCount;
 
+	//Which faces of a section see each other through air, see SectionVisibility
+	std::vector<uint16_t> sectionConnectivity;
+
+	//Cubes of every section not culled by the meshing, collected with the same test for the boxes of the path tracer
+	std::vector<std::vector<BoxData>> sectionBoxData;
+	std::vector<std::vector<BoxData>> sectionEmissiveBoxData;
+
+	//Detail of the meshes, 0 meshes every cube, higher levels merge blocks of 2^lodLevel cubes per axis
+	int lodLevel = 0;
+
+	//Levels of the left, right, front and back neighbour columns at meshing time, the sides towards another level are closed so no cracks open
+	int neighbourLodLevels[4] = { 0, 0, 0, 0 };
+
+	//Stack remeshed at new levels in the background, it replaces this one once it is ready
+	LoadedChunkStack *lodReplacement = nullptr;
+
 
 	/**
 	 * @brief Generates vulkan objects and data for all chunks in loaded chunks.
+	 *
+	 * @param onMeshed Called once all sections are meshed and their box data is collected, before the stack can become ready.
 	 */
-	void generateVulkanChunks();
+	void generateVulkanChunks(std::function<void()> onMeshed = nullptr);
 
 	void deleteVulkanChunks();
 
+	//Only the connectivity of the sections without meshing them, the index count of a section with any cube is set to one so it counts as a draw
+	void generateVisibilityData();
+
+	//Box data of all sections without meshing them, for the headless reference render
+	void generateSectionBoxData();
+
+	//Appends the box data collected by the last meshing, no cube is tested again
 	void generateBoxData(std::vector<BoxData> &boxData, std::vector<BoxData> &emissiveBoxData);
 
+	//Emissive boxes for the light sampling of the path tracer, the cubes themselves are traced through the brick map
+	void generateEmissiveBoxData(std::vector<BoxData> &emissiveBoxData);
+
+	//Takes over the cubes of an already generated stack, used to remesh it at other levels without loading it again
+	void copyChunkStacks(LoadedChunkStack const &other);
+
+	//Position of the chunk packed for the firstInstance of its draw, the chunk vertices are relative to it
+	uint32_t getChunkOrigin(int const y) const;
+
+	//Bounds of one 32^3 chunk section, used for the per section frustum culling
+	void getSectionBounds(int const y, glm::vec3 &minB, glm::vec3 &maxB) const;
+
+	//Same for a section given in chunk coordinates, which does not have to be loaded
+	static void getSectionBounds(int const x, int const y, int const z, glm::vec3 &minB, glm::vec3 &maxB);
+
 private:
 	/**
 	 * @brief Updates all necessary vectors to add space in the y dimension for a new chunk on top of the already existing ones.
@@ -104,6 +156,8 @@ private:
 
 	void deleteVulkanChunk(int const y);
 
+	void uploadFinished();
+
 	/**
 	 * @brief Checks if a given cube inside the referenced chunk can be culled, because the cube is not visible
 	 *
@@ -134,6 +188,33 @@ private:
 
 	void greedyMesh2D(std::vector<Quad> &cubeSideQuads, int const side);
 
+	static bool isEmissive(CubeType const cubeType);
+
+	void addBoxData(int const u, int const w, int const v, int const y, CubeType const cubeType);
+
+	//For the sections meshed at lodLevel > 0, which do not visit the single cubes
+	void generateSectionBoxData(int const y);
+
+	/**
+	 * @brief Adds the quads of a section for lodLevel > 0, one unit cube per block, so the greedy meshing can merge them as usual.
+	 *
+	 * @param y Y coordinate of the chunk.
+	 * @param cubeSideQuads Quads of every side in block units, scaled to cubes by scaleLodQuad after the meshing.
+	 */
+	void generateLodQuads(int const y, std::vector<Quad> cubeSideQuads[6]);
+
+	void scaleLodQuad(Quad &quad);
+
+	//Block of 2^lodLevel cubes per axis at block coordinates of the stack, the type of its top most cube if most of its cubes are not air
+	CubeType getLodCube(ChunkStack const &stack, int const cu, int const cw, int const cv);
+
+	CubeType getLodNeighbour(int const cu, int const cw, int const cv, int const side);
+
+	int8_t getLodLightLevel(int const cu, int const cw, int const cv, int const side);
+
+	//Whether the side of a column at the border towards the given neighbour has to be closed
+	bool isBorderOpen(int const neighbour);
+
 	ObjArray *objArray;
 };
 
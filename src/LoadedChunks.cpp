@@ -1,6 +1,8 @@
 #include "LoadedChunks.h"
+#include "ComputeSettings.h"
 
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <thread>
@@ -36,7 +38,8 @@ void LoadedChunks::updateMiddle(glm::vec3 position) {
 	for (auto iterator = loadedChunkStacks.begin(); iterator != loadedChunkStacks.end(); iterator++) {
 		Coordinates coordinates = iterator->first;
 
-		if (iterator->second->chunkRemoved) {
+		//A remesh still running needs the cubes of this stack, so it is only deleted together with its finished replacement
+		if (iterator->second->chunkRemoved && (iterator->second->lodReplacement == nullptr || iterator->second->lodReplacement->chunkStackReady)) {
 			coordinatesRemoved.push_back(coordinates);
 		}
 
@@ -49,12 +52,20 @@ void LoadedChunks::updateMiddle(glm::vec3 position) {
 				ThreadPool::getInstance().submit([this, iterator] {
 					map.saveChunkStack(iterator->second->chunkStack);
 
+					if (ComputeSettings::VOXEL_TRACING) {
+						brickMap.removeColumn(iterator->first);
+					} else {
+						boxPool.removeColumn(iterator->first);
+					}
+					sceneVersion++;
+
 					while (iterator->second->lifeCounter > 0) {
 						//std::cout << iterator->second.lifeCounter << std::endl;
 						std::this_thread::sleep_for(std::chrono::seconds(1));
 					}
 
 					iterator->second->deleteVulkanChunks();
+
 					iterator->second->chunkRemoved = true;
 					});
 			}
@@ -67,18 +78,27 @@ void LoadedChunks::updateMiddle(glm::vec3 position) {
 
 		loadedChunkStacks.erase(coordinatesRemoved[i]);
 
+		//Never swapped in, so its meshes were never drawn
+		if (pointer->lodReplacement != nullptr) {
+			pointer->lodReplacement->deleteVulkanChunks();
+			delete pointer->lodReplacement;
+		}
+
 		delete pointer;
 	}
 
 	if (directionX != 0 || directionZ != 0) {
+		//Set first, the new stacks get their levels of detail around it
+		middle = newMiddle;
+
 		for (size_t x = 0; x < Settings::LOADED_CHUNKS; x++) {
 			for (size_t z = 0; z < Settings::LOADED_CHUNKS; z++) {
 				addLoadedChunkStack(newMiddle.x + (int)x - Settings::LOADED_CHUNKS / 2, newMiddle.z + (int)z - Settings::LOADED_CHUNKS / 2);
 			}
 		}
-
-		middle = newMiddle;
 	}
+
+	updateLodLevels();
 }
 
 void LoadedChunks::generateBoxData(std::vector<BoxData> &boxData, std::vector<BoxData> &emissiveBoxData) {
@@ -89,6 +109,18 @@ void LoadedChunks::generateBoxData(std::vector<BoxData> &boxData, std::vector<Bo
 	}
 }
 
+void LoadedChunks::generateVoxelGrid(VoxelGrid &voxelGrid, std::vector<BoxData> &emissiveBoxData) {
+	brickMap.generateVoxelGrid(voxelGrid, emissiveBoxData);
+}
+
+BoxPool &LoadedChunks::getBoxPool() {
+	return boxPool;
+}
+
+uint64_t LoadedChunks::getSceneVersion() const {
+	return sceneVersion;
+}
+
 void LoadedChunks::addLoadedChunkStack(int const x, int const z) {
 	Coordinates coordinates = { x, z };
 
@@ -101,6 +133,8 @@ void LoadedChunks::addLoadedChunkStack(int const x, int const z) {
 	loadedChunkStacks.emplace(std::pair<Coordinates, LoadedChunkStack*>(coordinates, new LoadedChunkStack(*vulkanWrapper, objArray)));
 	iterator = loadedChunkStacks.find(coordinates);
 
+	setLodLevels(*iterator->second, coordinates);
+
 	ThreadPool::getInstance().submit([this, coordinates, iterator] {
 		map.loadChunkStack(coordinates, iterator->second->chunkStack);
 
@@ -113,6 +147,115 @@ void LoadedChunks::addLoadedChunkStack(int const x, int const z) {
 		map.loadChunkStack({ coordinates.x - 1, coordinates.z + 1 }, iterator->second->backLeftStack);
 		map.loadChunkStack({ coordinates.x + 1, coordinates.z + 1 }, iterator->second->backRightStack);
 
-		iterator->second->generateVulkanChunks();
+		//Kept up to date while streaming, so entering the photo mode only has to upload the bricks
+		if (ComputeSettings::VOXEL_TRACING) {
+			std::vector<BoxData> emissiveBoxData;
+			iterator->second->generateEmissiveBoxData(emissiveBoxData);
+
+			brickMap.updateColumn(iterator->second->chunkStack, emissiveBoxData);
+			sceneVersion++;
+
+			iterator->second->generateVulkanChunks();
+			return;
+		}
+
+		//Before the stack is ready, so its removal task can not run ahead of it
+		//The levels of detail only change the meshes, the remeshed replacements keep these boxes
+		iterator->second->generateVulkanChunks([this, iterator] {
+			std::vector<BoxData> boxData;
+			std::vector<BoxData> emissiveBoxData;
+			iterator->second->generateBoxData(boxData, emissiveBoxData);
+
+			boxPool.updateColumn(iterator->first, boxData, emissiveBoxData);
+			sceneVersion++;
+			});
 		});
-}
\ No newline at end of file
+}
+
+void LoadedChunks::countDownReplacedChunkStacks() {
+	std::lock_guard<std::mutex> lockGuard(replacedChunkStacksMutex);
+
+	for (size_t i = 0; i < replacedChunkStacks.size(); i++) {
+		replacedChunkStacks[i]->lifeCounter--;
+	}
+}
+
+int LoadedChunks::getLodLevel(int const x, int const z) const {
+	if (!Settings::CHUNK_LOD) {
+		return 0;
+	}
+
+	int distance = std::max(abs(x - middle.x), abs(z - middle.z));
+
+	return std::min(distance / Settings::LOD_RING_WIDTH, Settings::MAX_LOD_LEVEL);
+}
+
+void LoadedChunks::setLodLevels(LoadedChunkStack &loadedChunkStack, Coordinates const &coordinates) const {
+	loadedChunkStack.lodLevel = getLodLevel(coordinates.x, coordinates.z);
+
+	//Same order as the left, right, front and back stacks
+	loadedChunkStack.neighbourLodLevels[0] = getLodLevel(coordinates.x - 1, coordinates.z);
+	loadedChunkStack.neighbourLodLevels[1] = getLodLevel(coordinates.x + 1, coordinates.z);
+	loadedChunkStack.neighbourLodLevels[2] = getLodLevel(coordinates.x, coordinates.z - 1);
+	loadedChunkStack.neighbourLodLevels[3] = getLodLevel(coordinates.x, coordinates.z + 1);
+}
+
+bool LoadedChunks::hasOtherLodLevels(LoadedChunkStack const &loadedChunkStack, Coordinates const &coordinates) const {
+	return loadedChunkStack.lodLevel != getLodLevel(coordinates.x, coordinates.z) ||
+		loadedChunkStack.neighbourLodLevels[0] != getLodLevel(coordinates.x - 1, coordinates.z) ||
+		loadedChunkStack.neighbourLodLevels[1] != getLodLevel(coordinates.x + 1, coordinates.z) ||
+		loadedChunkStack.neighbourLodLevels[2] != getLodLevel(coordinates.x, coordinates.z - 1) ||
+		loadedChunkStack.neighbourLodLevels[3] != getLodLevel(coordinates.x, coordinates.z + 1);
+}
+
+void LoadedChunks::updateLodLevels() {
+	for (auto iterator = loadedChunkStacks.begin(); iterator != loadedChunkStacks.end(); iterator++) {
+		LoadedChunkStack *loadedChunkStack = iterator->second;
+
+		if (loadedChunkStack->willBeRemoved) {
+			continue;
+		}
+
+		if (loadedChunkStack->lodReplacement != nullptr) {
+			if (!loadedChunkStack->lodReplacement->chunkStackReady) {
+				continue;
+			}
+
+			//The old meshes stay drawn until the new ones are uploaded, so the column never disappears
+			iterator->second = loadedChunkStack->lodReplacement;
+
+			loadedChunkStack->lodReplacement = nullptr;
+			loadedChunkStack->willBeRemoved = true;
+			loadedChunkStack->chunkStackReady = false;
+
+			std::lock_guard<std::mutex> lockGuard(replacedChunkStacksMutex);
+			replacedChunkStacks.push_back(loadedChunkStack);
+		}
+		else if (loadedChunkStack->chunkStackReady && hasOtherLodLevels(*loadedChunkStack, iterator->first)) {
+			LoadedChunkStack *lodReplacement = new LoadedChunkStack(*vulkanWrapper, objArray);
+			setLodLevels(*lodReplacement, iterator->first);
+
+			loadedChunkStack->lodReplacement = lodReplacement;
+
+			ThreadPool::getInstance().submit([loadedChunkStack, lodReplacement] {
+				lodReplacement->copyChunkStacks(*loadedChunkStack);
+				lodReplacement->generateVulkanChunks();
+				});
+		}
+	}
+
+	std::lock_guard<std::mutex> lockGuard(replacedChunkStacksMutex);
+
+	//Freed here once no frame in flight can draw them anymore, no pool worker waits for the counter
+	for (size_t i = 0; i < replacedChunkStacks.size();) {
+		if (replacedChunkStacks[i]->lifeCounter <= 0) {
+			replacedChunkStacks[i]->deleteVulkanChunks();
+			delete replacedChunkStacks[i];
+
+			replacedChunkStacks[i] = replacedChunkStacks.back();
+			replacedChunkStacks.pop_back();
+		} else {
+			i++;
+		}
+	}
+}
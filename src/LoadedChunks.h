@@ -20,10 +20,14 @@
 #include "LoadedChunkStack.h"
 #include "ThreadPool.h"
 #include "ObjArray.h"
+#include "BrickMap.h"
+#include "BoxPool.h"
 
 #include "glm/glm.hpp"
 
+#include <atomic>
 #include <vector>
+#include <mutex>
 
  /**
   * @brief This class contains all currently loaded and accessible chunks in the game.
@@ -45,6 +49,18 @@ public:
 
 	void generateBoxData(std::vector<BoxData> &boxData, std::vector<BoxData> &emissiveBoxData);
 
+	//Covers all columns in the brick map, the grid starts at the lowest loaded chunk and at height 0
+	void generateVoxelGrid(VoxelGrid &voxelGrid, std::vector<BoxData> &emissiveBoxData);
+
+	//Filled while the columns stream in when the path tracer runs on boxes, see BoxPool::update
+	BoxPool &getBoxPool();
+
+	//Counts the columns written to or removed from the brick map and the box pool, the photo mode only uploads them again if it moved on
+	uint64_t getSceneVersion() const;
+
+	//Called once per frame by the render loop in both modes, the stacks replaced by their remeshed versions are freed by updateLodLevels once their lifeCounter ran out
+	void countDownReplacedChunkStacks();
+
 private:
 
 	/**
@@ -58,7 +74,28 @@ private:
 
     void addLoadedChunkStack(int const x, int const z);
 
+	//Level of detail of the column at x, z around the middle, see Settings::LOD_RING_WIDTH
+	int getLodLevel(int const x, int const z) const;
+
+	void setLodLevels(LoadedChunkStack &loadedChunkStack, Coordinates const &coordinates) const;
+
+	bool hasOtherLodLevels(LoadedChunkStack const &loadedChunkStack, Coordinates const &coordinates) const;
+
+	//Remeshes the stacks whose levels changed with the middle and swaps in the finished ones
+	void updateLodLevels();
+
+	std::vector<LoadedChunkStack *> replacedChunkStacks;
+	std::mutex replacedChunkStacksMutex;
+
 	ObjArray *objArray;
+
+	//Updated by the loading and removal tasks of the columns
+	BrickMap brickMap;
+
+	//Same as the brick map for the boxes of the path tracer
+	BoxPool boxPool;
+
+	std::atomic<uint64_t> sceneVersion = 0;
 };
 
 #endif // !LOADEDCHUNKS_H
@@ -1,32 +1,59 @@
 #include "MapGenerator.h"
 #include "FileWriter.h"
 #include "CubeType.h"
-#include "TreeDescription.h"
 #include "TreeBuilder.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 
-MapGenerator::MapGenerator() {}
+MapGenerator::MapGenerator() : oakTreeTemplate(Settings::simpleOakTreeDescription), firTreeTemplate(Settings::simpleFirTreeDescription), cactusTemplate(Settings::simpleCactusDescription) {
+	//Positions on the moisture / temperature map
+	biomTable.addBiom(Settings::forestData, -1.0f, -1.0f);
+	biomTable.addBiom(Settings::plainsData, -1.0f, 1.0f);
+	biomTable.addBiom(Settings::mountainData, 1.0f, -1.0f);
+	biomTable.addBiom(Settings::desertData, 1.0f, 1.0f);
+}
 
 MapGenerator::~MapGenerator() {}
 
 void MapGenerator::generateChunkHeight(int const x, int const z, ChunkStack &chunkStack) {
+	size_t const tileSize = Settings::CHUNK_SIZE * Settings::CHUNK_SIZE;
+
+	std::vector<float> biomMoisture(tileSize);
+	std::vector<float> biomTemperature(tileSize);
+	std::vector<BiomData> biomDatas(tileSize);
+
 	for (size_t w = 0; w < Settings::CHUNK_SIZE; w++) {
 		for (size_t u = 0; u < Settings::CHUNK_SIZE; u++) {
 			float s = x + (float)u / Settings::CHUNK_SIZE;
 			float t = z + (float)w / Settings::CHUNK_SIZE;
 
-			float moisture = perlinNoise.combinedOctaves(s, t, Settings::BIOM_SIZE, 2.0f, 1.0f, 0.5f, 2);
+			biomMoisture[w * Settings::CHUNK_SIZE + u] = perlinNoise.combinedOctaves(s, t, Settings::BIOM_SIZE, 2.0f, 1.0f, 0.5f, 2);
+			biomTemperature[w * Settings::CHUNK_SIZE + u] = perlinNoise.invert(perlinNoise.domainWarpingCombinedOctaves(s, t, Settings::BIOM_SIZE / 2.0f, 2.0f, 1.0f, 0.5f, 2));
+		}
+	}
+
+	//Blending the bioms for the whole chunk at once
+	biomTable.blend(biomMoisture.data(), biomTemperature.data(), tileSize, biomDatas.data());
+
+	std::vector<float> densityLattice;
+	bool solid[Settings::MAX_HEIGHT];
 
-			float temperature = perlinNoise.invert(perlinNoise.domainWarpingCombinedOctaves(s, t, Settings::BIOM_SIZE / 2.0f, 2.0f, 1.0f, 0.5f, 2));
+	if (Settings::TERRAIN_MODE == TerrainMode::DENSITY_FIELD) {
+		generateDensityLattice(x, z, densityLattice);
+	}
+
+	for (size_t w = 0; w < Settings::CHUNK_SIZE; w++) {
+		for (size_t u = 0; u < Settings::CHUNK_SIZE; u++) {
+			float s = x + (float)u / Settings::CHUNK_SIZE;
+			float t = z + (float)w / Settings::CHUNK_SIZE;
 
-			BiomData biomData;
-			getInterpolatedBiom(moisture, temperature, biomData);
+			BiomData biomData = biomDatas[w * Settings::CHUNK_SIZE + u];
 
-			moisture = perlinNoise.combinedOctaves(s, t, Settings::BIOM_SIZE, 2.0f, 1.0f, 0.5f, 10);
-			temperature = perlinNoise.invert(perlinNoise.domainWarpingCombinedOctaves(s, t, Settings::BIOM_SIZE / 2.0f, 2.0f, 1.0f, 0.5f, 10));
+			float moisture = perlinNoise.combinedOctaves(s, t, Settings::BIOM_SIZE, 2.0f, 1.0f, 0.5f, 10);
+			float temperature = perlinNoise.invert(perlinNoise.domainWarpingCombinedOctaves(s, t, Settings::BIOM_SIZE / 2.0f, 2.0f, 1.0f, 0.5f, 10));
 
 			float heightNoise = perlinNoise.invert(perlinNoise.domainWarpingCombinedOctaves(s, t, biomData.frequency, 2.0f, biomData.amplitude, 0.5f, (int)biomData.octaveCount));
 
@@ -38,6 +65,11 @@ void MapGenerator::generateChunkHeight(int const x, int const z, ChunkStack &chu
 				height = Settings::MIN_HEIGHT;
 			}
 
+			//The height map only biases the density, the top solid cube becomes the new height
+			if (Settings::TERRAIN_MODE == TerrainMode::DENSITY_FIELD) {
+				height = carveDensityColumn(u, w, height, densityLattice, solid);
+			}
+
 			int chunkYIndex = height / Settings::CHUNK_SIZE + 1;
 
 			if (chunkStack.stack.size() < chunkYIndex) {
@@ -48,6 +80,10 @@ void MapGenerator::generateChunkHeight(int const x, int const z, ChunkStack &chu
 			chunkStack.stack[0].cubes[u][w][0] = Cube(CubeType::BEDROCK);
 
 			for (int v = 1; v < height; v++) {
+				if (Settings::TERRAIN_MODE == TerrainMode::DENSITY_FIELD && !solid[v]) {
+					continue;
+				}
+
 				int stackIndex = v / Settings::CHUNK_SIZE;
 				int chunkIndex = v % Settings::CHUNK_SIZE;
 
@@ -123,58 +159,69 @@ void MapGenerator::generateChunkHeight(int const x, int const z, ChunkStack &chu
 				RandomSampler randomSampler = RandomSampler();
 				randomSampler.resetSampler(x * Settings::CHUNK_SIZE + u, z * Settings::CHUNK_SIZE + w);
 				
-				TreeDescription treeDescription;
+				TreeTemplate const *treeTemplate;
+				CubeType trunkType;
+				CubeType leafType;
 
 				if (temperature > 0.0f && moisture < 0.0f) {
 					biomData.treeDensity = Settings::plainsData.treeDensity;
-					treeDescription = Settings::simpleOakTreeDescription;
+					treeTemplate = &oakTreeTemplate;
+					trunkType = oakTreeTemplate.trunkType;
+					leafType = oakTreeTemplate.leafType;
 
 					float r1 = randomSampler.getSample1DNonReset();
 
 					if (r1 <= 0.25f) {
-						treeDescription.trunkType = CubeType::OAK_LOG;
-						treeDescription.leafType = CubeType::OAK_LEAVES;
+						trunkType = CubeType::OAK_LOG;
+						leafType = CubeType::OAK_LEAVES;
 					} else if (r1 <= 0.5f) {
-						treeDescription.trunkType = CubeType::DARK_OAK_LOG;
-						treeDescription.leafType = CubeType::DARK_OAK_LEAVES;
+						trunkType = CubeType::DARK_OAK_LOG;
+						leafType = CubeType::DARK_OAK_LEAVES;
 					} else if (r1 <= 0.75f) {
-						treeDescription.trunkType = CubeType::BIRCH_LOG;
-						treeDescription.leafType = CubeType::BIRCH_LEAVES;
+						trunkType = CubeType::BIRCH_LOG;
+						leafType = CubeType::BIRCH_LEAVES;
 					} else if (r1 <= 1.0f) {
-						treeDescription.trunkType = CubeType::ACACIA_LOG;
-						treeDescription.leafType = CubeType::ACACIA_LEAVES;
+						trunkType = CubeType::ACACIA_LOG;
+						leafType = CubeType::ACACIA_LEAVES;
 					}
 				}
 				else {
 					biomData.treeDensity = Settings::forestData.treeDensity;
-					treeDescription = Settings::simpleFirTreeDescription;
+					treeTemplate = &firTreeTemplate;
+					trunkType = firTreeTemplate.trunkType;
+					leafType = firTreeTemplate.leafType;
 				}
 
 				if (biomData.heightUsage > 0.95f) {
 					biomData.treeDensity = Settings::mountainData.treeDensity;
-					treeDescription = Settings::simpleFirTreeDescription;
+					treeTemplate = &firTreeTemplate;
+					trunkType = firTreeTemplate.trunkType;
+					leafType = firTreeTemplate.leafType;
 				}
 
 				if (temperature > 0.0f && moisture > 0.0f && height < 90) {
 					biomData.treeDensity = Settings::desertData.treeDensity;
-					treeDescription = Settings::simpleCactusDescription;
+					treeTemplate = &cactusTemplate;
+					trunkType = cactusTemplate.trunkType;
+					leafType = cactusTemplate.leafType;
 				}
 
 				if (randomSampler.getSample1DNonReset() < biomData.treeDensity) {
-					glm::vec3 position = glm::vec3(u, height, w);
+					glm::ivec3 position = glm::ivec3(u, height, w);
 
-					std::vector<std::pair<glm::vec3, Cube>> treeCubes;
-					TreeBuilder::generateTreeCubes(treeDescription, randomSampler, treeCubes);
+					thread_local std::vector<std::pair<glm::ivec3, Cube>> treeCubes;
+					treeCubes.clear();
+					TreeBuilder::generateTreeCubes(*treeTemplate, trunkType, leafType, randomSampler, treeCubes);
 
 					if (ceckChunkBorder(treeCubes, position)) {
 
 						for (size_t i = 0; i < treeCubes.size(); i++) {
-							glm::vec3 cubePosition = position + treeCubes[i].first;
+							glm::ivec3 cubePosition = position + treeCubes[i].first;
 
-							int cubeStackIndex = (int)cubePosition.y / Settings::CHUNK_SIZE;
-							int cubeChunkIndex = (int)cubePosition.y % Settings::CHUNK_SIZE;
-							int cubeU = (int)cubePosition.x;
-							int cubeW = (int)cubePosition.z;
+							int cubeStackIndex = cubePosition.y / Settings::CHUNK_SIZE;
+							int cubeChunkIndex = cubePosition.y % Settings::CHUNK_SIZE;
+							int cubeU = cubePosition.x;
+							int cubeW = cubePosition.z;
 
 							if (chunkStack.stack.size() < cubeStackIndex + 1) {
 								chunkStack.stack.resize(cubeStackIndex + 1);
@@ -270,117 +317,89 @@ void MapGenerator::perlinNoiseImage() {
 }
 
 void MapGenerator::getInterpolatedBiom(float const moisture, float const temperature, BiomData &biomData) {
-	float moistureWeight = (moisture * 0.5f + 0.5f) * 2.0f - 0.5f;
-	float temperatureWeight = (temperature * 0.5f + 0.5f) * 2.0f - 0.5f;
-
-	if (moisture < -0.5f) {
-		if (temperature < -0.5f) {
-			//Lower left corner so it will be forest
-			biomData = Settings::forestData;
-			return;
-		}
-		else if (temperature > 0.5f) {
-			//Higher left corner so it will be plains
-			biomData = Settings::plainsData;
-			return;
-		}
-		else {
-			//Left so blending between forest and plains
-			biomData.amplitude = lerp(Settings::forestData.amplitude, Settings::plainsData.amplitude, temperatureWeight);
-			biomData.frequency = lerp(Settings::forestData.frequency, Settings::plainsData.frequency, temperatureWeight);
-			biomData.octaveCount = lerp(Settings::forestData.octaveCount, Settings::plainsData.octaveCount, temperatureWeight);
-			biomData.heightUsage = lerp(Settings::forestData.heightUsage, Settings::plainsData.heightUsage, temperatureWeight);
-			biomData.treeDensity = lerp(Settings::forestData.treeDensity, Settings::plainsData.treeDensity, temperatureWeight);
-			biomData.grasDensity = lerp(Settings::forestData.grasDensity, Settings::plainsData.grasDensity, temperatureWeight);
-			biomData.flowerDensity = lerp(Settings::forestData.flowerDensity, Settings::plainsData.flowerDensity, temperatureWeight);
-			return;
+	biomTable.blend(&moisture, &temperature, 1, &biomData);
+}
+
+void MapGenerator::generateDensityLattice(int const x, int const z, std::vector<float> &densityLattice) {
+	int const latticeSizeXZ = Settings::CHUNK_SIZE / Settings::DENSITY_LATTICE_XZ + 1;
+	int const latticeSizeY = Settings::MAX_HEIGHT / Settings::DENSITY_LATTICE_Y + 1;
+
+	densityLattice.resize(3 * latticeSizeY * latticeSizeXZ * latticeSizeXZ);
+
+	for (int j = 0; j < latticeSizeY; j++) {
+		for (int k = 0; k < latticeSizeXZ; k++) {
+			for (int i = 0; i < latticeSizeXZ; i++) {
+				float s = (x * Settings::CHUNK_SIZE + i * Settings::DENSITY_LATTICE_XZ) / 32.0f;
+				float t = (j * Settings::DENSITY_LATTICE_Y) / 32.0f;
+				float r = (z * Settings::CHUNK_SIZE + k * Settings::DENSITY_LATTICE_XZ) / 32.0f;
+
+				size_t index = (j * latticeSizeXZ + k) * latticeSizeXZ + i;
+				size_t channelSize = latticeSizeY * latticeSizeXZ * latticeSizeXZ;
+
+				//Overhangs
+				densityLattice[index] = perlinNoise.noise3D(s, t, r) + 0.5f * perlinNoise.noise3D(2.0f * s, 2.0f * t, 2.0f * r);
+
+				//Two noises for the caves, where both are close to zero we get tunnels
+				densityLattice[channelSize + index] = perlinNoise.noise3D(1.5f * s + 100.0f, 2.0f * t, 1.5f * r);
+				densityLattice[2 * channelSize + index] = perlinNoise.noise3D(1.5f * s, 2.0f * t + 100.0f, 1.5f * r);
+			}
 		}
 	}
-	else if (moisture > 0.5f) {
-		if (temperature < -0.5f) {
-			//Lower right corner so it will be mountains
-			biomData = Settings::mountainData;
-			return;
-		}
-		else if (temperature > 0.5f) {
-			//Higher right corner so it will be desert
-			biomData = Settings::desertData;
-			return;
-		}
-		else {
-			//Right so blending between mountains and desert
-			biomData.amplitude = lerp(Settings::mountainData.amplitude, Settings::desertData.amplitude, temperatureWeight);
-			biomData.frequency = lerp(Settings::mountainData.frequency, Settings::desertData.frequency, temperatureWeight);
-			biomData.octaveCount = lerp(Settings::mountainData.octaveCount, Settings::desertData.octaveCount, temperatureWeight);
-			biomData.heightUsage = lerp(Settings::mountainData.heightUsage, Settings::desertData.heightUsage, temperatureWeight);
-			biomData.treeDensity = lerp(Settings::mountainData.treeDensity, Settings::desertData.treeDensity, temperatureWeight);
-			biomData.grasDensity = lerp(Settings::mountainData.grasDensity, Settings::desertData.grasDensity, temperatureWeight);
-			biomData.flowerDensity = lerp(Settings::mountainData.flowerDensity, Settings::desertData.flowerDensity, temperatureWeight);
-			return;
+}
+
+int MapGenerator::carveDensityColumn(size_t const u, size_t const w, int const surfaceHeight, std::vector<float> const &densityLattice, bool *solid) {
+	int const latticeSizeXZ = Settings::CHUNK_SIZE / Settings::DENSITY_LATTICE_XZ + 1;
+	int const latticeSizeY = Settings::MAX_HEIGHT / Settings::DENSITY_LATTICE_Y + 1;
+	size_t const channelSize = latticeSizeY * latticeSizeXZ * latticeSizeXZ;
+
+	int i = u / Settings::DENSITY_LATTICE_XZ;
+	int k = w / Settings::DENSITY_LATTICE_XZ;
+	float weightX = (float)(u % Settings::DENSITY_LATTICE_XZ) / Settings::DENSITY_LATTICE_XZ;
+	float weightZ = (float)(w % Settings::DENSITY_LATTICE_XZ) / Settings::DENSITY_LATTICE_XZ;
+
+	int maxHeight = std::min(surfaceHeight + Settings::DENSITY_OVERHANG, (int)Settings::MAX_HEIGHT);
+	int top = 0;
+
+	solid[0] = true;
+
+	for (int v = 1; v < maxHeight; v++) {
+		int j = v / Settings::DENSITY_LATTICE_Y;
+		float weightY = (float)(v % Settings::DENSITY_LATTICE_Y) / Settings::DENSITY_LATTICE_Y;
+
+		float values[3];
+
+		for (size_t channel = 0; channel < 3; channel++) {
+			float const *lattice = densityLattice.data() + channel * channelSize;
+
+			float value00 = lattice[(j * latticeSizeXZ + k) * latticeSizeXZ + i] + weightX * (lattice[(j * latticeSizeXZ + k) * latticeSizeXZ + i + 1] - lattice[(j * latticeSizeXZ + k) * latticeSizeXZ + i]);
+			float value01 = lattice[(j * latticeSizeXZ + k + 1) * latticeSizeXZ + i] + weightX * (lattice[(j * latticeSizeXZ + k + 1) * latticeSizeXZ + i + 1] - lattice[(j * latticeSizeXZ + k + 1) * latticeSizeXZ + i]);
+			float value10 = lattice[((j + 1) * latticeSizeXZ + k) * latticeSizeXZ + i] + weightX * (lattice[((j + 1) * latticeSizeXZ + k) * latticeSizeXZ + i + 1] - lattice[((j + 1) * latticeSizeXZ + k) * latticeSizeXZ + i]);
+			float value11 = lattice[((j + 1) * latticeSizeXZ + k + 1) * latticeSizeXZ + i] + weightX * (lattice[((j + 1) * latticeSizeXZ + k + 1) * latticeSizeXZ + i + 1] - lattice[((j + 1) * latticeSizeXZ + k + 1) * latticeSizeXZ + i]);
+
+			float value0 = value00 + weightZ * (value01 - value00);
+			float value1 = value10 + weightZ * (value11 - value10);
+
+			values[channel] = value0 + weightY * (value1 - value0);
 		}
-	}
 
-	if (temperature < -0.5f) {
-		//Lower so blending between forest and mountain
-		biomData.amplitude = lerp(Settings::forestData.amplitude, Settings::mountainData.amplitude, moistureWeight);
-		biomData.frequency = lerp(Settings::forestData.frequency, Settings::mountainData.frequency, moistureWeight);
-		biomData.octaveCount = lerp(Settings::forestData.octaveCount, Settings::mountainData.octaveCount, moistureWeight);
-		biomData.heightUsage = lerp(Settings::forestData.heightUsage, Settings::mountainData.heightUsage, moistureWeight);
-		biomData.treeDensity = lerp(Settings::forestData.treeDensity, Settings::mountainData.treeDensity, temperatureWeight);
-		biomData.grasDensity = lerp(Settings::forestData.grasDensity, Settings::mountainData.grasDensity, temperatureWeight);
-		biomData.flowerDensity = lerp(Settings::forestData.flowerDensity, Settings::mountainData.flowerDensity, temperatureWeight);
-		return;
-	}
-	else if (temperature > 0.5f) {
-		//Higher so blending between plains and desert
-		biomData.amplitude = lerp(Settings::plainsData.amplitude, Settings::desertData.amplitude, moistureWeight);
-		biomData.frequency = lerp(Settings::plainsData.frequency, Settings::desertData.frequency, moistureWeight);
-		biomData.octaveCount = lerp(Settings::plainsData.octaveCount, Settings::desertData.octaveCount, moistureWeight);
-		biomData.heightUsage = lerp(Settings::plainsData.heightUsage, Settings::desertData.heightUsage, moistureWeight);
-		biomData.treeDensity = lerp(Settings::plainsData.treeDensity, Settings::desertData.treeDensity, temperatureWeight);
-		biomData.grasDensity = lerp(Settings::plainsData.grasDensity, Settings::desertData.grasDensity, temperatureWeight);
-		biomData.flowerDensity = lerp(Settings::plainsData.flowerDensity, Settings::desertData.flowerDensity, temperatureWeight);
-		return;
-	}
+		float density = (float)(surfaceHeight - v) / Settings::DENSITY_OVERHANG + values[0];
 
-	//Blending between all 4 for the middle
-	BiomData biomDataLowTemperature;
-	biomDataLowTemperature.amplitude = lerp(Settings::forestData.amplitude, Settings::mountainData.amplitude, moistureWeight);
-	biomDataLowTemperature.frequency = lerp(Settings::forestData.frequency, Settings::mountainData.frequency, moistureWeight);
-	biomDataLowTemperature.octaveCount = lerp(Settings::forestData.octaveCount, Settings::mountainData.octaveCount, moistureWeight);
-	biomDataLowTemperature.heightUsage = lerp(Settings::forestData.heightUsage, Settings::mountainData.heightUsage, moistureWeight);
-	biomDataLowTemperature.treeDensity = lerp(Settings::forestData.treeDensity, Settings::mountainData.treeDensity, temperatureWeight);
-	biomDataLowTemperature.grasDensity = lerp(Settings::forestData.grasDensity, Settings::mountainData.grasDensity, temperatureWeight);
-	biomDataLowTemperature.flowerDensity = lerp(Settings::forestData.flowerDensity, Settings::mountainData.flowerDensity, temperatureWeight);
-
-	BiomData biomDataHighTemperature;
-	biomDataHighTemperature.amplitude = lerp(Settings::plainsData.amplitude, Settings::desertData.amplitude, moistureWeight);
-	biomDataHighTemperature.frequency = lerp(Settings::plainsData.frequency, Settings::desertData.frequency, moistureWeight);
-	biomDataHighTemperature.octaveCount = lerp(Settings::plainsData.octaveCount, Settings::desertData.octaveCount, moistureWeight);
-	biomDataHighTemperature.heightUsage = lerp(Settings::plainsData.heightUsage, Settings::desertData.heightUsage, moistureWeight);
-	biomDataHighTemperature.treeDensity = lerp(Settings::plainsData.treeDensity, Settings::desertData.treeDensity, temperatureWeight);
-	biomDataHighTemperature.grasDensity = lerp(Settings::plainsData.grasDensity, Settings::desertData.grasDensity, temperatureWeight);
-	biomDataHighTemperature.flowerDensity = lerp(Settings::plainsData.flowerDensity, Settings::desertData.flowerDensity, temperatureWeight);
-
-	biomData.amplitude = lerp(biomDataLowTemperature.amplitude, biomDataHighTemperature.amplitude, temperatureWeight);
-	biomData.frequency = lerp(biomDataLowTemperature.frequency, biomDataHighTemperature.frequency, temperatureWeight);
-	biomData.octaveCount = lerp(biomDataLowTemperature.octaveCount, biomDataHighTemperature.octaveCount, temperatureWeight);
-	biomData.heightUsage = lerp(biomDataLowTemperature.heightUsage, biomDataHighTemperature.heightUsage, temperatureWeight);
-	biomData.treeDensity = lerp(biomDataLowTemperature.treeDensity, biomDataHighTemperature.treeDensity, temperatureWeight);
-	biomData.grasDensity = lerp(biomDataLowTemperature.grasDensity, biomDataHighTemperature.grasDensity, temperatureWeight);
-	biomData.flowerDensity = lerp(biomDataLowTemperature.flowerDensity, biomDataHighTemperature.flowerDensity, temperatureWeight);
-}
+		solid[v] = density > 0.0f && values[1] * values[1] + values[2] * values[2] > 0.01f;
+
+		if (solid[v]) {
+			top = v;
+		}
+	}
 
-float MapGenerator::lerp(float const a, float const b, float const weight) {
-	return a + weight * (b - a);
+	return std::max(top + 1, (int)Settings::MIN_HEIGHT);
 }
 
-bool MapGenerator::ceckChunkBorder(std::vector<std::pair<glm::vec3, Cube>> const &treeCubes, glm::vec3 const position) {
+bool MapGenerator::ceckChunkBorder(std::vector<std::pair<glm::ivec3, Cube>> const &treeCubes, glm::ivec3 const position) {
 	for (size_t i = 0; i < treeCubes.size(); i++) {
-		glm::vec3 cubePosition = position + treeCubes[i].first;
+		glm::ivec3 cubePosition = position + treeCubes[i].first;
 
-		int cubeU = (int)cubePosition.x;
-		int cubeW = (int)cubePosition.z;
+		int cubeU = cubePosition.x;
+		int cubeW = cubePosition.z;
 
 		if (cubeU < 0 || cubeU >= Settings::CHUNK_SIZE) {
 			return false;
@@ -6,6 +6,8 @@
 #include "Chunk.h"
 #include "ChunkStack.h"
 #include "BiomData.h"
+#include "BiomTable.h"
+#include "TreeTemplate.h"
 
 class MapGenerator {
 public:
@@ -19,11 +21,19 @@ public:
 private:
 	PerlinNoise perlinNoise;
 
+	BiomTable biomTable;
+
+	TreeTemplate oakTreeTemplate;
+	TreeTemplate firTreeTemplate;
+	TreeTemplate cactusTemplate;
+
 	void getInterpolatedBiom(float const moisture, float const temperature, BiomData &biomData);
 
-	float lerp(float const a, float const b, float const weight);
+	void generateDensityLattice(int const x, int const z, std::vector<float> &densityLattice);
+
+	int carveDensityColumn(size_t const u, size_t const w, int const surfaceHeight, std::vector<float> const &densityLattice, bool *solid);
 
-	bool ceckChunkBorder(std::vector<std::pair<glm::vec3, Cube>> const &treeCubes, glm::vec3 const position);
+	bool ceckChunkBorder(std::vector<std::pair<glm::ivec3, Cube>> const &treeCubes, glm::ivec3 const position);
 };
 
 #endif // !MAPGENERATOR_H
@@ -0,0 +1,18 @@
+#ifndef MEMORYALLOCATION_H
+#define MEMORYALLOCATION_H
+
+#include "vulkan/vulkan.h"
+
+//Range inside one of the memory blocks of the MemoryAllocator
+struct MemoryAllocation {
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;
+	VkDeviceSize size = 0;
+
+	//Only set for host visible memory, already offset to the start of the allocation
+	void *mapped = nullptr;
+
+	uint32_t memoryTypeIndex = 0;
+};
+
+#endif // !MEMORYALLOCATION_H
@@ -0,0 +1,158 @@
+#include "MemoryAllocator.h"
+#include "MemoryHelper.h"
+#include "Settings.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+MemoryAllocator::MemoryAllocator() {}
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice const &physicalDevice, VkDevice const &device)
+	: physicalDevice(physicalDevice), device(device) {
+	VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
+
+	for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++) {
+		isHostVisible[i] = i < physicalDeviceMemoryProperties.memoryTypeCount && (physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+	}
+}
+
+MemoryAllocator::~MemoryAllocator() {
+	for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++) {
+		for (size_t j = 0; j < blocks[i].size(); j++) {
+			destroyBlock(blocks[i][j]);
+		}
+		blocks[i].clear();
+	}
+}
+
+void MemoryAllocator::allocate(VkMemoryRequirements const &memoryRequirements, VkMemoryPropertyFlags const memoryPropertyFlags, MemoryAllocation &allocation) {
+	uint32_t memoryTypeIndex = MemoryHelper::findMemoryType(physicalDevice, memoryRequirements.memoryTypeBits, memoryPropertyFlags);
+
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	std::vector<MemoryBlock> &typeBlocks = blocks[memoryTypeIndex];
+
+	VkDeviceSize offset = 0;
+	size_t blockIndex = 0;
+
+	//First fit over the existing blocks, a new block only if none of them has room
+	for (; blockIndex < typeBlocks.size(); blockIndex++) {
+		if (typeBlocks[blockIndex].ranges.allocate(memoryRequirements.size, memoryRequirements.alignment, offset)) {
+			break;
+		}
+	}
+
+	if (blockIndex == typeBlocks.size()) {
+		createBlock(memoryTypeIndex, std::max((VkDeviceSize)Settings::MEMORY_BLOCK_SIZE, memoryRequirements.size));
+
+		if (!typeBlocks[blockIndex].ranges.allocate(memoryRequirements.size, memoryRequirements.alignment, offset)) {
+			throw std::runtime_error("Failed to sub-allocate from a new memory block");
+		}
+	}
+
+	MemoryBlock &block = typeBlocks[blockIndex];
+
+	allocation.memory = block.memory;
+	allocation.offset = offset;
+	allocation.size = memoryRequirements.size;
+	allocation.mapped = block.mapped != nullptr ? static_cast<char *>(block.mapped) + offset : nullptr;
+	allocation.memoryTypeIndex = memoryTypeIndex;
+}
+
+void MemoryAllocator::free(MemoryAllocation &allocation) {
+	if (allocation.memory == VK_NULL_HANDLE) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+
+		std::vector<MemoryBlock> &typeBlocks = blocks[allocation.memoryTypeIndex];
+
+		for (size_t i = 0; i < typeBlocks.size(); i++) {
+			if (typeBlocks[i].memory == allocation.memory) {
+				typeBlocks[i].ranges.free(allocation.offset, allocation.size);
+
+				//The first block of every type is kept around, so loading and unloading a single chunk does not reallocate
+				if (typeBlocks[i].ranges.getAllocationCount() == 0 && i != 0) {
+					destroyBlock(typeBlocks[i]);
+					typeBlocks.erase(typeBlocks.begin() + i);
+				}
+
+				break;
+			}
+		}
+	}
+
+	allocation = MemoryAllocation();
+}
+
+MemoryStats MemoryAllocator::getStats() {
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	MemoryStats memoryStats;
+
+	for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++) {
+		for (size_t j = 0; j < blocks[i].size(); j++) {
+			MemoryBlock const &block = blocks[i][j];
+
+			memoryStats.blockCount++;
+			memoryStats.allocationCount += block.ranges.getAllocationCount();
+			memoryStats.freeRangeCount += block.ranges.getFreeRangeCount();
+			memoryStats.reservedBytes += block.ranges.getSize();
+			memoryStats.usedBytes += block.ranges.getUsedBytes();
+			memoryStats.largestFreeRange = std::max(memoryStats.largestFreeRange, block.ranges.getLargestFreeRange());
+		}
+	}
+
+	uint64_t freeBytes = memoryStats.reservedBytes - memoryStats.usedBytes;
+	if (freeBytes > 0) {
+		memoryStats.fragmentation = 1.0f - (float)memoryStats.largestFreeRange / (float)freeBytes;
+	}
+
+	return memoryStats;
+}
+
+void MemoryAllocator::printStats() {
+	MemoryStats memoryStats = getStats();
+
+	double const mebibyte = 1024.0 * 1024.0;
+
+	std::cout << std::fixed << std::setprecision(2) << "GPU memory:" << "\t" << memoryStats.blockCount << " blocks" << "\t" << memoryStats.allocationCount << " allocations" << "\t" << memoryStats.usedBytes / mebibyte << "/" << memoryStats.reservedBytes / mebibyte << "MiB used" << "\t" << memoryStats.freeRangeCount << " free ranges" << "\t" << memoryStats.largestFreeRange / mebibyte << "MiB largest free range" << "\t" << memoryStats.fragmentation * 100.0f << "% fragmentation" << std::endl;
+}
+
+void MemoryAllocator::createBlock(uint32_t const memoryTypeIndex, VkDeviceSize const size) {
+	MemoryBlock block;
+	block.ranges = RangeAllocator(size);
+
+	VkMemoryAllocateInfo memoryAllocateInfo{};
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize = size;
+	memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+	if (vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &block.memory) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate memory block");
+	}
+
+	//A VkDeviceMemory can only be mapped once, so host visible blocks are mapped as a whole and stay mapped
+	if (isHostVisible[memoryTypeIndex]) {
+		if (vkMapMemory(device, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mapped) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to map memory block");
+		}
+	}
+
+	blocks[memoryTypeIndex].push_back(block);
+}
+
+void MemoryAllocator::destroyBlock(MemoryBlock &block) {
+	if (block.mapped != nullptr) {
+		vkUnmapMemory(device, block.memory);
+	}
+
+	vkFreeMemory(device, block.memory, nullptr);
+
+	block = MemoryBlock();
+}
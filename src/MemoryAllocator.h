@@ -0,0 +1,44 @@
+#ifndef MEMORYALLOCATOR_H
+#define MEMORYALLOCATOR_H
+
+#include "MemoryAllocation.h"
+#include "MemoryBlock.h"
+#include "MemoryStats.h"
+
+#include "vulkan/vulkan.h"
+
+#include <mutex>
+#include <vector>
+
+//Hands out ranges of a few large VkDeviceMemory blocks per memory type, instead of one vkAllocateMemory per buffer
+class MemoryAllocator {
+public:
+	MemoryAllocator();
+	MemoryAllocator(VkPhysicalDevice const &physicalDevice, VkDevice const &device);
+	~MemoryAllocator();
+
+	void allocate(VkMemoryRequirements const &memoryRequirements, VkMemoryPropertyFlags const memoryPropertyFlags, MemoryAllocation &allocation);
+
+	//Does nothing for an empty allocation, resets the allocation afterwards
+	void free(MemoryAllocation &allocation);
+
+	MemoryStats getStats();
+
+	void printStats();
+
+private:
+	VkPhysicalDevice physicalDevice;
+	VkDevice device;
+
+	std::mutex mutex;
+
+	std::vector<MemoryBlock> blocks[VK_MAX_MEMORY_TYPES];
+
+	bool isHostVisible[VK_MAX_MEMORY_TYPES];
+
+	void createBlock(uint32_t const memoryTypeIndex, VkDeviceSize const size);
+
+	void destroyBlock(MemoryBlock &block);
+};
+
+#endif // !MEMORYALLOCATOR_H
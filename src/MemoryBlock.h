@@ -0,0 +1,17 @@
+#ifndef MEMORYBLOCK_H
+#define MEMORYBLOCK_H
+
+#include "RangeAllocator.h"
+
+#include "vulkan/vulkan.h"
+
+struct MemoryBlock {
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+
+	//Whole block stays mapped while it exists, for host visible memory types
+	void *mapped = nullptr;
+
+	RangeAllocator ranges;
+};
+
+#endif // !MEMORYBLOCK_H
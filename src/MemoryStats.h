@@ -0,0 +1,20 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct MemoryStats {
+	size_t blockCount = 0;
+	size_t allocationCount = 0;
+	size_t freeRangeCount = 0;
+
+	uint64_t reservedBytes = 0;
+	uint64_t usedBytes = 0;
+	uint64_t largestFreeRange = 0;
+
+	//Share of the free bytes which are not part of the largest free range, 0 means no fragmentation
+	float fragmentation = 0.0f;
+};
+
+#endif // !MEMORYSTATS_H
@@ -2,6 +2,8 @@
 #include "RandomSampler.h"
 #include "Settings.h"
 
+#include <cmath>
+#include <algorithm>
 
 Noise::Noise() {
 	setUpWorley3D(0);
@@ -13,58 +15,62 @@ Noise::Noise() {
 Noise::~Noise() {}
 
 float Noise::worley3D(glm::vec3 position, int const level) const {
+	int cellCount = cellCounts[level];
+
+	int cellX = std::clamp((int)std::floor(position.x * cellCount), 0, cellCount - 1);
+	int cellY = std::clamp((int)std::floor(position.y * cellCount), 0, cellCount - 1);
+	int cellZ = std::clamp((int)std::floor(position.z * cellCount), 0, cellCount - 1);
+
+	//Squared until the closest point is found
 	float distance = FLT_MAX;
 
-	for (int i = 0; i < Settings::worleyNoisePointCounts[level] * 27; i++) {
-		//float newDistance = glm::length(randomPositions[level][i] - position) * (level + 1);
-		float newDistance = glm::length(randomPositions[level][i] - position) * Settings::worleyNoiseScaling[level];
+	//With one point per cell the closest one is in the surrounding 27 cells, wrapped around the tile border
+	float tileSize = 1.0f / cellCount;
+
+	for (int z = cellZ - 1; z <= cellZ + 1; z++) {
+		int wrappedZ = (z + cellCount) % cellCount;
+		float offsetZ = (z - wrappedZ) * tileSize;
+
+		for (int y = cellY - 1; y <= cellY + 1; y++) {
+			int wrappedY = (y + cellCount) % cellCount;
+			float offsetY = (y - wrappedY) * tileSize;
+
+			int rowIndex = (wrappedY * cellCount) + (wrappedZ * cellCount * cellCount);
 
-		if (newDistance < distance) {
-			distance = newDistance;
+			for (int x = cellX - 1; x <= cellX + 1; x++) {
+				int wrappedX = (x + cellCount) % cellCount;
+				float offsetX = (x - wrappedX) * tileSize;
+
+				glm::vec3 difference = featurePoints[level][rowIndex + wrappedX] + glm::vec3(offsetX, offsetY, offsetZ) - position;
+				float newDistance = glm::dot(difference, difference);
+
+				if (newDistance < distance) {
+					distance = newDistance;
+				}
+			}
 		}
 	}
 
-	return distance;
+	return std::sqrt(distance) * Settings::worleyNoiseScaling[level];
 }
 
 void Noise::setUpWorley3D(int const level) {
-	//randomPositions[level].clear();
+	int cellCount = std::max(1, (int)std::round(std::cbrt((float)Settings::worleyNoisePointCounts[level])));
+
+	cellCounts[level] = cellCount;
+	featurePoints[level].clear();
+	featurePoints[level].reserve(cellCount * cellCount * cellCount);
 
 	RandomSampler randomSampler = RandomSampler();
+	randomSampler.resetSampler(level, 0);
 
-	for (int i = 0; i < Settings::worleyNoisePointCounts[level] * 27; i++) {
-		glm::vec3 randomVector = glm::vec3(randomSampler.getSample1DNonReset(), randomSampler.getSample1DNonReset(), randomSampler.getSample1DNonReset());
-		//randomPositions[level].push_back(randomVector);
-
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, -1.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 0.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 1.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, -1.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 0.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 1.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, -1.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 0.0f, -1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 1.0f, -1.0f));
-
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, -1.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 0.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 1.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, -1.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 0.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 1.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, -1.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 0.0f, 0.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 1.0f, 0.0f));
-
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, -1.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 0.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(-1.0f, 1.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, -1.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 0.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(0.0f, 1.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, -1.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 0.0f, 1.0f));
-		randomPositions[level].push_back(randomVector + glm::vec3(1.0f, 1.0f, 1.0f));
+	for (int z = 0; z < cellCount; z++) {
+		for (int y = 0; y < cellCount; y++) {
+			for (int x = 0; x < cellCount; x++) {
+				glm::vec3 randomVector = glm::vec3(randomSampler.getSample1DNonReset(), randomSampler.getSample1DNonReset(), randomSampler.getSample1DNonReset());
 
+				featurePoints[level].push_back((glm::vec3(x, y, z) + randomVector) / (float)cellCount);
+			}
+		}
 	}
-}
\ No newline at end of file
+}
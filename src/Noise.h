@@ -13,8 +13,9 @@ public:
 	float worley3D(glm::vec3 position, int const level) const;
 
 private:
-
-	std::vector<glm::vec3> randomPositions[4];
+	//The unit cube is split into cellCounts[level]^3 cells with one random feature point each, tiling in every direction
+	int cellCounts[4];
+	std::vector<glm::vec3> featurePoints[4];
 
 	void setUpWorley3D(int const level);
 
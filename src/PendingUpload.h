@@ -0,0 +1,24 @@
+#ifndef PENDINGUPLOAD_H
+#define PENDINGUPLOAD_H
+
+#include "MemoryAllocation.h"
+
+#include "vulkan/vulkan.h"
+
+#include <functional>
+
+//Upload already copied into staging memory, waiting for the next batch
+struct PendingUpload {
+	VkBuffer sourceBuffer = VK_NULL_HANDLE;
+	VkBuffer destinationBuffer = VK_NULL_HANDLE;
+	VkBufferCopy bufferCopy{};
+
+	uint64_t ringBytes = 0;
+
+	//Only set for dedicated staging buffers, freed with the batch
+	MemoryAllocation dedicatedStagingBufferAllocation;
+
+	std::function<void()> onComplete;
+};
+
+#endif // !PENDINGUPLOAD_H
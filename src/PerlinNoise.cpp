@@ -45,6 +45,37 @@ float PerlinNoise::noise(float const s, float const t) {
 	return interpolatedCombined;
 }
 
+float PerlinNoise::noise3D(float const s, float const t, float const r) {
+	int s0 = (int)floor(s);
+	int t0 = (int)floor(t);
+	int r0 = (int)floor(r);
+
+	float weightS = smootherstep(0, 1, s - s0);
+	float weightT = smootherstep(0, 1, t - t0);
+	float weightR = smootherstep(0, 1, r - r0);
+
+	float dots[2][2][2];
+
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 2; j++) {
+			for (int k = 0; k < 2; k++) {
+				glm::vec3 direction = glm::vec3(s - (s0 + i), t - (t0 + j), r - (r0 + k));
+				dots[i][j][k] = glm::dot(direction, getGradient3D(s0 + i, t0 + j, r0 + k));
+			}
+		}
+	}
+
+	float interpolated00 = dots[0][0][0] + weightS * (dots[1][0][0] - dots[0][0][0]);
+	float interpolated10 = dots[0][1][0] + weightS * (dots[1][1][0] - dots[0][1][0]);
+	float interpolated01 = dots[0][0][1] + weightS * (dots[1][0][1] - dots[0][0][1]);
+	float interpolated11 = dots[0][1][1] + weightS * (dots[1][1][1] - dots[0][1][1]);
+
+	float interpolated0 = interpolated00 + weightT * (interpolated10 - interpolated00);
+	float interpolated1 = interpolated01 + weightT * (interpolated11 - interpolated01);
+
+	return interpolated0 + weightR * (interpolated1 - interpolated0);
+}
+
 float PerlinNoise::octave(float const s, float const t, float const frequency, float const amplitude) {
 	return amplitude * noise(frequency * s, frequency * t);
 }
@@ -103,6 +134,17 @@ glm::vec2  PerlinNoise::getGradient(int32_t const x, int32_t const z) {
 	return  glm::normalize(glm::vec2(r * cosf(theta), r * sin(theta)));
 }
 
+glm::vec3 PerlinNoise::getGradient3D(int32_t const x, int32_t const y, int32_t const z) {
+	//The 12 edge directions of a cube, as in improved perlin noise
+	static glm::vec3 const gradients[12] = {
+		glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(-1.0f, 1.0f, 0.0f), glm::vec3(1.0f, -1.0f, 0.0f), glm::vec3(-1.0f, -1.0f, 0.0f),
+		glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(-1.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, 1.0f, 1.0f), glm::vec3(0.0f, -1.0f, 1.0f), glm::vec3(0.0f, 1.0f, -1.0f), glm::vec3(0.0f, -1.0f, -1.0f)
+	};
+
+	return gradients[std::min((int)(randomSampler.getSample1D(x, y, z) * 12.0f), 11)];
+}
+
 float PerlinNoise::smootherstep(float const a, float const b, float const value) {
 	float valueClamped = std::clamp((value - a) / (b - a), 0.0f, 1.0f);
 
@@ -13,6 +13,7 @@ public:
 	~PerlinNoise();
 
 	float noise(float const s, float const t);
+	float noise3D(float const s, float const t, float const r);
 	float octave(float const s, float const t, float const frequency, float const amplitude);
 	float combinedOctaves(float const s, float const t, float const startFrequency, float const frequencyStep, float const startAmplitude, float const amplitudeStep, int const octaveCount);
 	float domainWarpingCombinedOctaves(float const s, float const t, float const startFrequency, float const frequencyStep, float const startAmplitude, float const amplitudeStep, int const octaveCount);
@@ -24,6 +25,7 @@ private:
 	RandomSampler randomSampler;
 
 	glm::vec2 getGradient(int32_t const x, int32_t const z);
+	glm::vec3 getGradient3D(int32_t const x, int32_t const y, int32_t const z);
 	float smootherstep(float const a, float const b, float const value);
 };
 
@@ -3,6 +3,9 @@
 #include "Settings.h"
 #include "Vertex.h"
 #include "BigVertex.h"
+#include "ChunkVertex.h"
+
+#include <vector>
 
 #include <stdexcept>
 
@@ -10,7 +13,7 @@ PipelineCreator::PipelineCreator() {}
 
 PipelineCreator::~PipelineCreator() {}
 
-void PipelineCreator::createPipeLine(VkDevice const &device, VkExtent2D const &extent, VkDescriptorSetLayout const &descriptorSetLayout, VkRenderPass const &renderPass, char const *vertexShaderPath, char const *fragmentShaderPath, bool const wireframe, bool const bigVertex, VkPipelineLayout &pipelineLayout, VkPipeline &pipeline) {
+void PipelineCreator::createPipeLine(VkDevice const &device, VkExtent2D const &extent, VkDescriptorSetLayout const &descriptorSetLayout, VkRenderPass const &renderPass, char const *vertexShaderPath, char const *fragmentShaderPath, bool const wireframe, VertexType const vertexType, VkPipelineLayout &pipelineLayout, VkPipeline &pipeline) {
 	//Loading the shaders and creating there shader modules
 	Shader vertexShader = Shader(device, vertexShaderPath);
 	Shader fragmentShader = Shader(device, fragmentShaderPath);
@@ -35,23 +38,35 @@ void PipelineCreator::createPipeLine(VkDevice const &device, VkExtent2D const &e
 	VkPipelineVertexInputStateCreateInfo pipelineVertexInputStateCreateInfo{};
 	pipelineVertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-	if (!bigVertex) {
-		VkVertexInputBindingDescription vertexInputBindingDescription = Vertex::getVertexInputBindingDescription();
-		pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
-		pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBindingDescription;
-
-		std::array<VkVertexInputAttributeDescription, 6> vertexInputAttributeDescriptions = Vertex::getVertexInputAttributeDescription();
-		pipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size());
-		pipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
-	} else {
-		VkVertexInputBindingDescription vertexInputBindingDescription = BigVertex::getVertexInputBindingDescription();
-		pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
-		pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBindingDescription;
-
-		std::array<VkVertexInputAttributeDescription, 4> vertexInputAttributeDescriptions = BigVertex::getVertexInputAttributeDescription();
-		pipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size());
-		pipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
+	//Declared outside of the switch, the pipeline create info points to them until the pipeline is created
+	VkVertexInputBindingDescription vertexInputBindingDescription{};
+	std::vector<VkVertexInputAttributeDescription> vertexInputAttributeDescriptions;
+
+	switch (vertexType) {
+	case VertexType::VERTEX: {
+		vertexInputBindingDescription = Vertex::getVertexInputBindingDescription();
+		std::array<VkVertexInputAttributeDescription, 6> attributeDescriptions = Vertex::getVertexInputAttributeDescription();
+		vertexInputAttributeDescriptions.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+		break;
+	}
+	case VertexType::BIG_VERTEX: {
+		vertexInputBindingDescription = BigVertex::getVertexInputBindingDescription();
+		std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions = BigVertex::getVertexInputAttributeDescription();
+		vertexInputAttributeDescriptions.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+		break;
+	}
+	case VertexType::CHUNK_VERTEX: {
+		vertexInputBindingDescription = ChunkVertex::getVertexInputBindingDescription();
+		std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions = ChunkVertex::getVertexInputAttributeDescription();
+		vertexInputAttributeDescriptions.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+		break;
 	}
+	}
+
+	pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
+	pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBindingDescription;
+	pipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size());
+	pipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
 
 	//Creating the input assembly state create info struct, which is needed for the pipeline create info
 	VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{};
@@ -162,6 +177,10 @@ void PipelineCreator::createPipeLine(VkDevice const &device, VkExtent2D const &e
 }
 
 void PipelineCreator::createComputePipeLine(VkDevice const &device, VkDescriptorSetLayout const &descriptorSetLayout, char const *computeShaderPath, VkPipelineLayout &computePipelineLayout, VkPipeline &computePipeline) {
+	createComputePipeLine(device, descriptorSetLayout, computeShaderPath, 0, computePipelineLayout, computePipeline);
+}
+
+void PipelineCreator::createComputePipeLine(VkDevice const &device, VkDescriptorSetLayout const &descriptorSetLayout, char const *computeShaderPath, uint32_t const pushConstantSize, VkPipelineLayout &computePipelineLayout, VkPipeline &computePipeline) {
 	Shader computeShader = Shader(device, computeShaderPath);
 
 	//Creating the compute shader stage create info struct, which is needed for the compute pipeline create info
@@ -178,6 +197,16 @@ void PipelineCreator::createComputePipeLine(VkDevice const &device, VkDescriptor
 	computePipelineLayoutCreateInfo.setLayoutCount = 1;
 	computePipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
 
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = pushConstantSize;
+
+	if (pushConstantSize != 0) {
+		computePipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+		computePipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+	}
+
 	if (vkCreatePipelineLayout(device, &computePipelineLayoutCreateInfo, nullptr, &computePipelineLayout) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to compute create pipeline layout");
 	}
@@ -191,3 +220,34 @@ void PipelineCreator::createComputePipeLine(VkDevice const &device, VkDescriptor
 		throw std::runtime_error("Failed to create compute pipeline");
 	}
 }
+
+void PipelineCreator::createComputePipeLine(VkDevice const &device, VkPipelineLayout const &computePipelineLayout, char const *computeShaderPath, int32_t const specializationConstant, VkPipeline &computePipeline) {
+	Shader computeShader = Shader(device, computeShaderPath);
+
+	VkSpecializationMapEntry specializationMapEntry{};
+	specializationMapEntry.constantID = 0;
+	specializationMapEntry.offset = 0;
+	specializationMapEntry.size = sizeof(int32_t);
+
+	VkSpecializationInfo specializationInfo{};
+	specializationInfo.mapEntryCount = 1;
+	specializationInfo.pMapEntries = &specializationMapEntry;
+	specializationInfo.dataSize = sizeof(int32_t);
+	specializationInfo.pData = &specializationConstant;
+
+	VkPipelineShaderStageCreateInfo computeShaderStageCreateInfo{};
+	computeShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	computeShaderStageCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	computeShaderStageCreateInfo.module = computeShader.shaderModule;
+	computeShaderStageCreateInfo.pName = "main";
+	computeShaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
+
+	VkComputePipelineCreateInfo computePipelineCreateInfo{};
+	computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	computePipelineCreateInfo.layout = computePipelineLayout;
+	computePipelineCreateInfo.stage = computeShaderStageCreateInfo;
+
+	if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &computePipelineCreateInfo, nullptr, &computePipeline) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create compute pipeline");
+	}
+}
@@ -12,6 +12,8 @@
 #ifndef PIPELINECREATOR_H
 #define PIPELINECREATOR_H
 
+#include "VertexType.h"
+
 #include "vulkan/vulkan.h"
 
  /**
@@ -30,12 +32,19 @@ public:
 	 * @param descriptorSetLayout Descriptor set layout used for pipelineLayout creation.
 	 * @param renderPass Renderpass needed for pipeline creation.
 	 * @param wireframe If the rasterizer should "draw" in wireframe moder or not
+	 * @param vertexType Vertex struct the vertex input descriptions are taken from.
 	 * @param pipelineLayout Handle of the created pipeline layout.
 	 * @param pipeline Handle of the created pipeline.
 	 */
-	static void createPipeLine(VkDevice const &device, VkExtent2D const &extent, VkDescriptorSetLayout const &descriptorSetLayout, VkRenderPass const &renderPass, char const *vertexShaderPath, char const *fragmentShaderPath, bool const wireframe, bool const bigVertex, VkPipelineLayout &pipelineLayout, VkPipeline &pipeline);
+	static void createPipeLine(VkDevice const &device, VkExtent2D const &extent, VkDescriptorSetLayout const &descriptorSetLayout, VkRenderPass const &renderPass, char const *vertexShaderPath, char const *fragmentShaderPath, bool const wireframe, VertexType const vertexType, VkPipelineLayout &pipelineLayout, VkPipeline &pipeline);
 
 	static void createComputePipeLine(VkDevice const &device, VkDescriptorSetLayout const &descriptorSetLayout, char const *computeShaderPath, VkPipelineLayout &computePipelineLayout, VkPipeline &computePipeline);
+
+	//Same as above, with pushConstantSize bytes of push constants for the compute stage
+	static void createComputePipeLine(VkDevice const &device, VkDescriptorSetLayout const &descriptorSetLayout, char const *computeShaderPath, uint32_t const pushConstantSize, VkPipelineLayout &computePipelineLayout, VkPipeline &computePipeline);
+
+	//Another pipeline of the same shader for an existing layout, with the specialization constant of constant_id 0 set
+	static void createComputePipeLine(VkDevice const &device, VkPipelineLayout const &computePipelineLayout, char const *computeShaderPath, int32_t const specializationConstant, VkPipeline &computePipeline);
 };
 
 #endif // !PIPELINECREATOR_H
\ No newline at end of file
@@ -9,6 +9,22 @@
 #include <sstream>
 #include <fstream>
 
+namespace {
+	struct BenchmarkVariant {
+		int flags;
+		char const *name;
+	};
+
+	//The first one is the run of the integrator loop, the others are compared against it at equal time, see Profiler::isComparisonRun
+	BenchmarkVariant const BENCHMARK_VARIANTS[] = {
+		{ 0, "default" },
+		{ ComputeSettings::WAVEFRONT_FLAG, "wavefront" },
+		{ ComputeSettings::UNIFORM_LIGHTS_FLAG, "uniform-lights" }
+	};
+
+	size_t const BENCHMARK_VARIANT_COUNT = sizeof(BENCHMARK_VARIANTS) / sizeof(BENCHMARK_VARIANTS[0]);
+}
+
 Profiler::Profiler() {
 	if (!std::filesystem::exists("Benchmarks")) {
 		std::filesystem::create_directory("Benchmarks");
@@ -41,11 +57,18 @@ void Profiler::benchmarkSetUpData(glm::vec3 &cameraPosition, glm::vec3 &cameraDi
 
 		benchmarkIData = glm::ivec4(iData);
 		benchmarkIData.x = ComputeSettings::benchmarkStartIntegrator;
+		benchmarkIData.w = 0;
+		benchmarkVariant = 0;
+		benchmarkRays = 0;
+		baselineRaysPerSecond = 0.0;
+		baselineRelativeError = 0.0;
+		benchmarkRelativeError = 0.0;
 
 		oldBenchmarkStatus = ComputeSettings::benchmarkStatus;
 
 		benchmarkIteration = 0;
 		benchmarkRunTime = 0.0;
+		targetNoiseReached = false;
 
 		createBenchmarkFolders();
 	} else {
@@ -61,46 +84,40 @@ void Profiler::benchmarkSetUpData(glm::vec3 &cameraPosition, glm::vec3 &cameraDi
 
 void Profiler::benchmarkCollectData() {
 	benchmarkRunTime += elapsed;
+	benchmarkRays += ComputeSettings::writeBackData.data.x;
+
+	//The shader sums the relative error of the traced pixels in thousandths
+	if (ComputeSettings::writeBackData.data.w > 0) {
+		benchmarkRelativeError = (double)ComputeSettings::writeBackData.data.z / 1000.0 / ComputeSettings::writeBackData.data.w;
+	}
+
+	char const *kernel = BENCHMARK_VARIANTS[benchmarkVariant].name;
+
+	checkTargetNoise();
 
-	if (oldBenchmarkStatus == BenchmarkStatus::TIME) {
-		std::cout << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "\t" << benchmarkRunTime / 1000 << "/" << ComputeSettings::benchmarkMaxTime / 1000 << "s running" << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << std::endl;
+	if (oldBenchmarkStatus == BenchmarkStatus::TIME || isComparisonRun()) {
+		std::cout << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "\t" << benchmarkRunTime / 1000 << "/" << ComputeSettings::benchmarkMaxTime / 1000 << "s running" << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << kernel << std::endl;
 
-		std::ofstream file("Benchmarks/" + dateString + "/" + std::to_string(benchmarkIData.x) + "/profiling.txt", std::ios::out | std::ios::app);
+		std::ofstream file(getBenchmarkFolder() + "/profiling.txt", std::ios::out | std::ios::app);
 		if (file.is_open()) {
-			file << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "\t" << benchmarkRunTime / 1000 << "/" << ComputeSettings::benchmarkMaxTime / 1000 << "s running" << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << std::endl;
+			file << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "\t" << benchmarkRunTime / 1000 << "/" << ComputeSettings::benchmarkMaxTime / 1000 << "s running" << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << kernel << std::endl;
 			file.close();
 		}
 
 		if (benchmarkRunTime >= ComputeSettings::benchmarkMaxTime) {
-			benchmarkIteration = 0;
-			benchmarkRunTime = 0.0;
-
-			benchmarkIData.x += 1;
-
-			if (benchmarkIData.x >= ComputeSettings::integratorCount) {
-				oldBenchmarkStatus = BenchmarkStatus::OFF;
-				ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
-			}
+			finishBenchmarkRun();
 		}	
 	} else if (oldBenchmarkStatus == BenchmarkStatus::ITERATION) {
-		std::cout << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "/" << ComputeSettings::benchmarkMaxIterations << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << std::endl;
+		std::cout << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "/" << ComputeSettings::benchmarkMaxIterations << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << kernel << std::endl;
 
-		std::ofstream file("Benchmarks/" + dateString + "/" + std::to_string(benchmarkIData.x) + "/profiling.txt", std::ios::out | std::ios::app);
+		std::ofstream file(getBenchmarkFolder() + "/profiling.txt", std::ios::out | std::ios::app);
 		if (file.is_open()) {
-			file << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "/" << ComputeSettings::benchmarkMaxIterations << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << std::endl;
+			file << std::fixed << std::setprecision(2) << "Iteration: " << benchmarkIteration << "/" << ComputeSettings::benchmarkMaxIterations << "\t" << elapsed << "ms elapsed" << "\t" << 1000.0 / elapsed << "fps" << "\t" << ComputeSettings::writeBackData.data.x << "Rays" << "\t" << (double)ComputeSettings::writeBackData.data.x / 1000 / 1000 / 1000 / (elapsed / 1000) << "GRays/sec" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << kernel << std::endl;
 			file.close();
 		}
 
 		if (benchmarkIteration >= ComputeSettings::benchmarkMaxIterations) {
-			benchmarkIteration = 0;
-			benchmarkRunTime = 0.0;
-
-			benchmarkIData.x += 1;
-
-			if (benchmarkIData.x >= ComputeSettings::integratorCount) {
-				oldBenchmarkStatus = BenchmarkStatus::OFF;
-				ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
-			}
+			finishBenchmarkRun();
 		}
 	}
 }
@@ -117,4 +134,98 @@ void Profiler::createBenchmarkFolders() {
 	for (int i = ComputeSettings::benchmarkStartIntegrator; i < ComputeSettings::integratorCount; i++) {
 		std::filesystem::create_directory("Benchmarks/" + dateString + "/" + std::to_string(i));
 	}
+
+	for (size_t i = 1; i < BENCHMARK_VARIANT_COUNT; i++) {
+		std::filesystem::create_directory("Benchmarks/" + dateString + "/" + std::to_string(ComputeSettings::WAVEFRONT_INTEGRATOR) + "-" + BENCHMARK_VARIANTS[i].name);
+	}
+}
+
+bool Profiler::isComparisonRun() const {
+	return benchmarkVariant > 0 || benchmarkIData.x == ComputeSettings::WAVEFRONT_INTEGRATOR;
+}
+
+std::string Profiler::getBenchmarkFolder() const {
+	std::string folder = "Benchmarks/" + dateString + "/" + std::to_string(benchmarkIData.x);
+
+	if (benchmarkVariant > 0) {
+		folder += std::string("-") + BENCHMARK_VARIANTS[benchmarkVariant].name;
+	}
+
+	return folder;
+}
+
+void Profiler::finishBenchmarkRun() {
+	double raysPerSecond = (double)benchmarkRays / (benchmarkRunTime / 1000);
+
+	benchmarkIteration = 0;
+	benchmarkRunTime = 0.0;
+	benchmarkRays = 0;
+	targetNoiseReached = false;
+
+	if (benchmarkVariant > 0) {
+		std::cout << std::fixed << std::setprecision(2) << "Integrator " << benchmarkIData.x << "\t" << BENCHMARK_VARIANTS[benchmarkVariant].name << "\t" << raysPerSecond / 1000 / 1000 / 1000 << "GRays/sec" << "\t" << raysPerSecond / baselineRaysPerSecond << "x" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << baselineRelativeError * 100 << "% " << BENCHMARK_VARIANTS[0].name << std::endl;
+
+		std::ofstream file("Benchmarks/" + dateString + "/variant_comparison.txt", std::ios::out | std::ios::app);
+		if (file.is_open()) {
+			file << std::fixed << std::setprecision(2) << "Integrator " << benchmarkIData.x << "\t" << BENCHMARK_VARIANTS[benchmarkVariant].name << "\t" << raysPerSecond / 1000 / 1000 / 1000 << "GRays/sec" << "\t" << raysPerSecond / baselineRaysPerSecond << "x" << "\t" << benchmarkRelativeError * 100 << "% relative error" << "\t" << baselineRelativeError * 100 << "% " << BENCHMARK_VARIANTS[0].name << std::endl;
+			file.close();
+		}
+
+		benchmarkVariant++;
+
+		if (benchmarkVariant < BENCHMARK_VARIANT_COUNT) {
+			benchmarkIData.w = BENCHMARK_VARIANTS[benchmarkVariant].flags;
+			return;
+		}
+
+		benchmarkVariant = 0;
+		benchmarkIData.w = 0;
+
+		oldBenchmarkStatus = BenchmarkStatus::OFF;
+		ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
+		return;
+	}
+
+	if (benchmarkIData.x == ComputeSettings::WAVEFRONT_INTEGRATOR) {
+		baselineRaysPerSecond = raysPerSecond;
+		baselineRelativeError = benchmarkRelativeError;
+	}
+
+	benchmarkIData.x += 1;
+
+	if (benchmarkIData.x >= ComputeSettings::integratorCount) {
+		//The default run of the integrator is part of the loop above only if the benchmarks start at or before it
+		if (ComputeSettings::WAVEFRONT_INTEGRATOR >= ComputeSettings::benchmarkStartIntegrator) {
+			benchmarkVariant = 1;
+			benchmarkIData.x = ComputeSettings::WAVEFRONT_INTEGRATOR;
+			benchmarkIData.w = BENCHMARK_VARIANTS[benchmarkVariant].flags;
+		} else {
+			oldBenchmarkStatus = BenchmarkStatus::OFF;
+			ComputeSettings::benchmarkStatus = BenchmarkStatus::OFF;
+		}
+	}
+}
+
+void Profiler::checkTargetNoise() {
+	if (targetNoiseReached) {
+		return;
+	}
+
+	//Skipped tiles of the adaptive sampling are converged, so the count of the last frame covers the whole image
+	double pixelCount = (double)ComputeSettings::COMPUTE_WIDTH * ComputeSettings::COMPUTE_HEIGHT;
+	double convergedShare = 1.0 - ComputeSettings::writeBackData.data.y / pixelCount;
+
+	if (convergedShare < ComputeSettings::BENCHMARK_CONVERGED_SHARE) {
+		return;
+	}
+
+	targetNoiseReached = true;
+
+	std::cout << std::fixed << std::setprecision(2) << "Target noise reached after " << benchmarkRunTime / 1000 << "s in iteration " << benchmarkIteration << "\t" << (ComputeSettings::adaptiveSampling ? "adaptive" : "uniform") << " sampling" << std::endl;
+
+	std::ofstream file(getBenchmarkFolder() + "/time_to_noise.txt", std::ios::out | std::ios::app);
+	if (file.is_open()) {
+		file << std::fixed << std::setprecision(2) << "Target noise reached after " << benchmarkRunTime / 1000 << "s in iteration " << benchmarkIteration << "\t" << (ComputeSettings::adaptiveSampling ? "adaptive" : "uniform") << " sampling" << "\t" << ComputeSettings::CONVERGENCE_THRESHOLD << " relative error on " << ComputeSettings::BENCHMARK_CONVERGED_SHARE * 100 << "% of the pixels" << std::endl;
+		file.close();
+	}
 }
@@ -41,9 +41,33 @@ private:
 	uint64_t benchmarkIteration = 0;
 	double benchmarkRunTime = 0.0;
 
+	//Set once BENCHMARK_CONVERGED_SHARE of the pixels are converged for the current integrator
+	bool targetNoiseReached = false;
+
+	//Index into the variants of Profiler.cpp, the runs after the last integrator trace ComputeSettings::WAVEFRONT_INTEGRATOR again with other iData.w flags
+	size_t benchmarkVariant = 0;
+	//Over the current run, throughput and noise of the default run of WAVEFRONT_INTEGRATOR are kept for the comparison
+	uint64_t benchmarkRays = 0;
+	double baselineRaysPerSecond = 0.0;
+	double baselineRelativeError = 0.0;
+	//Mean relative error of the pixels traced in the last frame
+	double benchmarkRelativeError = 0.0;
+
 	std::string dateString;
 
 	void createBenchmarkFolders();
+
+	std::string getBenchmarkFolder() const;
+
+	//The runs of WAVEFRONT_INTEGRATOR the variants are compared on always end after ComputeSettings::benchmarkMaxTime, even with BenchmarkStatus::ITERATION
+	//With a fixed number of iterations the faster variant would trace for less time, which skews the comparison of the noise
+	bool isComparisonRun() const;
+
+	//Moves on to the next integrator, or to the next variant after the last one, and ends the benchmark after the last variant
+	void finishBenchmarkRun();
+
+	//Reports the time to the target noise of the current integrator once the unconverged pixels of the last frame drop low enough
+	void checkTargetNoise();
 };
 
 #endif // !PROFILER_H
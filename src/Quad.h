@@ -5,7 +5,13 @@
 
 struct Quad {
 	Vertex vertices[4];
-	uint32_t indices[6] = { 0, 1, 2, 3, 1, 0 };
+
+	//Split along the other diagonal because of the ambient occlusion, encoded in the vertex order once the quad is emitted
+	bool flipped = false;
+
+	//Every quad is drawn with this pattern, flipped quads emit their vertices in FLIPPED_ORDER
+	static constexpr uint32_t INDICES[6] = { 0, 1, 2, 3, 1, 0 };
+	static constexpr int FLIPPED_ORDER[4] = { 2, 3, 1, 0 };
 };
 
 inline bool operator< (Quad const &a, Quad const &b) {
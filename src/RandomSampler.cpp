@@ -6,29 +6,84 @@
 thread_local std::mt19937_64 RandomSampler::merseneTwister = std::mt19937_64();
 thread_local std::uniform_real_distribution<float> RandomSampler::distribution = std::uniform_real_distribution<float>(0.0f, 1.0f);
 
+thread_local uint64_t RandomSampler::key = 0;
+thread_local uint64_t RandomSampler::counter = 0;
+
 RandomSampler::RandomSampler() {}
 
 RandomSampler::~RandomSampler() {}
 
 float RandomSampler::getSample1D(int32_t const x, int32_t const y) {
+	if (Settings::RANDOM_SAMPLER_MODE == RandomSamplerMode::COUNTER_BASED) {
+		return toFloat(splitMix(getKey(x, y)));
+	}
+
 	merseneTwister.seed(Settings::SEED ^ (static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y)));
 
 	return distribution(merseneTwister);
 }
 
 void RandomSampler::getSample2D(int32_t const x, int32_t const y, float &r1, float &r2) {
+	if (Settings::RANDOM_SAMPLER_MODE == RandomSamplerMode::COUNTER_BASED) {
+		uint64_t sampleKey = getKey(x, y);
+
+		r1 = toFloat(splitMix(sampleKey));
+		r2 = toFloat(splitMix(sampleKey + 1));
+
+		return;
+	}
+
 	merseneTwister.seed(Settings::SEED ^ (static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y)));
 
 	r1 = distribution(merseneTwister);
 	r2 = distribution(merseneTwister);
 }
 
+float RandomSampler::getSample1D(int32_t const x, int32_t const y, int32_t const z) {
+	if (Settings::RANDOM_SAMPLER_MODE == RandomSamplerMode::COUNTER_BASED) {
+		return toFloat(splitMix(getKey(x, y) ^ splitMix(static_cast<uint32_t>(z))));
+	}
+
+	merseneTwister.seed(Settings::SEED ^ (static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y)) ^ (static_cast<uint64_t>(static_cast<uint32_t>(z)) * 0xD1B54A32D192ED03ull));
+
+	return distribution(merseneTwister);
+}
+
 void RandomSampler::resetSampler(int32_t const x, int32_t const y) {
+	if (Settings::RANDOM_SAMPLER_MODE == RandomSamplerMode::COUNTER_BASED) {
+		key = getKey(x, y);
+		counter = 1;
+
+		return;
+	}
+
 	merseneTwister.seed(Settings::SEED ^ (static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y)));
 
 	merseneTwister.discard(1);
 }
 
 float RandomSampler::getSample1DNonReset() {
+	if (Settings::RANDOM_SAMPLER_MODE == RandomSamplerMode::COUNTER_BASED) {
+		return toFloat(splitMix(key + counter++));
+	}
+
 	return distribution(merseneTwister);
 }
+
+uint64_t RandomSampler::splitMix(uint64_t value) {
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+
+	return value ^ (value >> 31);
+}
+
+uint64_t RandomSampler::getKey(int32_t const x, int32_t const y) {
+	//Hashing the position once, so neighbouring positions get unrelated streams even though the counter is just added
+	return splitMix(splitMix(Settings::SEED) ^ (static_cast<uint64_t>(x) << 32 | static_cast<uint32_t>(y)));
+}
+
+float RandomSampler::toFloat(uint64_t const value) {
+	//Upper 24 bits fill the float mantissa, so the result is in [0, 1)
+	return (value >> 40) * (1.0f / 16777216.0f);
+}
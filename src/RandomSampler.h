@@ -10,6 +10,7 @@ public:
 
 	float getSample1D(int32_t const x, int32_t const y);
 	void getSample2D(int32_t const x, int32_t const y, float &r1, float &r2);
+	float getSample1D(int32_t const x, int32_t const y, int32_t const z);
 
 	void resetSampler(int32_t const x, int32_t const y);
 	float getSample1DNonReset();
@@ -17,6 +18,14 @@ public:
 private:
 	static thread_local std::mt19937_64 merseneTwister;
 	static thread_local std::uniform_real_distribution<float> distribution;
+
+	//State of the counter based generator, a sample is the hash of the key and the counter
+	static thread_local uint64_t key;
+	static thread_local uint64_t counter;
+
+	static uint64_t splitMix(uint64_t value);
+	static uint64_t getKey(int32_t const x, int32_t const y);
+	static float toFloat(uint64_t const value);
 };
 
-#endif // !RANDOMSAMPLER_H
\ No newline at end of file
+#endif // !RANDOMSAMPLER_H
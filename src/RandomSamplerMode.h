@@ -0,0 +1,9 @@
+#ifndef RANDOMSAMPLERMODE_H
+#define RANDOMSAMPLERMODE_H
+
+enum RandomSamplerMode : unsigned char {
+	COUNTER_BASED = 0,
+	MERSENNE_TWISTER = 1
+};
+
+#endif // !RANDOMSAMPLERMODE_H
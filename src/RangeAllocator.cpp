@@ -0,0 +1,93 @@
+#include "RangeAllocator.h"
+
+#include <algorithm>
+#include <iterator>
+
+RangeAllocator::RangeAllocator() {}
+
+RangeAllocator::RangeAllocator(uint64_t const size) : size(size) {
+	freeRanges[0] = size;
+}
+
+RangeAllocator::~RangeAllocator() {}
+
+bool RangeAllocator::allocate(uint64_t const size, uint64_t const alignment, uint64_t &offset) {
+	for (auto iterator = freeRanges.begin(); iterator != freeRanges.end(); iterator++) {
+		uint64_t rangeStart = iterator->first;
+		uint64_t rangeEnd = iterator->first + iterator->second;
+
+		//Not a power of two for vertex strides, so no bit masking
+		uint64_t alignedStart = (rangeStart + alignment - 1) / alignment * alignment;
+
+		if (alignedStart + size > rangeEnd) {
+			continue;
+		}
+
+		freeRanges.erase(iterator);
+
+		//Padding in front and the rest behind the allocation stay free
+		if (alignedStart > rangeStart) {
+			freeRanges[rangeStart] = alignedStart - rangeStart;
+		}
+		if (alignedStart + size < rangeEnd) {
+			freeRanges[alignedStart + size] = rangeEnd - (alignedStart + size);
+		}
+
+		allocationCount++;
+		usedBytes += size;
+
+		offset = alignedStart;
+		return true;
+	}
+
+	return false;
+}
+
+void RangeAllocator::free(uint64_t const offset, uint64_t const size) {
+	auto iterator = freeRanges.emplace(offset, size).first;
+
+	//Merging with the following free range
+	auto next = std::next(iterator);
+	if (next != freeRanges.end() && iterator->first + iterator->second == next->first) {
+		iterator->second += next->second;
+		freeRanges.erase(next);
+	}
+
+	//Merging with the preceding free range
+	if (iterator != freeRanges.begin()) {
+		auto previous = std::prev(iterator);
+		if (previous->first + previous->second == iterator->first) {
+			previous->second += iterator->second;
+			freeRanges.erase(iterator);
+		}
+	}
+
+	allocationCount--;
+	usedBytes -= size;
+}
+
+uint64_t RangeAllocator::getSize() const {
+	return size;
+}
+
+uint64_t RangeAllocator::getUsedBytes() const {
+	return usedBytes;
+}
+
+size_t RangeAllocator::getAllocationCount() const {
+	return allocationCount;
+}
+
+size_t RangeAllocator::getFreeRangeCount() const {
+	return freeRanges.size();
+}
+
+uint64_t RangeAllocator::getLargestFreeRange() const {
+	uint64_t largestFreeRange = 0;
+
+	for (auto iterator = freeRanges.begin(); iterator != freeRanges.end(); iterator++) {
+		largestFreeRange = std::max(largestFreeRange, iterator->second);
+	}
+
+	return largestFreeRange;
+}
@@ -0,0 +1,38 @@
+#ifndef RANGEALLOCATOR_H
+#define RANGEALLOCATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+
+//First fit free list over the offsets [0, size), used for memory blocks and arena buffers
+class RangeAllocator {
+public:
+	RangeAllocator();
+	RangeAllocator(uint64_t const size);
+	~RangeAllocator();
+
+	bool allocate(uint64_t const size, uint64_t const alignment, uint64_t &offset);
+
+	void free(uint64_t const offset, uint64_t const size);
+
+	uint64_t getSize() const;
+
+	uint64_t getUsedBytes() const;
+
+	size_t getAllocationCount() const;
+
+	size_t getFreeRangeCount() const;
+
+	uint64_t getLargestFreeRange() const;
+
+private:
+	uint64_t size = 0;
+	uint64_t usedBytes = 0;
+	size_t allocationCount = 0;
+
+	//Offset to size of every free range, neighbouring ranges are always merged
+	std::map<uint64_t, uint64_t> freeRanges;
+};
+
+#endif // !RANGEALLOCATOR_H
@@ -20,6 +20,9 @@ RenderSynchronisation::~RenderSynchronisation() {
 	}
 
 	vkDestroyFence(device, computeFence, nullptr);
+
+	vkDestroySemaphore(device, computeFinishedSemaphore, nullptr);
+	vkDestroySemaphore(device, quadFinishedSemaphore, nullptr);
 }
 
 void RenderSynchronisation::createRenderSynchronisationObjects(VkDevice const &device, uint32_t const swapChainImageCount) {
@@ -58,4 +61,12 @@ void RenderSynchronisation::createRenderSynchronisationObjects(VkDevice const &d
 	if (vkCreateFence(device, &fenceCreateInfo, nullptr, &computeFence) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create compute fence");
 	}
+
+	if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &computeFinishedSemaphore) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create semaphore");
+	}
+
+	if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &quadFinishedSemaphore) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create semaphore");
+	}
 }
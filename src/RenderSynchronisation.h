@@ -58,6 +58,10 @@ public:
 
 	VkFence computeFence;
 
+	//The quad pass of the photo mode waits for the compute submission finishing a pass, which in turn waits for the quad passes sampling the image before it
+	VkSemaphore computeFinishedSemaphore;
+	VkSemaphore quadFinishedSemaphore;
+
 private:
 
 	/**
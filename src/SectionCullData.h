@@ -0,0 +1,17 @@
+#ifndef SECTIONCULLDATA_H
+#define SECTIONCULLDATA_H
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+
+//Push constants of shaders/cull.comp, the planes point inwards and are not normalized
+struct SectionCullData {
+	glm::vec4 planes[6];
+	uint32_t sectionCount;
+
+	//If set, only the sections marked in the visibility bits of this frame can be drawn, see SectionVisibility
+	uint32_t occlusionCulling;
+};
+
+#endif // !SECTIONCULLDATA_H
@@ -0,0 +1,19 @@
+#ifndef SECTIONSTEP_H
+#define SECTIONSTEP_H
+
+#include <cstdint>
+
+//One section on the visibility walk of SectionVisibility, in chunk coordinates
+struct SectionStep {
+	int x;
+	int y;
+	int z;
+
+	//Face the walk came in through, -1 for the section of the camera
+	int entryFace;
+
+	//Bit per face the walk already went out through, it never goes back through the opposite one
+	uint8_t directions;
+};
+
+#endif // !SECTIONSTEP_H
@@ -0,0 +1,185 @@
+#include "SectionVisibility.h"
+#include "LoadedChunkStack.h"
+#include "Settings.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+	int const FACE_OFFSETS[SectionVisibility::FACE_COUNT][3] = { {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1} };
+
+	//Walked sections per column, one more than the terrain can reach for the trees on top
+	int const SECTION_LAYERS = Settings::MAX_HEIGHT / Settings::CHUNK_SIZE + 1;
+
+	//Bit of the pair faceA < faceB among the 15 face pairs
+	int getPairIndex(int const faceA, int const faceB) {
+		return faceA * (2 * SectionVisibility::FACE_COUNT - faceA - 1) / 2 + faceB - faceA - 1;
+	}
+}
+
+SectionVisibility::SectionVisibility() {}
+
+SectionVisibility::~SectionVisibility() {}
+
+uint16_t SectionVisibility::calculateConnectivity(Chunk const &chunk) {
+	int const size = Settings::CHUNK_SIZE;
+
+	//Called from the generation tasks, so every thread keeps its own buffers
+	thread_local std::vector<uint8_t> seen;
+	thread_local std::vector<int> stack;
+
+	seen.assign(size * size * size, 0);
+
+	uint16_t connectivity = 0;
+
+	for (int start = 0; start < size * size * size && connectivity != ALL_CONNECTED; start++) {
+		//Same index order as the cubes array, [u][w][v] with v being the height
+		if (seen[start] || chunk.cubes[start / (size * size)][(start / size) % size][start % size].cubeType != CubeType::AIR) {
+			continue;
+		}
+
+		uint8_t faces = 0;
+
+		seen[start] = 1;
+		stack.clear();
+		stack.push_back(start);
+
+		while (!stack.empty()) {
+			int index = stack.back();
+			stack.pop_back();
+
+			int u = index / (size * size);
+			int w = (index / size) % size;
+			int v = index % size;
+
+			faces |= (u == 0 ? 1 : 0) | (u == size - 1 ? 2 : 0) | (v == 0 ? 4 : 0) | (v == size - 1 ? 8 : 0) | (w == 0 ? 16 : 0) | (w == size - 1 ? 32 : 0);
+
+			int neighbours[6][3] = { {u - 1, w, v}, {u + 1, w, v}, {u, w - 1, v}, {u, w + 1, v}, {u, w, v - 1}, {u, w, v + 1} };
+
+			for (int i = 0; i < 6; i++) {
+				int nu = neighbours[i][0];
+				int nw = neighbours[i][1];
+				int nv = neighbours[i][2];
+
+				if (nu < 0 || nu >= size || nw < 0 || nw >= size || nv < 0 || nv >= size) {
+					continue;
+				}
+
+				int neighbourIndex = (nu * size + nw) * size + nv;
+
+				if (!seen[neighbourIndex] && chunk.cubes[nu][nw][nv].cubeType == CubeType::AIR) {
+					seen[neighbourIndex] = 1;
+					stack.push_back(neighbourIndex);
+				}
+			}
+		}
+
+		//Every pair of faces this air pocket touches can see each other
+		for (int faceA = 0; faceA < FACE_COUNT; faceA++) {
+			for (int faceB = faceA + 1; faceB < FACE_COUNT; faceB++) {
+				if ((faces & (1 << faceA)) && (faces & (1 << faceB))) {
+					connectivity |= (uint16_t)(1 << getPairIndex(faceA, faceB));
+				}
+			}
+		}
+	}
+
+	return connectivity;
+}
+
+bool SectionVisibility::isConnected(uint16_t const connectivity, int const faceA, int const faceB) {
+	if (faceA == faceB) {
+		return true;
+	}
+
+	return (connectivity >> getPairIndex(std::min(faceA, faceB), std::max(faceA, faceB))) & 1;
+}
+
+bool SectionVisibility::findVisibleSections(std::map<Coordinates, LoadedChunkStack *> const &loadedChunkStacks, glm::vec3 const &cameraPosition, Frustum const &frustum, std::vector<std::pair<LoadedChunkStack *, size_t>> &visibleSections) {
+	visibleSections.clear();
+
+	int cameraX = (int)std::floor(cameraPosition.x / Settings::CHUNK_SIZE);
+	int cameraY = std::min(std::max((int)std::floor(cameraPosition.y / Settings::CHUNK_SIZE), 0), SECTION_LAYERS - 1);
+	int cameraZ = (int)std::floor(cameraPosition.z / Settings::CHUNK_SIZE);
+
+	if (loadedChunkStacks.find({ cameraX, cameraZ }) == loadedChunkStacks.end()) {
+		return false;
+	}
+
+	//Everything that can be loaded lies within LOADED_CHUNKS columns of the camera
+	int const radius = Settings::LOADED_CHUNKS;
+	int const width = 2 * radius + 1;
+
+	visited.assign((size_t)width * width * SECTION_LAYERS, 0);
+	queue.clear();
+
+	auto getVisitedIndex = [&](int const x, int const y, int const z) {
+		return ((size_t)(x - cameraX + radius) * width + (size_t)(z - cameraZ + radius)) * SECTION_LAYERS + y;
+	};
+
+	queue.push_back({ cameraX, cameraY, cameraZ, -1, 0 });
+	visited[getVisitedIndex(cameraX, cameraY, cameraZ)] = 1;
+
+	for (size_t head = 0; head < queue.size(); head++) {
+		SectionStep step = queue[head];
+
+		auto iterator = loadedChunkStacks.find({ step.x, step.z });
+		if (iterator == loadedChunkStacks.end()) {
+			continue;
+		}
+
+		LoadedChunkStack *loadedChunkStack = iterator->second;
+
+		uint16_t connectivity = ALL_CONNECTED;
+
+		if (loadedChunkStack->chunkStackReady && !loadedChunkStack->willBeRemoved && step.y < (int)loadedChunkStack->chunkStack.stack.size()) {
+			connectivity = loadedChunkStack->sectionConnectivity[step.y];
+
+			//Sections above the walked layers are only reachable from the top one
+			size_t lastY = step.y == SECTION_LAYERS - 1 ? loadedChunkStack->chunkStack.stack.size() - 1 : step.y;
+
+			for (size_t y = step.y; y <= lastY; y++) {
+				if (loadedChunkStack->chunkIndexCount[y] != 0 || loadedChunkStack->objIndexCount[y] != 0) {
+					visibleSections.push_back({ loadedChunkStack, y });
+				}
+			}
+		}
+
+		for (int face = 0; face < FACE_COUNT; face++) {
+			//Never back towards the camera, opposite faces only differ in the lowest bit
+			if (step.directions & (1 << (face ^ 1))) {
+				continue;
+			}
+
+			if (step.entryFace != -1 && !isConnected(connectivity, step.entryFace, face)) {
+				continue;
+			}
+
+			int x = step.x + FACE_OFFSETS[face][0];
+			int y = step.y + FACE_OFFSETS[face][1];
+			int z = step.z + FACE_OFFSETS[face][2];
+
+			if (y < 0 || y >= SECTION_LAYERS || std::abs(x - cameraX) > radius || std::abs(z - cameraZ) > radius) {
+				continue;
+			}
+
+			size_t visitedIndex = getVisitedIndex(x, y, z);
+			if (visited[visitedIndex]) {
+				continue;
+			}
+
+			glm::vec3 minB;
+			glm::vec3 maxB;
+			LoadedChunkStack::getSectionBounds(x, y, z, minB, maxB);
+
+			if (!frustum.isInside(AABB(minB, maxB))) {
+				continue;
+			}
+
+			visited[visitedIndex] = 1;
+			queue.push_back({ x, y, z, face ^ 1, (uint8_t)(step.directions | (1 << face)) });
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,46 @@
+#ifndef SECTIONVISIBILITY_H
+#define SECTIONVISIBILITY_H
+
+#include "Chunk.h"
+#include "Coordinates.h"
+#include "Frustum.h"
+#include "SectionStep.h"
+
+#include "glm/glm.hpp"
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+class LoadedChunkStack;
+
+//Cave culling of the 32^3 chunk sections, the view can only pass through a section between two of its faces which are connected by air
+//Every frame the sections are walked from the camera outwards, never back towards it and only into sections inside the frustum
+class SectionVisibility {
+public:
+	SectionVisibility();
+	~SectionVisibility();
+
+	//-x, +x, -y, +y, -z, +z, so the opposite face only differs in the lowest bit
+	static int const FACE_COUNT = 6;
+
+	//One bit for each of the 15 face pairs
+	static uint16_t const ALL_CONNECTED = 0x7FFF;
+
+	//Flood fills the air of the chunk, called once when the section is meshed
+	static uint16_t calculateConnectivity(Chunk const &chunk);
+
+	static bool isConnected(uint16_t const connectivity, int const faceA, int const faceB);
+
+	//Fills visibleSections with the non empty sections of the ready stacks the walk reaches, sections above a stack or of a stack still loading count as air
+	//Returns false if the column of the camera is not loaded, nothing is culled by the walk then
+	bool findVisibleSections(std::map<Coordinates, LoadedChunkStack *> const &loadedChunkStacks, glm::vec3 const &cameraPosition, Frustum const &frustum, std::vector<std::pair<LoadedChunkStack *, size_t>> &visibleSections);
+
+private:
+	//Reused every frame, one byte per section around the camera that can be loaded
+	std::vector<uint8_t> visited;
+	std::vector<SectionStep> queue;
+};
+
+#endif // !SECTIONVISIBILITY_H
@@ -5,6 +5,8 @@ Settings::~Settings() {}
 int Settings::WINDOW_WIDTH = 1024;
 int Settings::WINDOW_HEIGHT = 768;
 float const Settings::BIOM_SIZE = 0.125f;
+RandomSamplerMode Settings::RANDOM_SAMPLER_MODE = RandomSamplerMode::MERSENNE_TWISTER;
+TerrainMode Settings::TERRAIN_MODE = TerrainMode::HEIGHT_MAP;
 
 BiomData const Settings::plainsData = { 0.125f, 0.15f, 7.0f, 0.75f, 0.003125f, 1.0f, 0.00625f }; //Warm und feucht
 BiomData const Settings::mountainData = { 0.125f, 1.0f, 6.0f, 1.0f, 0.0125f, 0.5f, 0.0125f }; //Kalt und trocken
@@ -17,5 +19,8 @@ TreeDescription const Settings::simpleCactusDescription = { "A", {{'A', "Ta"}, {
 
 bool Settings::IN_PHOTO_MODE = false;
 bool Settings::UPDATE_FRUSTUM = true;
+bool Settings::PRINT_MEMORY_STATS = false;
+bool Settings::PRINT_CULLING_STATS = false;
+bool Settings::OCCLUSION_CULLING = true;
 
 SkyUBO Settings::skyUbo = {glm::vec4(0.0f), glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)};
\ No newline at end of file
@@ -14,7 +14,10 @@
 
 #include "BiomData.h"
 #include "TreeDescription.h"
+#include "RandomSamplerMode.h"
+#include "TerrainMode.h"
 #include "SkyUBO.h"
+#include "ShaderDirectory.h"
 
 /**
  * @brief "Static" class, which provides helpful game settings.
@@ -27,8 +30,8 @@ public:
 	static constexpr char const WINDOW_NAME[] = "Terra Mater";
     static constexpr char const ENGINE_NAME[] = "KITty Cat Engine";
 
-    static constexpr char const VERTEX_SHADER_PATH[] = "shaders/shader.vert.spv";
-    static constexpr char const FRAGMENT_SHADER_PATH[] = "shaders/shader.frag.spv";
+    static constexpr char const VERTEX_SHADER_PATH[] = SHADER_DIRECTORY "shader.vert.spv";
+    static constexpr char const FRAGMENT_SHADER_PATH[] = SHADER_DIRECTORY "shader.frag.spv";
 
     static int const TEXTURE_COUNT = 32;
     static constexpr char const MISSING_TEXTURE_PATH[] = "textures/missing.png";
@@ -78,8 +81,8 @@ public:
     static constexpr char const SKYBOX_FRONT_NIGHT_TEXTURE_PATH[] = "textures/skybox/skybox_front_night.png";
     static constexpr char const SKYBOX_BACK_NIGHT_TEXTURE_PATH[] = "textures/skybox/skybox_back_night.png";
 
-    static constexpr char const OBJ_VERTEX_SHADER_PATH[] = "shaders/obj.vert.spv";
-    static constexpr char const OBJ_FRAGMENT_SHADER_PATH[] = "shaders/obj.frag.spv";
+    static constexpr char const OBJ_VERTEX_SHADER_PATH[] = SHADER_DIRECTORY "obj.vert.spv";
+    static constexpr char const OBJ_FRAGMENT_SHADER_PATH[] = SHADER_DIRECTORY "obj.frag.spv";
 
     static int const OBJ_COUNT = 5;
 
@@ -153,19 +156,63 @@ public:
     static constexpr char const LOTUS_TEXTURE_PATH[] = "textures/obj/lotus.png";
     static constexpr char const SUCCULENT_TEXTURE_PATH[] = "textures/obj/succulent.png";
 
-    static constexpr char const SKY_VERTEX_SHADER_PATH[] = "shaders/sky.vert.spv";
-    static constexpr char const SKY_FRAGMENT_SHADER_PATH[] = "shaders/sky.frag.spv";
+    static constexpr char const SKY_VERTEX_SHADER_PATH[] = SHADER_DIRECTORY "sky.vert.spv";
+    static constexpr char const SKY_FRAGMENT_SHADER_PATH[] = SHADER_DIRECTORY "sky.frag.spv";
+
+    static constexpr char const CULL_COMPUTE_SHADER_PATH[] = SHADER_DIRECTORY "cull.comp.spv";
 
     static int const MAX_FRAMES_IN_FLIGHT = 2;
 
+    //Size of the VkDeviceMemory blocks the MemoryAllocator sub-allocates chunk buffers from, bigger buffers get their own block
+    static unsigned long long const MEMORY_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+    //Chunk meshes are put into shared arena buffers and drawn with vkCmdDrawIndexedIndirect, false binds every chunk on its own
+    static bool const DRAW_CHUNKS_INDIRECT = true;
+    static unsigned long long const CHUNK_ARENA_VERTEX_PAGE_SIZE = 32ull * 1024 * 1024;
+    static unsigned long long const CHUNK_ARENA_INDEX_PAGE_SIZE = 16ull * 1024 * 1024;
+
+    //Visible chunks are split into this many slices, each recorded into its own secondary command buffer on the ThreadPool
+    static int const CHUNK_RECORDING_SLICES = 4;
+
+    //All chunks share one uint16 quad index buffer instead of uploading their own indices
+    static bool const SHARED_QUAD_INDICES = true;
+    //Quads addressable with uint16 indices, bigger chunk meshes are split into several draws
+    static uint32_t const QUAD_INDEX_BUFFER_QUAD_COUNT = 65536 / 4;
+
+    //Chunk sections are frustum culled by shaders/cull.comp, which writes the indirect draws of the chunk arena
+    //Needs DRAW_CHUNKS_INDIRECT and drawIndirectFirstInstance, otherwise the sections are culled on the CPU
+    static bool const GPU_SECTION_CULLING = true;
+    //Draw slots of one arena page, the culling pass writes one draw per slot, a multiple of 32 for the visibility bits
+    static uint32_t const CHUNK_ARENA_PAGE_SECTIONS = 4096;
+    //Has to match local_size_x of shaders/cull.comp
+    static uint32_t const SECTION_CULLING_GROUP_SIZE = 64;
+
+    //Persistent staging memory of the UploadQueue, bigger uploads get a temporary staging buffer
+    static unsigned long long const STAGING_RING_SIZE = 32ull * 1024 * 1024;
+    //How long the upload thread waits on the oldest batch before submitting what piled up in the meantime
+    static unsigned long long const UPLOAD_BATCH_WAIT_NANOSECONDS = 1000000ull;
+
     static int const CHUNK_SIZE = 32;
     static int const LOADED_CHUNKS = 16;
+    //Columns further away get meshed from blocks of 2^level cubes per axis, the level grows by one every LOD_RING_WIDTH columns
+    static bool const CHUNK_LOD = true;
+    static int const LOD_RING_WIDTH = 3;
+    static int const MAX_LOD_LEVEL = 3;
     static int const MIN_HEIGHT = 1;
     static int const MAX_HEIGHT = 256;
     static int const WATER_LEVEL = 64;
 
+    //DENSITY_FIELD adds caves and overhangs, the 3D noise is sampled every DENSITY_LATTICE_* cubes and interpolated
+    static TerrainMode TERRAIN_MODE;
+    static int const DENSITY_LATTICE_XZ = 4;
+    static int const DENSITY_LATTICE_Y = 8;
+    static int const DENSITY_OVERHANG = 16;
+
     static float const BIOM_SIZE;
     static unsigned long const SEED = 0;
+    //MERSENNE_TWISTER is the default and reproduces the worlds saved under SEED before the counter based sampler was added
+    //COUNTER_BASED generates differently, so it only fits new seeds or deleted save folders
+    static RandomSamplerMode RANDOM_SAMPLER_MODE;
     static BiomData const plainsData;
     static BiomData const mountainData;
     static BiomData const desertData;
@@ -177,6 +224,10 @@ public:
 
     static bool IN_PHOTO_MODE;
     static bool UPDATE_FRUSTUM;
+    static bool PRINT_MEMORY_STATS;
+    static bool PRINT_CULLING_STATS;
+    //Skips the chunk sections hidden behind terrain, see SectionVisibility
+    static bool OCCLUSION_CULLING;
 
     static SkyUBO skyUbo;
 
@@ -0,0 +1,9 @@
+#ifndef SHADERDIRECTORY_H
+#define SHADERDIRECTORY_H
+
+//Set by the build to the directory glslc writes the SPIR-V into, the fallback is relative to the working directory
+#ifndef SHADER_DIRECTORY
+#define SHADER_DIRECTORY "shaders/"
+#endif // !SHADER_DIRECTORY
+
+#endif // !SHADERDIRECTORY_H
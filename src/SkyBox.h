@@ -10,6 +10,9 @@ public:
 	SkyBox(VkDevice const &device, ImageCreator const &imageCreator);
 	~SkyBox();
 
+	//Same as for the TextureArray, the CpuPathTracer only reads the day sides
+	static char const *getTexturePath(size_t const side);
+
 	Texture textures[Settings::SKYBOX_TEXTURE_COUNT];
 
 private:
@@ -0,0 +1,9 @@
+#ifndef TERRAINMODE_H
+#define TERRAINMODE_H
+
+enum TerrainMode : unsigned char {
+	HEIGHT_MAP = 0,
+	DENSITY_FIELD = 1
+};
+
+#endif // !TERRAINMODE_H
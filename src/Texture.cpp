@@ -3,7 +3,7 @@
 Texture::Texture() {}
 
 Texture::Texture(VkDevice const &device, const char *filePath, ImageCreator const &imageCreator)
-	: device(device) {
+	: filePath(filePath), device(device) {
 	imageCreator.createTextureImage(filePath, textureImage, textureImageMemory);
 	imageCreator.createTextureImageView(textureImage, textureImageView);
 	imageCreator.createTextureSampler(textureSampler);
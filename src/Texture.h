@@ -42,6 +42,11 @@ public:
 	 */
 	VkDeviceMemory textureImageMemory;
 
+	/**
+	 * @brief Path the texture was loaded from, one of the paths in Settings.
+	 */
+	char const *filePath = nullptr;
+
 	Texture();
 
 	/**
@@ -6,9 +6,74 @@
 
 TextureArray::TextureArray() {}
 
+char const *TextureArray::getTexturePath(size_t const cubeType) {
+	switch (cubeType) {
+	case CubeType::WATER:
+		return Settings::WATER_TEXTURE_PATH;
+	case CubeType::GLASS:
+		return Settings::GLASS_TEXTURE_PATH;
+	case CubeType::BEDROCK:
+		return Settings::BEDROCK_TEXTURE_PATH;
+	case CubeType::DIRT:
+		return Settings::DIRT_TEXTURE_PATH;
+	case CubeType::GRASS_BLOCK:
+		return Settings::GRASS_BLOCK_TEXTURE_PATH;
+	case CubeType::GRASS_BLOCK_TOP:
+		return Settings::GRASS_BLOCK_TOP_TEXTURE_PATH;
+	case CubeType::STONE:
+		return Settings::STONE_TEXTURE_PATH;
+	case CubeType::SNOW:
+		return Settings::SNOW_TEXTURE_PATH;
+	case CubeType::SAND:
+		return Settings::SAND_TEXTURE_PATH;
+	case CubeType::COBBLESTONE:
+		return Settings::COBBLESTONE_TEXTURE_PATH;
+	case CubeType::ACACIA_LEAVES:
+		return Settings::ACACIA_LEAVES_TEXTURE_PATH;
+	case CubeType::ACACIA_LOG:
+		return Settings::ACACIA_LOG_TEXTURE_PATH;
+	case CubeType::ACACIA_LOG_TOP:
+		return Settings::ACACIA_LOG_TOP_TEXTURE_PATH;
+	case CubeType::BIRCH_LEAVES:
+		return Settings::BIRCH_LEAVES_TEXTURE_PATH;
+	case CubeType::BIRCH_LOG:
+		return Settings::BIRCH_LOG_TEXTURE_PATH;
+	case CubeType::BIRCK_LOG_TOP:
+		return Settings::BIRCK_LOG_TOP_TEXTURE_PATH;
+	case CubeType::CACTUS:
+		return Settings::CACTUS_TEXTURE_PATH;
+	case CubeType::CACTUS_TOP:
+		return Settings::CACTUS_TOP_TEXTURE_PATH;
+	case CubeType::DARK_OAK_LEAVES:
+		return Settings::DARK_OAK_LEAVES_TEXTURE_PATH;
+	case CubeType::DARK_OAK_LOG:
+		return Settings::DARK_OAK_LOG_TEXTURE_PATH;
+	case CubeType::DARK_OAK_LOG_TOP:
+		return Settings::DARK_OAK_LOG_TOP_TEXTURE_PATH;
+	case CubeType::OAK_LEAVES:
+		return Settings::OAK_LEAVES_TEXTURE_PATH;
+	case CubeType::OAK_LOG:
+		return Settings::OAK_LOG_TEXTURE_PATH;
+	case CubeType::OAK_LOG_TOP:
+		return Settings::OAK_LOG_TOP_TEXTURE_PATH;
+	case CubeType::SPRUCE_LEAVES:
+		return Settings::SPRUCE_LEAVES_TEXTURE_PATH;
+	case CubeType::SPRUCE_LOG:
+		return Settings::SPRUCE_LOG_TEXTURE_PATH;
+	case CubeType::SPRUCE_LOG_TOP:
+		return Settings::SPRUCE_LOG_TOP_TEXTURE_PATH;
+	case CubeType::DARK_GRASS_BLOCK:
+		return Settings::DARK_GRASS_BLOCK_TEXTURE_PATH;
+	case CubeType::DARK_GRASS_BLOCK_TOP:
+		return Settings::DARK_GRASS_BLOCK_TOP_TEXTURE_PATH;
+	default:
+		return Settings::MISSING_TEXTURE_PATH;
+	}
+}
+
 TextureArray::TextureArray(VkDevice const &device, ImageCreator const &imageCreator) :textures() {
 	for (size_t i = 0; i < Settings::TEXTURE_COUNT; i++) {
-		textures[i] = Texture(device, Settings::MISSING_TEXTURE_PATH, imageCreator);
+		textures[i] = Texture(device, getTexturePath(i), imageCreator);
 	}
 
 	for (size_t i = 0; i < Settings::OBJ_COUNT; i++) {
@@ -23,93 +88,6 @@ TextureArray::TextureArray(VkDevice const &device, ImageCreator const &imageCrea
 		grassTextues[i] = Texture(device, Settings::MISSING_TEXTURE_PATH, imageCreator);
 	}
 
-	textures[CubeType::WATER].free();
-	textures[CubeType::WATER] = Texture(device, Settings::WATER_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::GLASS].free();
-	textures[CubeType::GLASS] = Texture(device, Settings::GLASS_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::BEDROCK].free();
-	textures[CubeType::BEDROCK] = Texture(device, Settings::BEDROCK_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DIRT].free();
-	textures[CubeType::DIRT] = Texture(device, Settings::DIRT_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::GRASS_BLOCK].free();
-	textures[CubeType::GRASS_BLOCK] = Texture(device, Settings::GRASS_BLOCK_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::GRASS_BLOCK_TOP].free();
-	textures[CubeType::GRASS_BLOCK_TOP] = Texture(device, Settings::GRASS_BLOCK_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::STONE].free();
-	textures[CubeType::STONE] = Texture(device, Settings::STONE_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::SNOW].free();
-	textures[CubeType::SNOW] = Texture(device, Settings::SNOW_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::SAND].free();
-	textures[CubeType::SAND] = Texture(device, Settings::SAND_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::COBBLESTONE].free();
-	textures[CubeType::COBBLESTONE] = Texture(device, Settings::COBBLESTONE_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::ACACIA_LEAVES].free();
-	textures[CubeType::ACACIA_LEAVES] = Texture(device, Settings::ACACIA_LEAVES_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::ACACIA_LOG].free();
-	textures[CubeType::ACACIA_LOG] = Texture(device, Settings::ACACIA_LOG_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::ACACIA_LOG_TOP].free();
-	textures[CubeType::ACACIA_LOG_TOP] = Texture(device, Settings::ACACIA_LOG_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::BIRCH_LEAVES].free();
-	textures[CubeType::BIRCH_LEAVES] = Texture(device, Settings::BIRCH_LEAVES_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::BIRCH_LOG].free();
-	textures[CubeType::BIRCH_LOG] = Texture(device, Settings::BIRCH_LOG_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::BIRCK_LOG_TOP].free();
-	textures[CubeType::BIRCK_LOG_TOP] = Texture(device, Settings::BIRCK_LOG_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::CACTUS].free();
-	textures[CubeType::CACTUS] = Texture(device, Settings::CACTUS_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::CACTUS_TOP].free();
-	textures[CubeType::CACTUS_TOP] = Texture(device, Settings::CACTUS_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DARK_OAK_LEAVES].free();
-	textures[CubeType::DARK_OAK_LEAVES] = Texture(device, Settings::DARK_OAK_LEAVES_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DARK_OAK_LOG].free();
-	textures[CubeType::DARK_OAK_LOG] = Texture(device, Settings::DARK_OAK_LOG_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DARK_OAK_LOG_TOP].free();
-	textures[CubeType::DARK_OAK_LOG_TOP] = Texture(device, Settings::DARK_OAK_LOG_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::OAK_LEAVES].free();
-	textures[CubeType::OAK_LEAVES] = Texture(device, Settings::OAK_LEAVES_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::OAK_LOG].free();
-	textures[CubeType::OAK_LOG] = Texture(device, Settings::OAK_LOG_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::OAK_LOG_TOP].free();
-	textures[CubeType::OAK_LOG_TOP] = Texture(device, Settings::OAK_LOG_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::SPRUCE_LEAVES].free();
-	textures[CubeType::SPRUCE_LEAVES] = Texture(device, Settings::SPRUCE_LEAVES_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::SPRUCE_LOG].free();
-	textures[CubeType::SPRUCE_LOG] = Texture(device, Settings::SPRUCE_LOG_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::SPRUCE_LOG_TOP].free();
-	textures[CubeType::SPRUCE_LOG_TOP] = Texture(device, Settings::SPRUCE_LOG_TOP_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DARK_GRASS_BLOCK].free();
-	textures[CubeType::DARK_GRASS_BLOCK] = Texture(device, Settings::DARK_GRASS_BLOCK_TEXTURE_PATH, imageCreator);
-
-	textures[CubeType::DARK_GRASS_BLOCK_TOP].free();
-	textures[CubeType::DARK_GRASS_BLOCK_TOP] = Texture(device, Settings::DARK_GRASS_BLOCK_TOP_TEXTURE_PATH, imageCreator);
-
 	objTextures[ObjType::SUNFLOWER].free();
 	objTextures[ObjType::SUNFLOWER] = Texture(device, Settings::SUNFLOWER_TEXTURE_PATH, imageCreator);
 
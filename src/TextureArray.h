@@ -12,6 +12,9 @@ public:
 
 	~TextureArray();
 
+	//Texture of the cube type, also read by the CpuPathTracer which loads them without a device
+	static char const *getTexturePath(size_t const cubeType);
+
 	Texture textures[Settings::TEXTURE_COUNT];
 
 	Texture objTextures[Settings::OBJ_COUNT];
@@ -2,6 +2,9 @@
 
 #include <thread>
 #include <iostream>
+#include <atomic>
+#include <memory>
+#include <algorithm>
 
 ThreadPool &ThreadPool::getInstance() {
 	static ThreadPool instance;
@@ -18,6 +21,44 @@ void ThreadPool::submit(std::function<void()> task) {
 	eventHappened.notify_one();
 }
 
+void ThreadPool::parallelFor(int const count, std::function<void(int)> const &task) {
+	struct ParallelForState {
+		std::function<void(int)> task;
+		int count;
+		std::atomic<int> next = 0;
+		std::atomic<int> done = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	//Shared, because helpers that only start after everything is done still read the counters
+	std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+	state->task = task;
+	state->count = count;
+
+	std::function<void()> work = [state] {
+		for (int i = state->next++; i < state->count; i = state->next++) {
+			state->task(i);
+
+			if (++state->done == state->count) {
+				std::unique_lock<std::mutex> lock(state->mutex);
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	int helperCount = std::min(threadCount, count - 1);
+	for (int i = 0; i < helperCount; i++) {
+		submit(work);
+	}
+
+	//Working on the calling thread as well, so this also finishes if the pool is busy or has no threads
+	work();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&state] {return state->done == state->count; });
+}
+
 void ThreadPool::start() {
 	std::cout << "Thread count: " << threadCount << std::endl;
 
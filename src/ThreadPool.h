@@ -16,6 +16,9 @@ public:
 
 	void submit(std::function<void()> task);
 
+	//Runs task(0) to task(count - 1) on the pool and the calling thread, returns when all are done
+	void parallelFor(int const count, std::function<void(int)> const &task);
+
 	void start();
 	void stop();
 
@@ -1,78 +1,78 @@
 #include "TreeBuilder.h"
-#include "LSystem.h"
 
-#include "glm/gtx/rotate_vector.hpp"
+//Rotations by +-90 degrees around one axis, matching glm::rotateX/Y/Z, map the axis aligned directions onto each other without any rounding
+static glm::ivec3 rotateZ(glm::ivec3 const &direction, bool const positive) {
+	return positive ? glm::ivec3(-direction.y, direction.x, direction.z) : glm::ivec3(direction.y, -direction.x, direction.z);
+}
 
-#define _USE_MATH_DEFINES
-#include <math.h>
-#include <stack>
+static glm::ivec3 rotateX(glm::ivec3 const &direction, bool const positive) {
+	return positive ? glm::ivec3(direction.x, -direction.z, direction.y) : glm::ivec3(direction.x, direction.z, -direction.y);
+}
 
-#include <iostream>
+static glm::ivec3 rotateY(glm::ivec3 const &direction, bool const positive) {
+	return positive ? glm::ivec3(direction.z, direction.y, -direction.x) : glm::ivec3(-direction.z, direction.y, direction.x);
+}
 
-void TreeBuilder::generateTreeCubes(TreeDescription const &treeDescription, RandomSampler &randomSampler, std::vector<std::pair<glm::vec3, Cube>> &treeCubes) {
-	std::string blueprint;
-	LSystem::growNTimes(randomSampler, treeDescription.axiom, treeDescription.rules, treeDescription.lowerCutProbability, blueprint, treeDescription.n);
+void TreeBuilder::generateTreeCubes(TreeTemplate const &treeTemplate, CubeType const trunkType, CubeType const leafType, RandomSampler &randomSampler, std::vector<std::pair<glm::ivec3, Cube>> &treeCubes) {
+	thread_local std::vector<uint8_t> blueprint;
+	thread_local std::vector<std::pair<glm::ivec3, glm::ivec3>> stack;
 
-	glm::vec3 position = glm::vec3(0.0f, -1.0f, 0.0f);
-	glm::vec3 direction = glm::vec3(0.0f, 1.0f, 0.0f);
+	treeTemplate.grow(randomSampler, blueprint);
+	stack.clear();
 
-	std::stack<glm::vec3> positionStack;
-	std::stack<glm::vec3> directionStack;
+	glm::ivec3 position = glm::ivec3(0, -1, 0);
+	glm::ivec3 direction = glm::ivec3(0, 1, 0);
 
 	for (size_t i = 0; i < blueprint.size(); i++) {
 		switch (blueprint[i]) {
 		case 'T':
 			position += direction;
-			treeCubes.push_back(std::pair<glm::vec3, Cube>(position, Cube(treeDescription.trunkType)));
+			treeCubes.push_back(std::pair<glm::ivec3, Cube>(position, Cube(trunkType)));
 			break;
 		case 't':
-			if (randomSampler.getSample1DNonReset() < treeDescription.trunkProbability) {
+			if (randomSampler.getSample1DNonReset() < treeTemplate.trunkProbability) {
 				position += direction;
-				treeCubes.push_back(std::pair<glm::vec3, Cube>(position, Cube(treeDescription.trunkType)));
+				treeCubes.push_back(std::pair<glm::ivec3, Cube>(position, Cube(trunkType)));
 			}
 			break;
 		case 'L':
 			position += direction;
-			treeCubes.push_back(std::pair<glm::vec3, Cube>(position, Cube(treeDescription.leafType)));
+			treeCubes.push_back(std::pair<glm::ivec3, Cube>(position, Cube(leafType)));
 			break;
 		case 'l':
-			if (randomSampler.getSample1DNonReset() < treeDescription.leafProbability) {
+			if (randomSampler.getSample1DNonReset() < treeTemplate.leafProbability) {
 				position += direction;
-				treeCubes.push_back(std::pair<glm::vec3, Cube>(position, Cube(treeDescription.leafType)));
+				treeCubes.push_back(std::pair<glm::ivec3, Cube>(position, Cube(leafType)));
 			}
 			break;
 		case '[':
-			positionStack.push(position);
-			directionStack.push(direction);
+			stack.push_back(std::pair<glm::ivec3, glm::ivec3>(position, direction));
 			break;
 		case ']':
-			position = positionStack.top();
-			positionStack.pop();
-			direction = directionStack.top();
-			directionStack.pop();
+			position = stack.back().first;
+			direction = stack.back().second;
+			stack.pop_back();
 			break;
 		case '+':
-			direction = glm::rotateZ(direction, (float)M_PI / 2.0f);
+			direction = rotateZ(direction, true);
 			break;
 		case '-':
-			direction = glm::rotateZ(direction, -(float)M_PI / 2.0f);
+			direction = rotateZ(direction, false);
 			break;
 		case '*':
-			direction = glm::rotateX(direction, (float)M_PI / 2.0f);
+			direction = rotateX(direction, true);
 			break;
 		case '/':
-			direction = glm::rotateX(direction, -(float)M_PI / 2.0f);
+			direction = rotateX(direction, false);
 			break;
 		case '>':
-			direction = glm::rotateY(direction, (float)M_PI / 2.0f);
+			direction = rotateY(direction, true);
 			break;
 		case '<':
-			direction = glm::rotateY(direction, -(float)M_PI / 2.0f);
+			direction = rotateY(direction, false);
 			break;
 		default:
 			break;
 		}
-		
-		//std::cout << direction.x << " " << direction.y << " " << direction.z << std::endl;
 	}
 }
@@ -3,7 +3,7 @@
 
 #include "Cube.h"
 #include "Coordinates.h"
-#include "TreeDescription.h"
+#include "TreeTemplate.h"
 #include "RandomSampler.h"
 
 #include <glm/glm.hpp>
@@ -16,7 +16,8 @@ public:
 	TreeBuilder();
 	~TreeBuilder();
 
-	static void generateTreeCubes(TreeDescription const &treeDescription, RandomSampler &randomSampler, std::vector<std::pair<glm::vec3, Cube>> &treeCubes);
+	//Offsets are relative to the ground block the tree grows out of
+	static void generateTreeCubes(TreeTemplate const &treeTemplate, CubeType const trunkType, CubeType const leafType, RandomSampler &randomSampler, std::vector<std::pair<glm::ivec3, Cube>> &treeCubes);
 
 private:
 
@@ -0,0 +1,90 @@
+#include "TreeTemplate.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+TreeTemplate::TreeTemplate() {}
+
+TreeTemplate::TreeTemplate(TreeDescription const &treeDescription) : trunkType(treeDescription.trunkType), leafType(treeDescription.leafType), trunkProbability(treeDescription.trunkProbability), leafProbability(treeDescription.leafProbability), n(treeDescription.n), lowerCutProbability(treeDescription.lowerCutProbability) {
+	axiom.assign(treeDescription.axiom.begin(), treeDescription.axiom.end());
+
+	ruleStart.fill(0);
+	ruleEnd.fill(0);
+	hasRule.fill(false);
+
+	//The first matching rule wins, same as the linear scan in LSystem::grow
+	for (size_t i = 0; i < treeDescription.rules.size(); i++) {
+		uint8_t symbol = (uint8_t)treeDescription.rules[i].in;
+
+		if (hasRule[symbol]) {
+			continue;
+		}
+
+		hasRule[symbol] = true;
+		ruleStart[symbol] = (uint32_t)ruleSymbols.size();
+		ruleSymbols.insert(ruleSymbols.end(), treeDescription.rules[i].out.begin(), treeDescription.rules[i].out.end());
+		ruleEnd[symbol] = (uint32_t)ruleSymbols.size();
+	}
+
+	for (size_t i = 0; i < 256; i++) {
+		isCuttable[i] = islower((int)i) && i != 't' && i != 'l';
+	}
+
+	//Length every symbol expands to after k growth steps if nothing gets cut
+	std::array<size_t, 256> expandedLength;
+	expandedLength.fill(1);
+
+	for (size_t k = 0; k < n; k++) {
+		std::array<size_t, 256> nextLength = expandedLength;
+
+		for (size_t symbol = 0; symbol < 256; symbol++) {
+			if (hasRule[symbol]) {
+				size_t length = 0;
+
+				for (uint32_t j = ruleStart[symbol]; j < ruleEnd[symbol]; j++) {
+					length = std::min(length + expandedLength[ruleSymbols[j]], (size_t)1 << 24);
+				}
+
+				nextLength[symbol] = length;
+			}
+		}
+
+		expandedLength = nextLength;
+	}
+
+	maxBlueprintSize = 0;
+	for (size_t i = 0; i < axiom.size(); i++) {
+		maxBlueprintSize += expandedLength[axiom[i]];
+	}
+}
+
+TreeTemplate::~TreeTemplate() {}
+
+void TreeTemplate::grow(RandomSampler &randomSampler, std::vector<uint8_t> &blueprint) const {
+	thread_local std::vector<uint8_t> input;
+
+	blueprint.assign(axiom.begin(), axiom.end());
+	blueprint.reserve(maxBlueprintSize);
+	input.reserve(maxBlueprintSize);
+
+	for (size_t k = 0; k < n; k++) {
+		std::swap(input, blueprint);
+		blueprint.clear();
+
+		for (size_t i = 0; i < input.size(); i++) {
+			uint8_t symbol = input[i];
+
+			if (isCuttable[symbol]) {
+				if (randomSampler.getSample1DNonReset() < lowerCutProbability) {
+					continue;
+				}
+			}
+
+			if (hasRule[symbol]) {
+				blueprint.insert(blueprint.end(), ruleSymbols.begin() + ruleStart[symbol], ruleSymbols.begin() + ruleEnd[symbol]);
+			} else {
+				blueprint.push_back(symbol);
+			}
+		}
+	}
+}
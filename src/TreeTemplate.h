@@ -0,0 +1,42 @@
+#ifndef TREETEMPLATE_H
+#define TREETEMPLATE_H
+
+#include "TreeDescription.h"
+#include "RandomSampler.h"
+#include "CubeType.h"
+
+#include <array>
+#include <vector>
+
+//L-system of a tree description compiled once into lookup tables, so growing a tree does no string building or rule scanning
+class TreeTemplate {
+public:
+	TreeTemplate();
+	TreeTemplate(TreeDescription const &treeDescription);
+	~TreeTemplate();
+
+	//Draws exactly the same random samples in the same order as LSystem::growNTimes
+	void grow(RandomSampler &randomSampler, std::vector<uint8_t> &blueprint) const;
+
+	CubeType trunkType = CubeType::AIR;
+	CubeType leafType = CubeType::AIR;
+	float trunkProbability = 0.0f;
+	float leafProbability = 0.0f;
+
+private:
+	std::vector<uint8_t> axiom;
+	std::vector<uint8_t> ruleSymbols;
+
+	std::array<uint32_t, 256> ruleStart{};
+	std::array<uint32_t, 256> ruleEnd{};
+	std::array<bool, 256> hasRule{};
+	std::array<bool, 256> isCuttable{};
+
+	size_t n = 0;
+	float lowerCutProbability = 0.0f;
+
+	//Upper bound for the blueprint size, used to reserve the growth buffers once
+	size_t maxBlueprintSize = 0;
+};
+
+#endif // !TREETEMPLATE_H
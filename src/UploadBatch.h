@@ -0,0 +1,27 @@
+#ifndef UPLOADBATCH_H
+#define UPLOADBATCH_H
+
+#include "MemoryAllocation.h"
+
+#include "vulkan/vulkan.h"
+
+#include <functional>
+#include <vector>
+
+//All uploads that went into one transfer submit, completed together once the fence is signaled
+struct UploadBatch {
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkFence fence = VK_NULL_HANDLE;
+
+	//Staging ring state to restore once the batch is done
+	uint64_t ringEnd = 0;
+	uint64_t ringBytes = 0;
+
+	std::vector<std::function<void()>> callbacks;
+
+	//Uploads bigger than the staging ring get their own staging buffer
+	std::vector<VkBuffer> dedicatedStagingBuffers;
+	std::vector<MemoryAllocation> dedicatedStagingBufferAllocations;
+};
+
+#endif // !UPLOADBATCH_H
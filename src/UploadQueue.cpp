@@ -0,0 +1,287 @@
+#include "UploadQueue.h"
+#include "CommandWrapper.h"
+#include "Settings.h"
+
+#include <stdexcept>
+#include <cstring>
+
+UploadQueue::UploadQueue() {}
+
+UploadQueue::UploadQueue(VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, Queues const &queues, BufferCreator const &bufferCreator)
+	: device(device), queues(queues), bufferCreator(&bufferCreator), running(true) {
+	//Only used by the upload thread, so it needs no locking
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndices.transferFamilyIndex;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+	if (vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create upload command pool");
+	}
+
+	ringSize = Settings::STAGING_RING_SIZE;
+	bufferCreator.createStagingBuffer(ringSize, ringBuffer, ringBufferAllocation);
+
+	thread = std::thread([this] {run(); });
+}
+
+UploadQueue::~UploadQueue() {
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		running = false;
+	}
+	work.notify_all();
+	//Producers blocked on a full ring would otherwise never wake up, the upload thread is gone
+	ringSpace.notify_all();
+	thread.join();
+
+	//Uploads still pending at shutdown are dropped without calling back, their owners are already gone
+	for (size_t i = 0; i < pendingUploads.size(); i++) {
+		if (pendingUploads[i].dedicatedStagingBufferAllocation.memory != VK_NULL_HANDLE) {
+			bufferCreator->destroyBuffer(pendingUploads[i].sourceBuffer, pendingUploads[i].dedicatedStagingBufferAllocation);
+		}
+	}
+
+	for (size_t i = 0; i < batchesInFlight.size(); i++) {
+		vkWaitForFences(device, 1, &batchesInFlight[i].fence, VK_TRUE, UINT64_MAX);
+
+		for (size_t j = 0; j < batchesInFlight[i].dedicatedStagingBuffers.size(); j++) {
+			bufferCreator->destroyBuffer(batchesInFlight[i].dedicatedStagingBuffers[j], batchesInFlight[i].dedicatedStagingBufferAllocations[j]);
+		}
+
+		freeBatches.push_back(batchesInFlight[i]);
+	}
+
+	for (size_t i = 0; i < freeBatches.size(); i++) {
+		vkDestroyFence(device, freeBatches[i].fence, nullptr);
+	}
+
+	vkDestroyCommandPool(device, commandPool, nullptr);
+
+	bufferCreator->destroyBuffer(ringBuffer, ringBufferAllocation);
+}
+
+void UploadQueue::upload(void const *data, VkDeviceSize const dataSize, VkBuffer const &destinationBuffer, VkDeviceSize const destinationOffset, std::function<void()> onComplete) {
+	if (dataSize == 0) {
+		if (onComplete) {
+			onComplete();
+		}
+		return;
+	}
+
+	PendingUpload pendingUpload;
+	pendingUpload.destinationBuffer = destinationBuffer;
+	pendingUpload.bufferCopy.dstOffset = destinationOffset;
+	pendingUpload.bufferCopy.size = dataSize;
+	pendingUpload.onComplete = onComplete;
+
+	//Keeping every staging range 16 byte aligned
+	uint64_t size = (dataSize + 15) / 16 * 16;
+
+	if (size > ringSize) {
+		bufferCreator->createStagingBuffer(dataSize, pendingUpload.sourceBuffer, pendingUpload.dedicatedStagingBufferAllocation);
+		memcpy(pendingUpload.dedicatedStagingBufferAllocation.mapped, data, (size_t)dataSize);
+		pendingUpload.bufferCopy.srcOffset = 0;
+
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		pendingUploads.push_back(pendingUpload);
+	} else {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		//Reserving, copying and queueing under one lock keeps the ring ranges in the same order as the batches
+		uint64_t offset = 0;
+		uint64_t consumed = 0;
+		ringSpace.wait(lock, [this, size, &offset, &consumed] {return !running || reserveRing(size, offset, consumed); });
+
+		//Shutting down, the upload is dropped like the ones still pending in the destructor
+		if (!running) {
+			return;
+		}
+
+		memcpy(static_cast<char *>(ringBufferAllocation.mapped) + offset, data, (size_t)dataSize);
+
+		pendingUpload.sourceBuffer = ringBuffer;
+		pendingUpload.bufferCopy.srcOffset = offset;
+		pendingUpload.ringBytes = consumed;
+
+		pendingUploads.push_back(pendingUpload);
+	}
+
+	work.notify_one();
+}
+
+bool UploadQueue::reserveRing(uint64_t const size, uint64_t &offset, uint64_t &consumed) {
+	if (ringUsed == 0) {
+		ringHead = 0;
+		ringTail = 0;
+	} else if (ringUsed == ringSize) {
+		return false;
+	}
+
+	if (ringHead >= ringTail) {
+		//Free space is behind the head up to the end and in front of the tail
+		if (ringSize - ringHead >= size) {
+			offset = ringHead;
+			consumed = size;
+		} else if (ringTail >= size) {
+			//Wrapping around, the skipped end is given back together with this range
+			offset = 0;
+			consumed = ringSize - ringHead + size;
+		} else {
+			return false;
+		}
+	} else {
+		if (ringTail - ringHead >= size) {
+			offset = ringHead;
+			consumed = size;
+		} else {
+			return false;
+		}
+	}
+
+	ringHead = offset + size;
+	ringUsed += consumed;
+
+	return true;
+}
+
+void UploadQueue::run() {
+	std::vector<PendingUpload> uploads;
+
+	while (true) {
+		uint64_t ringEnd = 0;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			//Sleeping only if there is nothing to submit and nothing to wait for
+			if (batchesInFlight.empty()) {
+				work.wait(lock, [this] {return !pendingUploads.empty() || !running; });
+			}
+
+			if (!running) {
+				break;
+			}
+
+			std::swap(uploads, pendingUploads);
+			ringEnd = ringHead;
+		}
+
+		if (!uploads.empty()) {
+			submitPending(uploads, ringEnd);
+			uploads.clear();
+		}
+
+		//Uploads arriving while waiting on the oldest batch are all submitted together in the next one
+		if (!batchesInFlight.empty()) {
+			vkWaitForFences(device, 1, &batchesInFlight.front().fence, VK_TRUE, Settings::UPLOAD_BATCH_WAIT_NANOSECONDS);
+		}
+
+		while (!batchesInFlight.empty() && vkGetFenceStatus(device, batchesInFlight.front().fence) == VK_SUCCESS) {
+			completeBatch(batchesInFlight.front());
+			batchesInFlight.pop_front();
+		}
+	}
+}
+
+void UploadQueue::submitPending(std::vector<PendingUpload> &uploads, uint64_t const ringEnd) {
+	UploadBatch batch = getFreeBatch();
+	batch.ringEnd = ringEnd;
+
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(batch.commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin recording upload command buffer");
+	}
+
+	for (size_t i = 0; i < uploads.size(); i++) {
+		vkCmdCopyBuffer(batch.commandBuffer, uploads[i].sourceBuffer, uploads[i].destinationBuffer, 1, &uploads[i].bufferCopy);
+
+		batch.ringBytes += uploads[i].ringBytes;
+
+		if (uploads[i].onComplete) {
+			batch.callbacks.push_back(uploads[i].onComplete);
+		}
+
+		if (uploads[i].dedicatedStagingBufferAllocation.memory != VK_NULL_HANDLE) {
+			batch.dedicatedStagingBuffers.push_back(uploads[i].sourceBuffer);
+			batch.dedicatedStagingBufferAllocations.push_back(uploads[i].dedicatedStagingBufferAllocation);
+		}
+	}
+
+	if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to record upload command buffer");
+	}
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &batch.commandBuffer;
+
+	vkResetFences(device, 1, &batch.fence);
+
+	{
+		std::lock_guard<std::mutex> lockGuard(CommandWrapper::mutexQueueSubmit);
+		if (vkQueueSubmit(queues.transferQueue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to submit upload command buffer");
+		}
+	}
+
+	batchesInFlight.push_back(batch);
+}
+
+void UploadQueue::completeBatch(UploadBatch &batch) {
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		ringUsed -= batch.ringBytes;
+		ringTail = batch.ringEnd;
+	}
+	ringSpace.notify_all();
+
+	for (size_t i = 0; i < batch.dedicatedStagingBuffers.size(); i++) {
+		bufferCreator->destroyBuffer(batch.dedicatedStagingBuffers[i], batch.dedicatedStagingBufferAllocations[i]);
+	}
+
+	for (size_t i = 0; i < batch.callbacks.size(); i++) {
+		batch.callbacks[i]();
+	}
+
+	batch.ringEnd = 0;
+	batch.ringBytes = 0;
+	batch.callbacks.clear();
+	batch.dedicatedStagingBuffers.clear();
+	batch.dedicatedStagingBufferAllocations.clear();
+
+	freeBatches.push_back(batch);
+}
+
+UploadBatch UploadQueue::getFreeBatch() {
+	if (!freeBatches.empty()) {
+		UploadBatch batch = freeBatches.back();
+		freeBatches.pop_back();
+		return batch;
+	}
+
+	UploadBatch batch;
+
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.commandPool = commandPool;
+	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &batch.commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate upload command buffer");
+	}
+
+	VkFenceCreateInfo fenceCreateInfo{};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if (vkCreateFence(device, &fenceCreateInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create upload fence");
+	}
+
+	return batch;
+}
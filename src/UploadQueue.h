@@ -0,0 +1,68 @@
+#ifndef UPLOADQUEUE_H
+#define UPLOADQUEUE_H
+
+#include "BufferCreator.h"
+#include "QueueFamilyIndices.h"
+#include "Queues.h"
+#include "UploadBatch.h"
+#include "PendingUpload.h"
+
+#include "vulkan/vulkan.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Copies uploads into a persistent staging ring and submits everything that piled up as one batch on the transfer queue, workers get a callback instead of waiting
+class UploadQueue {
+public:
+	UploadQueue();
+	UploadQueue(VkDevice const &device, QueueFamilyIndices const &queueFamilyIndices, Queues const &queues, BufferCreator const &bufferCreator);
+	~UploadQueue();
+
+	//Returns as soon as the data is in staging memory, onComplete is called from the upload thread after the copy finished on the GPU
+	void upload(void const *data, VkDeviceSize const dataSize, VkBuffer const &destinationBuffer, VkDeviceSize const destinationOffset, std::function<void()> onComplete);
+
+private:
+	VkDevice device;
+	Queues queues;
+	BufferCreator const *bufferCreator;
+
+	VkCommandPool commandPool;
+
+	VkBuffer ringBuffer;
+	MemoryAllocation ringBufferAllocation;
+
+	uint64_t ringSize = 0;
+	uint64_t ringHead = 0;
+	uint64_t ringTail = 0;
+	uint64_t ringUsed = 0;
+
+	std::mutex mutex;
+	std::condition_variable work;
+	std::condition_variable ringSpace;
+
+	std::vector<PendingUpload> pendingUploads;
+
+	std::deque<UploadBatch> batchesInFlight;
+	std::vector<UploadBatch> freeBatches;
+
+	std::atomic<bool> running;
+	std::thread thread;
+
+	bool reserveRing(uint64_t const size, uint64_t &offset, uint64_t &consumed);
+
+	void run();
+
+	void submitPending(std::vector<PendingUpload> &uploads, uint64_t const ringEnd);
+
+	void completeBatch(UploadBatch &batch);
+
+	UploadBatch getFreeBatch();
+};
+
+#endif // !UPLOADQUEUE_H
@@ -0,0 +1,11 @@
+#ifndef VERTEXTYPE_H
+#define VERTEXTYPE_H
+
+//Selects the vertex input descriptions of a graphics pipeline
+enum class VertexType {
+	VERTEX,
+	BIG_VERTEX,
+	CHUNK_VERTEX
+};
+
+#endif // !VERTEXTYPE_H
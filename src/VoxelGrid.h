@@ -0,0 +1,30 @@
+#ifndef VOXELGRID_H
+#define VOXELGRID_H
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+//Brick map of the loaded area for the voxel traversal of shaders/compute.comp, origin and size are uploaded in front of the bricks
+struct VoxelGrid {
+	//Cube position of voxel 0, 0, 0
+	glm::ivec4 origin = glm::ivec4(0);
+
+	//Voxels per axis, multiples of ComputeSettings::VOXEL_BRICK_SIZE, x 0 leaves the path tracer on the box BVH
+	glm::ivec4 size = glm::ivec4(0);
+
+	//One entry per brick of VOXEL_BRICK_SIZE^3 voxels, brick (x, y, z) has the index (x * bricks.z + z) * bricks.y + y
+	//0 is an empty brick, BrickMap::UNIFORM_BRICK | type one only holding that cube type, every other value is 1 + the index into brickVoxels
+	std::vector<uint32_t> bricks;
+
+	//BrickMap::BRICK_UINTS per stored brick, four cube types per uint, voxel (x, y, z) inside the brick has the index (x * 8 + z) * 8 + y
+	//Sized to the capacity of the brick pool, the free bricks are never referenced
+	std::vector<uint32_t> brickVoxels;
+
+	//Stored bricks written since the last grid as first brick and brick count, only these are uploaded again while the pool keeps its capacity
+	std::vector<std::pair<size_t, size_t>> dirtyBrickRanges;
+};
+
+#endif // !VOXELGRID_H
@@ -27,6 +27,10 @@ VulkanWrapper::~VulkanWrapper() {
 	skyWrapper->~SkyWrapper();
 	renderSynchronisation->~RenderSynchronisation();
 	commandWrapper->~CommandWrapper();
+	uploadQueue->~UploadQueue();
+	chunkArena->~ChunkArena();
+	bufferCreator.destroyBuffer(quadIndexBuffer, quadIndexBufferAllocation);
+	memoryAllocator->~MemoryAllocator();
 
 	vkDestroyDevice(device, nullptr);
 
@@ -80,26 +84,47 @@ void VulkanWrapper::initialize(GLFWwindow *window) {
 	commandWrapper->createComputeCommandBuffer();
 }
 
-void VulkanWrapper::createVulkanLoadedChunk(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory) {
-	bufferCreator.createVertexBuffer(vertices, vertexBuffer, vertexBufferMemory);
-	bufferCreator.createIndexBuffer(indices, indexBuffer, indexBufferMemory);
+void VulkanWrapper::createVulkanLoadedChunk(std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation) {
+	bufferCreator.createVertexBuffer(vertices, vertexBuffer, vertexBufferAllocation);
+
+	//Empty if the chunk uses the shared quad index buffer
+	if (!indices.empty()) {
+		bufferCreator.createIndexBuffer(indices, indexBuffer, indexBufferAllocation);
+	}
 }
 
-void VulkanWrapper::createVulkanObjChunk(std::vector<BigVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory) {
-	bufferCreator.createBigVertexBuffer(vertices, vertexBuffer, vertexBufferMemory);
-	bufferCreator.createIndexBuffer(indices, indexBuffer, indexBufferMemory);
+void VulkanWrapper::createVulkanObjChunk(std::vector<BigVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation, std::function<void()> onComplete) {
+	VkDeviceSize vertexBufferSize = sizeof(vertices[0]) * vertices.size();
+	VkDeviceSize indexBufferSize = sizeof(indices[0]) * indices.size();
+
+	bufferCreator.createDestinationBuffer(vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferAllocation);
+	bufferCreator.createDestinationBuffer(indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferAllocation);
+
+	//Batches complete in order, so the callback of the second upload covers both
+	uploadQueue->upload(vertices.data(), vertexBufferSize, vertexBuffer, 0, nullptr);
+	uploadQueue->upload(indices.data(), indexBufferSize, indexBuffer, 0, onComplete);
 }
 
-void VulkanWrapper::deleteVulkanLoadedChunk(VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory) {
+void VulkanWrapper::deleteVulkanLoadedChunk(VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation) {
 	{
 		std::lock_guard<std::mutex> lockGuard(CommandWrapper::mutexCommandPool);
-		vkDestroyBuffer(device, vertexBuffer, nullptr);
-		vkFreeMemory(device, vertexBufferMemory, nullptr);
-		vkDestroyBuffer(device, indexBuffer, nullptr);
-		vkFreeMemory(device, indexBufferMemory, nullptr);
+		bufferCreator.destroyBuffer(vertexBuffer, vertexBufferAllocation);
+		bufferCreator.destroyBuffer(indexBuffer, indexBufferAllocation);
 	}
 }
 
+void VulkanWrapper::createArenaLoadedChunk(std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices, uint32_t const chunkOrigin, glm::vec3 const &minBound, glm::vec3 const &maxBound, ArenaAllocation &arenaAllocation, std::function<void()> onComplete) {
+	chunkArena->upload(vertices, indices, chunkOrigin, minBound, maxBound, arenaAllocation, onComplete);
+}
+
+void VulkanWrapper::deleteArenaLoadedChunk(ArenaAllocation &arenaAllocation) {
+	chunkArena->free(arenaAllocation);
+}
+
+void VulkanWrapper::printMemoryStats() {
+	memoryAllocator->printStats();
+}
+
 bool VulkanWrapper::startRenderRecording(glm::mat4 const &view, glm::mat4 const &projection, uint32_t &imageIndex) {
 	//Waiting till the InFlightSpot is ready
 	vkWaitForFences(device, 1, &renderSynchronisation->inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
@@ -126,31 +151,78 @@ bool VulkanWrapper::startRenderRecording(glm::mat4 const &view, glm::mat4 const
 	updateUniformBufferObject(imageIndex, glm::mat4(1), view, projection);
 	updateSkyUniformBufferObject(imageIndex);
 
-	//Starts recording
-	commandWrapper->startRecordingCommandBuffer(imageIndex, renderPass, swapchainWrapper->swapchainFramebuffers[imageIndex], swapchainWrapper->extent, pipeline, pipelineLayout, descriptorWrapper->descriptorSets[imageIndex]);
+	//Starts recording, the culling pass has to come before the render pass
+	commandWrapper->startRecordingCommandBuffer(imageIndex);
+
+	if (chunkArena->isCullingOnGpu()) {
+		recordSectionCulling(imageIndex, view, projection);
+	}
+
+	commandWrapper->startRenderPass(imageIndex, renderPass, swapchainWrapper->swapchainFramebuffers[imageIndex], swapchainWrapper->extent);
 
 	//Signal that everything went ok and we can now record draw calls
 	return true;
 }
 
-void VulkanWrapper::addChunkToRender(uint32_t const imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount) {
-	commandWrapper->recordChunk(imageIndex, vertexBuffer, indexBuffer, indexCount);
+VkCommandBuffer VulkanWrapper::startSecondaryRecording(uint32_t const imageIndex, size_t const slot) {
+	VkCommandBuffer commandBuffer = commandWrapper->startRecordingSecondaryCommandBuffer(imageIndex, slot, renderPass, swapchainWrapper->swapchainFramebuffers[imageIndex]);
+
+	//Nothing is inherited from the primary command buffer, so every slot starts with the chunk pipeline
+	commandWrapper->changeShader(commandBuffer, pipeline, pipelineLayout, descriptorWrapper->descriptorSets[imageIndex]);
+
+	return commandBuffer;
+}
+
+void VulkanWrapper::endSecondaryRecording(VkCommandBuffer const &commandBuffer) {
+	commandWrapper->endRecordingSecondaryCommandBuffer(commandBuffer);
+}
+
+size_t VulkanWrapper::getRecordingSlotCount() const {
+	return commandWrapper->getSecondaryCommandBufferSlotCount();
+}
+
+void VulkanWrapper::addChunkToRender(VkCommandBuffer const &commandBuffer, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount, uint32_t const chunkOrigin) {
+	if (Settings::SHARED_QUAD_INDICES) {
+		commandWrapper->recordQuadChunk(commandBuffer, vertexBuffer, quadIndexBuffer, indexCount / 6, chunkOrigin);
+	} else {
+		commandWrapper->recordChunk(commandBuffer, vertexBuffer, indexBuffer, indexCount, chunkOrigin);
+	}
+}
+
+void VulkanWrapper::addChunkToIndirectDraw(ArenaAllocation const &arenaAllocation, uint32_t const chunkOrigin) {
+	chunkArena->addDraw(arenaAllocation, chunkOrigin);
 }
 
-void VulkanWrapper::changeToObjPipeline(uint32_t const imageIndex) {
-	commandWrapper->changeShader(imageIndex, objPipeline, objPipelineLayout, descriptorWrapper->objDescriptorSets[imageIndex]);
+bool VulkanWrapper::isSectionCullingOnGpu() const {
+	return chunkArena->isCullingOnGpu();
 }
 
-void VulkanWrapper::addObjChunkToRender(uint32_t const imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount) {
-	commandWrapper->recordChunk(imageIndex, vertexBuffer, indexBuffer, indexCount);
+bool VulkanWrapper::isOcclusionCullingOn() const {
+	return chunkArena->isCullingOnGpu() ? occlusionCulling : Settings::OCCLUSION_CULLING;
 }
 
-void VulkanWrapper::changeToSkyPipeline(uint32_t const imageIndex) {
-	commandWrapper->changeShader(imageIndex, skyPipeline, skyPipelineLayout, descriptorWrapper->skyDescriptorSets[imageIndex]);
+void VulkanWrapper::markSectionVisible(uint32_t const imageIndex, ArenaAllocation const &arenaAllocation) {
+	chunkArena->markVisible(imageIndex, arenaAllocation);
 }
 
-void VulkanWrapper::addSkyToRender(uint32_t const imageIndex) {
-	commandWrapper->recordChunk(imageIndex, skyWrapper->boxVertices, skyWrapper->boxIndices, 36);
+void VulkanWrapper::drawIndirectChunks(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex) {
+	chunkArena->recordDraws(imageIndex, commandBuffer, *commandWrapper);
+}
+
+void VulkanWrapper::changeToObjPipeline(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex) {
+	commandWrapper->changeShader(commandBuffer, objPipeline, objPipelineLayout, descriptorWrapper->objDescriptorSets[imageIndex]);
+}
+
+void VulkanWrapper::addObjChunkToRender(VkCommandBuffer const &commandBuffer, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount) {
+	commandWrapper->recordChunk(commandBuffer, vertexBuffer, indexBuffer, indexCount, 0);
+}
+
+void VulkanWrapper::changeToSkyPipeline(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex) {
+	commandWrapper->changeShader(commandBuffer, skyPipeline, skyPipelineLayout, descriptorWrapper->skyDescriptorSets[imageIndex]);
+}
+
+void VulkanWrapper::addSkyToRender(VkCommandBuffer const &commandBuffer) {
+	commandWrapper->recordChunk(commandBuffer, skyWrapper->boxVertices, skyWrapper->boxIndices, 36, 0);
 }
 
 void VulkanWrapper::SubmitRender(uint32_t const imageIndex) {
@@ -206,7 +278,7 @@ void VulkanWrapper::SubmitRender(uint32_t const imageIndex) {
 	currentFrame = (currentFrame + 1) % Settings::MAX_FRAMES_IN_FLIGHT;
 }
 
-void VulkanWrapper::renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::vec4 const &iData) {
+void VulkanWrapper::renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::vec4 const &iData, bool const progressive) {
 	uint32_t imageIndex = 0;
 
 	//Waiting till the InFlightSpot is ready
@@ -236,12 +308,15 @@ void VulkanWrapper::renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 c
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	VkSemaphore waitSemaphores[] = { renderSynchronisation->imageAvailableSemaphores[currentFrame] };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	submitInfo.waitSemaphoreCount = 1;
+	//Only a submission finishing the pass signals the compute semaphore, so the quad waits for a finished pass but shows the tiles of a running one as they are
+	VkSemaphore waitSemaphores[] = { renderSynchronisation->imageAvailableSemaphores[currentFrame], renderSynchronisation->computeFinishedSemaphore };
+	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT };
+	submitInfo.waitSemaphoreCount = computeWrapper->computeFinishedSemaphorePending ? 2 : 1;
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 
+	computeWrapper->computeFinishedSemaphorePending = false;
+
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &commandWrapper->quadCommandBuffers[imageIndex];
 
@@ -280,25 +355,89 @@ void VulkanWrapper::renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 c
 	//Setting our current frame to ne next one if necessary wrap around to 0 again
 	currentFrame = (currentFrame + 1) % Settings::MAX_FRAMES_IN_FLIGHT;
 
-	//Running compute here
-	vkWaitForFences(device, 1, &renderSynchronisation->computeFence, VK_TRUE, UINT64_MAX);
-	vkResetFences(device, 1, &renderSynchronisation->computeFence);
+	//The image is presented with the tiles traced so far, a submission still running is left alone until the next frame
+	if (computeWrapper->computeSubmitted) {
+		if (progressive && vkGetFenceStatus(device, renderSynchronisation->computeFence) == VK_NOT_READY) {
+			return;
+		}
+
+		finishComputeSubmission();
+	}
+
+	//A moved camera starts over at the first tile instead of finishing the pass of the old view
+	if (computeWrapper->nextTile != 0 && computeWrapper->isPassOutdated(cameraPosition, cameraDirection, iData)) {
+		computeWrapper->nextTile = 0;
+	}
+
+	if (computeWrapper->nextTile == 0) {
+		computeWrapper->updateCameraData(imageIndex, cameraPosition, cameraDirection, up, iData);
+		computeWrapper->passImageIndex = imageIndex;
+	}
+
+	computeWrapper->selectTiles(progressive ? computeWrapper->tilesPerSubmit : computeWrapper->getTileCount(), computeWrapper->submittedTiles);
+
+	//Empty if adaptive sampling converged every tile left in the pass, no rays are traced this frame then
+	if (computeWrapper->submittedTiles.empty()) {
+		ComputeSettings::writeBackData = { glm::uvec4(0) };
+		return;
+	}
+
+	//selectTiles wrapped around, so this submission traces the last tiles of the pass
+	bool passFinished = computeWrapper->nextTile == 0;
 
-	computeWrapper->updateCameraData(imageIndex, cameraPosition, cameraDirection, up, iData);
+	//The filter runs over the whole image, so it only follows the submission completing a pass instead of every batch of tiles
+	VkPipeline denoisePipeline = ComputeSettings::denoise && passFinished ? computeWrapper->denoisePipeline : VK_NULL_HANDLE;
 
-	commandWrapper->recordComputeCommandBuffer(computeWrapper->computePipeline, computeWrapper->computePipelineLayout, descriptorWrapper->computeDescriptorSets[imageIndex]);
+	//Only the NEE path tracer is split into wavefront stages, the other integrators keep running as megakernel
+	if (((int)iData.w & ComputeSettings::WAVEFRONT_FLAG) != 0 && (int)iData.x == ComputeSettings::WAVEFRONT_INTEGRATOR) {
+		commandWrapper->recordWavefrontCommandBuffer(computeWrapper->wavefrontPipelines, computeWrapper->computePipelineLayout, descriptorWrapper->computeDescriptorSets[computeWrapper->passImageIndex], computeWrapper->submittedTiles, computeWrapper->wavefrontQueueBuffer, computeWrapper->timestampQueryPool, denoisePipeline);
+	} else {
+		commandWrapper->recordComputeCommandBuffer(computeWrapper->computePipeline, computeWrapper->computePipelineLayout, descriptorWrapper->computeDescriptorSets[computeWrapper->passImageIndex], computeWrapper->submittedTiles, computeWrapper->timestampQueryPool, denoisePipeline);
+	}
+
+	//An empty submission signals once every quad pass submitted so far is done, none of them may still sample the image while it is written
+	VkSubmitInfo quadFinishedSubmitInfo{};
+	quadFinishedSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	quadFinishedSubmitInfo.signalSemaphoreCount = 1;
+	quadFinishedSubmitInfo.pSignalSemaphores = &renderSynchronisation->quadFinishedSemaphore;
+
+	if (vkQueueSubmit(queues.graphicsQueue, 1, &quadFinishedSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to submit quad finished semaphore");
+	}
+
+	VkPipelineStageFlags computeWaitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 
 	VkSubmitInfo computeSubmitInfo{};
 	computeSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	computeSubmitInfo.waitSemaphoreCount = 1;
+	computeSubmitInfo.pWaitSemaphores = &renderSynchronisation->quadFinishedSemaphore;
+	computeSubmitInfo.pWaitDstStageMask = &computeWaitStage;
 	computeSubmitInfo.commandBufferCount = 1;
 	computeSubmitInfo.pCommandBuffers = &commandWrapper->computeCommandBuffer;
+	computeSubmitInfo.signalSemaphoreCount = passFinished ? 1 : 0;
+	computeSubmitInfo.pSignalSemaphores = &renderSynchronisation->computeFinishedSemaphore;
+
+	vkResetFences(device, 1, &renderSynchronisation->computeFence);
 
 	if (vkQueueSubmit(queues.computeQueue, 1, &computeSubmitInfo, renderSynchronisation->computeFence) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to submit compute command buffer");
 	}
 
+	computeWrapper->computeSubmitted = true;
+	computeWrapper->computeFinishedSemaphorePending = passFinished;
+
+	if (!progressive) {
+		finishComputeSubmission();
+	}
+}
+
+void VulkanWrapper::finishComputeSubmission() {
+	if (!computeWrapper->computeSubmitted) {
+		return;
+	}
+
 	vkWaitForFences(device, 1, &renderSynchronisation->computeFence, VK_TRUE, UINT64_MAX);
-	computeWrapper->storeAndResetWriteBackData();
+	computeWrapper->finishSubmission();
 }
 
 void VulkanWrapper::waitForDeviceIdle() {
@@ -316,14 +455,29 @@ void VulkanWrapper::framebufferResizeCallback(GLFWwindow *window, int width, int
 
 }
 
-void VulkanWrapper::loadComputeBoxes(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights) {
-	if (computeWrapper->boxesGenerated) {
-		vkDestroyBuffer(device, computeWrapper->boxDataBuffer, nullptr);
-		vkFreeMemory(device, computeWrapper->boxDataBufferMemory, nullptr);
+void VulkanWrapper::loadComputeBoxes(BoxPool &boxPool, bool const boxPoolGrown, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights, VoxelGrid const &voxelGrid, bool const sceneChanged) {
+	if (!sceneChanged && computeWrapper->allocated) {
+		return;
 	}
 
-	computeWrapper->createDataBuffers(boxData, emissiveBoxData, pointLights);
-	descriptorWrapper->createComputeDescriptorSets(computeWrapper->cameraDataBuffers, computeWrapper->computeTextureImageView, computeWrapper->computeTextureSampler, *textureArray, *skyBox, computeWrapper->boxDataBuffer, boxData, computeWrapper->emissiveBoxDataBuffer, emissiveBoxData, computeWrapper->pointLightBuffer, pointLights, computeWrapper->writeBackDataBuffer, computeWrapper->allocated);
+	//The buffers below are patched or replaced, so a pass left running when the photo mode was closed has to finish first
+	finishComputeSubmission();
+	computeWrapper->nextTile = 0;
+
+	bool buffersRecreated = false;
+
+	if (sceneChanged) {
+		computeWrapper->uploadBoxPool(boxPool, boxPoolGrown, *uploadQueue);
+		bool voxelGridRecreated = computeWrapper->uploadVoxelGrid(voxelGrid, *uploadQueue);
+		buffersRecreated = computeWrapper->updateDataBuffers(emissiveBoxData, pointLights) || voxelGridRecreated || boxPoolGrown;
+	}
+
+	//Patched buffers keep their handles, so the sets written the last time still point at them
+	if (!buffersRecreated && computeWrapper->allocated) {
+		return;
+	}
+
+	descriptorWrapper->createComputeDescriptorSets(computeWrapper->cameraDataBuffers, computeWrapper->computeTextureImageView, computeWrapper->computeTextureSampler, *textureArray, *skyBox, computeWrapper->boxDataBuffer, boxPool.getBoxes(), computeWrapper->emissiveBoxDataBuffer, computeWrapper->emissiveBoxData, computeWrapper->pointLightBuffer, computeWrapper->pointLights, computeWrapper->writeBackDataBuffer, computeWrapper->bvhNodeBuffer, computeWrapper->bvhNodeCount, computeWrapper->voxelBuffer, computeWrapper->voxelBufferSize, computeWrapper->brickBuffer, computeWrapper->brickBufferSize, computeWrapper->accumulationBuffer, computeWrapper->accumulationBufferSize, computeWrapper->tileBuffer, computeWrapper->tileBufferSize, computeWrapper->wavefrontPathBuffer, computeWrapper->wavefrontPathBufferSize, computeWrapper->wavefrontQueueBuffer, computeWrapper->wavefrontQueueBufferSize, computeWrapper->lightGridBuffer, computeWrapper->lightGridBufferSize, computeWrapper->gBufferBuffer, computeWrapper->gBufferBufferSize, computeWrapper->denoiseBuffer, computeWrapper->denoiseBufferSize, computeWrapper->allocated);
 }
 
 void VulkanWrapper::createInstance() {
@@ -434,7 +588,37 @@ void VulkanWrapper::createCommandWrapper() {
 }
 
 void VulkanWrapper::createBufferCreator() {
-	bufferCreator = BufferCreator(physicalDevice, device, queueFamilyIndices, *commandWrapper);
+	memoryAllocator = new MemoryAllocator(physicalDevice, device);
+	bufferCreator = BufferCreator(physicalDevice, device, queueFamilyIndices, *commandWrapper, *memoryAllocator);
+
+	//Same check as in DeviceFinder::createDevice, which only enables the feature if it is supported
+	VkPhysicalDeviceFeatures physicalDeviceFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
+
+	uploadQueue = new UploadQueue(device, queueFamilyIndices, queues, bufferCreator);
+
+	createQuadIndexBuffer();
+
+	//The culled draws carry the chunk origin in firstInstance, without drawIndirectFirstInstance the sections are culled on the CPU
+	bool gpuSectionCulling = Settings::GPU_SECTION_CULLING && Settings::DRAW_CHUNKS_INDIRECT && physicalDeviceFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+	chunkArena = new ChunkArena(bufferCreator, *uploadQueue, quadIndexBuffer, physicalDeviceFeatures.multiDrawIndirect == VK_TRUE, physicalDeviceFeatures.drawIndirectFirstInstance == VK_TRUE, gpuSectionCulling);
+}
+
+void VulkanWrapper::createQuadIndexBuffer() {
+	std::vector<uint16_t> quadIndices(Settings::QUAD_INDEX_BUFFER_QUAD_COUNT * 6);
+
+	for (uint32_t i = 0; i < Settings::QUAD_INDEX_BUFFER_QUAD_COUNT; i++) {
+		for (int j = 0; j < 6; j++) {
+			quadIndices[i * 6 + j] = static_cast<uint16_t>(i * 4 + Quad::INDICES[j]);
+		}
+	}
+
+	VkDeviceSize bufferSize = sizeof(quadIndices[0]) * quadIndices.size();
+	bufferCreator.createDestinationBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, quadIndexBuffer, quadIndexBufferAllocation);
+
+	//Batches complete in order, so the buffer is filled before any chunk upload reports ready
+	uploadQueue->upload(quadIndices.data(), bufferSize, quadIndexBuffer, 0, nullptr);
 }
 
 void VulkanWrapper::createImageCreator() {
@@ -453,14 +637,22 @@ void VulkanWrapper::createRenderPass() {
 
 void VulkanWrapper::createDescriptorWrapper() {
 	descriptorWrapper = new DescriptorWrapper(device, swapchainWrapper->swapchainImages.size());
+
+	//The new sets get the buffers of the chunk arena with the next culling pass of their image
+	descriptorWrapper->createCullDescriptorSets();
+	cullDescriptorSetsWritten.assign(swapchainWrapper->swapchainImages.size(), false);
 }
 
 void VulkanWrapper::createPipeline() {
-	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->descriptorSetLayout, renderPass, Settings::VERTEX_SHADER_PATH, Settings::FRAGMENT_SHADER_PATH, false, false, pipelineLayout, pipeline);
+	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->descriptorSetLayout, renderPass, Settings::VERTEX_SHADER_PATH, Settings::FRAGMENT_SHADER_PATH, false, VertexType::CHUNK_VERTEX, pipelineLayout, pipeline);
 	
-	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->objDescriptorSetLayout, renderPass, Settings::OBJ_VERTEX_SHADER_PATH, Settings::OBJ_FRAGMENT_SHADER_PATH, false, true, objPipelineLayout, objPipeline);
+	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->objDescriptorSetLayout, renderPass, Settings::OBJ_VERTEX_SHADER_PATH, Settings::OBJ_FRAGMENT_SHADER_PATH, false, VertexType::BIG_VERTEX, objPipelineLayout, objPipeline);
 
-	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->skyDescriptorSetLayout, renderPass, Settings::SKY_VERTEX_SHADER_PATH, Settings::SKY_FRAGMENT_SHADER_PATH, false, false, skyPipelineLayout, skyPipeline);
+	PipelineCreator::createPipeLine(device, swapchainWrapper->extent, descriptorWrapper->skyDescriptorSetLayout, renderPass, Settings::SKY_VERTEX_SHADER_PATH, Settings::SKY_FRAGMENT_SHADER_PATH, false, VertexType::VERTEX, skyPipelineLayout, skyPipeline);
+
+	if (chunkArena->isCullingOnGpu()) {
+		PipelineCreator::createComputePipeLine(device, descriptorWrapper->cullDescriptorSetLayout, Settings::CULL_COMPUTE_SHADER_PATH, sizeof(SectionCullData), cullPipelineLayout, cullPipeline);
+	}
 }
 
 void VulkanWrapper::createRenderSynchronisation() {
@@ -493,10 +685,55 @@ void VulkanWrapper::updateSkyUniformBufferObject(uint32_t const imageIndex) {
 	vkUnmapMemory(device, skyWrapper->skyUniformBufferObjectsMemory[imageIndex]);
 }
 
+void VulkanWrapper::recordSectionCulling(uint32_t const imageIndex, glm::mat4 const &view, glm::mat4 const &projection) {
+	if (Settings::UPDATE_FRUSTUM) {
+		//Rows of the view projection matrix give the clip planes, a point is inside if it is on the positive side of all six
+		glm::mat4 viewProjection = projection * view;
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++) {
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		}
+
+		sectionCullData.planes[0] = rows[3] + rows[0];
+		sectionCullData.planes[1] = rows[3] - rows[0];
+		sectionCullData.planes[2] = rows[3] + rows[1];
+		sectionCullData.planes[3] = rows[3] - rows[1];
+		//-w <= z also holds for a zero to one depth range, the near plane is only a bit looser then
+		sectionCullData.planes[4] = rows[3] + rows[2];
+		sectionCullData.planes[5] = rows[3] - rows[2];
+	}
+
+	//Latched for the whole frame, the visibility bits are only filled if the flag was set here
+	occlusionCulling = Settings::OCCLUSION_CULLING;
+	sectionCullData.occlusionCulling = occlusionCulling ? 1 : 0;
+
+	VkBuffer sectionBuffer;
+	VkBuffer drawBuffer;
+	VkBuffer visibilityBuffer;
+	bool recreated = chunkArena->prepareCulling(imageIndex, occlusionCulling, sectionBuffer, drawBuffer, visibilityBuffer, sectionCullData.sectionCount);
+
+	if (sectionCullData.sectionCount == 0) {
+		return;
+	}
+
+	if (recreated || !cullDescriptorSetsWritten[imageIndex]) {
+		descriptorWrapper->updateCullDescriptorSet(imageIndex, sectionBuffer, drawBuffer, visibilityBuffer);
+		cullDescriptorSetsWritten[imageIndex] = true;
+	}
+
+	commandWrapper->recordSectionCulling(imageIndex, cullPipeline, cullPipelineLayout, descriptorWrapper->cullDescriptorSets[imageIndex], sectionCullData);
+}
+
 void VulkanWrapper::cleanUpSwapchain() {
 
 	vkDestroyPipeline(device, pipeline, nullptr);
 
+	//Null handles are ignored if the sections are culled on the CPU
+	vkDestroyPipeline(device, cullPipeline, nullptr);
+	vkDestroyPipelineLayout(device, cullPipelineLayout, nullptr);
+	cullPipeline = VK_NULL_HANDLE;
+	cullPipelineLayout = VK_NULL_HANDLE;
+
 	commandWrapper->freeCommandBuffers();
 
 	vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
@@ -529,6 +766,9 @@ void VulkanWrapper::recreateSwapchain() {
 	descriptorWrapper->createSkyDescriptorSets(swapchainWrapper->uniformBufferObjects, skyWrapper->skyUniformBufferObjects, *skyWrapper->cloudTexture);
 	commandWrapper->createCommandBuffers(swapchainWrapper->swapchainImages.size());
 	createPipeline();
+
+	//The compute sets went with the old descriptor pool, the next photo mode allocates and writes them again
+	computeWrapper->allocated = false;
 }
 
 void VulkanWrapper::printAllAvailableInstanceExtensions() {
@@ -545,7 +785,19 @@ void VulkanWrapper::printAllAvailableInstanceExtensions() {
 }
 
 void VulkanWrapper::createComputeWrapper(char const *computeShaderPath) {
-	computeWrapper = new ComputeWrapper(device, imageCreator, bufferCreator, swapchainWrapper->extent, swapchainWrapper->swapchainImages.size(), descriptorWrapper->quadDescriptorSetLayout, renderPass, descriptorWrapper->computeDescriptorSetLayout, computeShaderPath);
+	//The photo mode fits its tiles per frame to the time the last ones took on the GPU
+	VkPhysicalDeviceProperties physicalDeviceProperties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+
+	bool hasTimestamps = queueFamilyProperties[queueFamilyIndices.computeFamilyIndex].timestampValidBits > 0;
+
+	computeWrapper = new ComputeWrapper(device, imageCreator, bufferCreator, swapchainWrapper->extent, swapchainWrapper->swapchainImages.size(), descriptorWrapper->quadDescriptorSetLayout, renderPass, descriptorWrapper->computeDescriptorSetLayout, computeShaderPath, hasTimestamps ? physicalDeviceProperties.limits.timestampPeriod : 0.0f);
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanWrapper::debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT *pCallBackData, void *pUserData) {
@@ -16,6 +16,10 @@
 #include "Queues.h"
 #include "CommandWrapper.h"
 #include "BufferCreator.h"
+#include "ChunkArena.h"
+#include "SectionCullData.h"
+#include "UploadQueue.h"
+#include "Quad.h"
 #include "ImageCreator.h"
 #include "SwapchainWrapper.h"
 #include "DescriptorWrapper.h"
@@ -30,6 +34,7 @@
 #include "glm/glm.hpp"
 
 #include <vector>
+#include <functional>
 
  /**
   * @brief Handles all Vulkan related things and has the ability to render a frame with the render function.
@@ -58,27 +63,40 @@ public:
 	 * @param vertices Vertices of the chunk.
 	 * @param indices Indices of the chunk.
 	 * @param vertexBuffer Handle in which the generated vertex buffer will be stored.
-	 * @param vertexBufferMemory Handle in which the generated vertex buffer memory will be stored.
+	 * @param vertexBufferAllocation Range of the memory allocator in which the generated vertex buffer will be stored.
 	 * @param indexBuffer Handle in which the generated index buffer will be stored.
-	 * @param indexBufferMemory Hanlde in which the generated index buffer memory will be stored.
+	 * @param indexBufferAllocation Range of the memory allocator in which the generated index buffer will be stored.
 	 */
-	void createVulkanLoadedChunk(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory);
+	void createVulkanLoadedChunk(std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation);
 
-	void createVulkanObjChunk(std::vector<BigVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory);
+	//Uploads asynchronously, onComplete is called from the upload thread once the buffers can be used
+	void createVulkanObjChunk(std::vector<BigVertex> &vertices, std::vector<uint32_t> &indices, VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation, std::function<void()> onComplete);
 
 	/**
 	 * @brief Calls the vulkan destroy functions for the vulkan objects of a chunk.
 	 *
 	 * @param vertexBuffer The vertex buffer, which should be destroyed.
-	 * @param vertexBufferMemory The vertex buffer memory, which should be freed.
+	 * @param vertexBufferAllocation The vertex buffer memory range, which should be given back to the memory allocator.
 	 * @param indexBuffer The index buffer, which should be destroyed.
-	 * @param indexBufferMemory The index buffer memory, which should be freed.
+	 * @param indexBufferAllocation The index buffer memory range, which should be given back to the memory allocator.
 	 */
-	void deleteVulkanLoadedChunk(VkBuffer &vertexBuffer, VkDeviceMemory &vertexBufferMemory, VkBuffer &indexBuffer, VkDeviceMemory &indexBufferMemory);
+	void deleteVulkanLoadedChunk(VkBuffer &vertexBuffer, MemoryAllocation &vertexBufferAllocation, VkBuffer &indexBuffer, MemoryAllocation &indexBufferAllocation);
+
+	//chunkOrigin and the section bounds are only used if the sections are culled on the GPU, see isSectionCullingOnGpu
+	void createArenaLoadedChunk(std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices, uint32_t const chunkOrigin, glm::vec3 const &minBound, glm::vec3 const &maxBound, ArenaAllocation &arenaAllocation, std::function<void()> onComplete);
+
+	void deleteArenaLoadedChunk(ArenaAllocation &arenaAllocation);
+
+	/**
+	 * @brief Prints block count, usage and fragmentation of the memory allocator.
+	 */
+	void printMemoryStats();
 
 	/**
 	 * @brief Tries to acquire an image and sets up everything to record render commands.
 	 *
+	 * Also records the GPU section culling, which uses the frustum of the view and projection.
+	 *
 	 * @param view View transformation matrix.
 	 * @param projection Projection transformation matrix.
 	 * @param imageIndex Variable in which the index of the acquired image will be stored.
@@ -87,23 +105,76 @@ public:
 	 */
 	bool startRenderRecording(glm::mat4 const &view, glm::mat4 const &projection, uint32_t &imageIndex);
 
+	/**
+	 * @brief Starts recording one secondary command buffer of the acquired image and binds the chunk pipeline, can be called from any thread once per slot.
+	 *
+	 * @param imageIndex Index of the acquired image.
+	 * @param slot Slot of the secondary command buffer, smaller than getRecordingSlotCount.
+	 * @return VkCommandBuffer The command buffer for the add and change calls below.
+	 */
+	VkCommandBuffer startSecondaryRecording(uint32_t const imageIndex, size_t const slot);
+
+	void endSecondaryRecording(VkCommandBuffer const &commandBuffer);
+
+	//Settings::CHUNK_RECORDING_SLICES chunk slices and a last slot for the indirect chunk draws and the sky
+	size_t getRecordingSlotCount() const;
+
 	/**
 	 * @brief Adds the data of a given chunk to be rendered.
 	 *
-	 * @param imageIndex Index of the image into which the chunk should be rendered.
+	 * @param commandBuffer Secondary command buffer the chunk is recorded into.
 	 * @param vertexBuffer Vertex buffer containing the vertices of the chunk.
 	 * @param indexBuffer Index buffer containing the indices of the chunk.
 	 * @param indexCount Count of the indices.
+	 * @param chunkOrigin Chunk position packed with ChunkVertex::packChunkOrigin.
 	 */
-	void addChunkToRender(uint32_t const imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount);
+	void addChunkToRender(VkCommandBuffer const &commandBuffer, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount, uint32_t const chunkOrigin);
 
-	void changeToObjPipeline(uint32_t const imageIndex);
+	/**
+	 * @brief Adds the chunk to the indirect draws of this frame, nothing is recorded until drawIndirectChunks.
+	 *
+	 * Only called from the render thread.
+	 *
+	 * @param arenaAllocation Location of the chunk mesh inside the chunk arena.
+	 * @param chunkOrigin Chunk position packed with ChunkVertex::packChunkOrigin.
+	 */
+	void addChunkToIndirectDraw(ArenaAllocation const &arenaAllocation, uint32_t const chunkOrigin);
 
-	void addObjChunkToRender(uint32_t const imageIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount);
+	/**
+	 * @brief If the chunk arena sections are culled by shaders/cull.comp, addChunkToIndirectDraw must not be called then.
+	 *
+	 * @return true If Settings::GPU_SECTION_CULLING is set and the device supports drawIndirectFirstInstance.
+	 */
+	bool isSectionCullingOnGpu() const;
+
+	/**
+	 * @brief If the sections of this frame go through the occlusion culling, the value of Settings::OCCLUSION_CULLING when the culling pass was recorded.
+	 */
+	bool isOcclusionCullingOn() const;
+
+	/**
+	 * @brief Lets the GPU section culling draw the chunk this frame, only needed while isOcclusionCullingOn.
+	 *
+	 * @param imageIndex Index of the acquired image.
+	 * @param arenaAllocation Location of the chunk mesh inside the chunk arena.
+	 */
+	void markSectionVisible(uint32_t const imageIndex, ArenaAllocation const &arenaAllocation);
+
+	/**
+	 * @brief Records the indirect draws of all chunks added since the last call, one draw call per chunk arena page.
+	 *
+	 * @param commandBuffer Secondary command buffer the draws are recorded into.
+	 * @param imageIndex Index of the image into which the chunks should be rendered.
+	 */
+	void drawIndirectChunks(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex);
+
+	void changeToObjPipeline(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex);
 
-	void changeToSkyPipeline(uint32_t const imageIndex);
+	void addObjChunkToRender(VkCommandBuffer const &commandBuffer, VkBuffer vertexBuffer, VkBuffer indexBuffer, uint32_t const indexCount);
 
-	void addSkyToRender(uint32_t const imageIndex);
+	void changeToSkyPipeline(VkCommandBuffer const &commandBuffer, uint32_t const imageIndex);
+
+	void addSkyToRender(VkCommandBuffer const &commandBuffer);
 
 	/**
 	 * @brief Enqueues the rendering of given image index.
@@ -112,7 +183,8 @@ public:
 	 */
 	void SubmitRender(uint32_t const imageIndex);
 
-	void renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::vec4 const &iData);
+	//Progressive rendering traces as many tiles as fit in the frame budget and does not wait for them, see ComputeSettings::PHOTO_MODE_PROGRESSIVE
+	void renderPhotomode(glm::vec3 const &cameraPosition, glm::vec3 const &cameraDirection, glm::vec3 const &up, glm::vec4 const &iData, bool const progressive);
 
 	/**
 	 * @brief Waits until the vulkan device is idle.
@@ -128,9 +200,13 @@ public:
 	 */
 	static void framebufferResizeCallback(GLFWwindow *window, int width, int height);
 
-	void loadComputeBoxes(std::vector<BoxData> const &boxData, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights);
+	//An empty voxel grid leaves the path tracer on the BVH of the box pool, boxPoolGrown is the result of BoxPool::update
+	//Without sceneChanged the scene arguments are not read, only descriptor sets lost with the swapchain are written again
+	void loadComputeBoxes(BoxPool &boxPool, bool const boxPoolGrown, std::vector<BoxData> const &emissiveBoxData, std::vector<PointLight> const &pointLights, VoxelGrid const &voxelGrid, bool const sceneChanged);
 
 private:
+	//Waits for the tiles submitted last and stores their results
+	void finishComputeSubmission();
 
 	/**
 	 * @brief Handle for the GLFWwindow object, used for surface creation.
@@ -172,11 +248,32 @@ private:
 	*/
 	CommandWrapper *commandWrapper;
 
+	/**
+	* @brief Sub-allocates the memory of the chunk buffers out of large memory blocks.
+	*/
+	MemoryAllocator *memoryAllocator;
+
 	/**
 	* @brief Bundles all vulkan buffer creation.
 	*/
 	BufferCreator bufferCreator;
 
+	/**
+	* @brief Batches the staging copies of the chunk uploads on the transfer queue.
+	*/
+	UploadQueue *uploadQueue;
+
+	/**
+	* @brief Index pattern of Settings::QUAD_INDEX_BUFFER_QUAD_COUNT quads as uint16, shared by all chunk meshes if Settings::SHARED_QUAD_INDICES is set.
+	*/
+	VkBuffer quadIndexBuffer = VK_NULL_HANDLE;
+	MemoryAllocation quadIndexBufferAllocation;
+
+	/**
+	* @brief Shared vertex and index buffers of all chunk meshes, used if Settings::DRAW_CHUNKS_INDIRECT is set.
+	*/
+	ChunkArena *chunkArena;
+
 	/**
 	* @brief Bundles all vulkan image creation.
 	*/
@@ -213,6 +310,27 @@ private:
 	VkPipeline skyPipeline;
 	VkPipelineLayout skyPipelineLayout;
 
+	/**
+	* @brief Compute pipeline of the GPU section culling, only created if the chunk arena culls on the GPU.
+	*/
+	VkPipeline cullPipeline = VK_NULL_HANDLE;
+	VkPipelineLayout cullPipelineLayout = VK_NULL_HANDLE;
+
+	/**
+	* @brief Frustum planes pushed to the culling pass, kept while Settings::UPDATE_FRUSTUM is off.
+	*/
+	SectionCullData sectionCullData{};
+
+	/**
+	* @brief Settings::OCCLUSION_CULLING at the time the culling pass of the current frame was recorded.
+	*/
+	bool occlusionCulling = false;
+
+	/**
+	* @brief If the cull descriptor set of an image points to the current buffers of the chunk arena.
+	*/
+	std::vector<bool> cullDescriptorSetsWritten;
+
 	/**
 	* @brief Current frame, needed to get the right semaphore pairs from the synchronisation object.
 	*/
@@ -265,6 +383,11 @@ private:
 	*/
 	void createBufferCreator();
 
+	/**
+	* @brief Creates and uploads the shared quad index buffer of the chunk meshes.
+	*/
+	void createQuadIndexBuffer();
+
 	/**
 	* @brief Creates the image creator.
 	*/
@@ -307,6 +430,15 @@ private:
 
 	void updateSkyUniformBufferObject(uint32_t const imageIndex);
 
+	/**
+	 * @brief Records the GPU section culling into the command buffer of the image, before its render pass.
+	 *
+	 * @param imageIndex Index of the acquired image.
+	 * @param view View transformation matrix.
+	 * @param projection Projection transformation matrix.
+	 */
+	void recordSectionCulling(uint32_t const imageIndex, glm::mat4 const &view, glm::mat4 const &projection);
+
 	/**
 	 * @brief Destroys the used SwapchainWrapper and cleansUp all things depending on the swapchain attributes.
 	 *
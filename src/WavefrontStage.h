@@ -0,0 +1,18 @@
+#ifndef WAVEFRONTSTAGE_H
+#define WAVEFRONTSTAGE_H
+
+//Kernels of the wavefront path tracer, the values are the WAVEFRONT_STAGE specialization constant of shaders/compute.comp
+//The megakernel runs the whole integrator per pixel, the other stages communicate through the ray queues
+enum WavefrontStage {
+	MEGAKERNEL,
+	GENERATE,
+	EXTEND,
+	SHADE_SKY,
+	SHADE_REFRACTIVE,
+	SHADE_LAMBERTIAN,
+	SHADOW,
+	ACCUMULATE,
+	WAVEFRONT_STAGE_COUNT
+};
+
+#endif // !WAVEFRONTSTAGE_H
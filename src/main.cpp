@@ -11,17 +11,46 @@
 
 #include "Application.h"
 #include "ThreadPool.h"
+#include "Benchmark.h"
 
 #include <iostream>
 
 /**
  * @brief main function which creates and starts an Application, any exceptions are caught here.
+ * Started with "--benchmark <name>" it runs the headless benchmark instead, "--reference" renders the CPU reference image and checks the denoiser against it without a window.
  * 
+ * @param argc the number of command line arguments
+ * @param argv the command line arguments
  * @return int the exit status of the program
  */
-int main() {
+int main(int argc, char **argv) {
 	ThreadPool::getInstance().start();
 
+	if (argc > 2 && std::string(argv[1]) == "--benchmark") {
+		bool found = Benchmark::run(argv[2]);
+
+		ThreadPool::getInstance().stop();
+
+		return found ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--reference") {
+		try {
+			Benchmark::reference();
+		}
+		catch (const std::exception &exception) {
+			std::cerr << exception.what() << std::endl;
+
+			ThreadPool::getInstance().stop();
+
+			return EXIT_FAILURE;
+		}
+
+		ThreadPool::getInstance().stop();
+
+		return EXIT_SUCCESS;
+	}
+
 	Application application;
 
 	try {